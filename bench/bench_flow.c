@@ -0,0 +1,54 @@
+#include "bench_utils.h"
+#include "../src/game/flow.h"
+#include "../src/game/path.h"
+#include "../src/game/enemy.h"
+
+#define FLOW_TURNS 200
+
+static volatile long sink; // keeps the work from being optimised away
+
+// A turn of chasing for `enemies` enemies scattered over the level: one
+// path per enemy, or one flow field shared by all of them
+static void time_chase(const Map *m, int enemies, Rng *rng) {
+    static FlowField f;
+    int ex[MAX_ENEMIES], ey[MAX_ENEMIES];
+    for (int i = 0; i < enemies; i++) {
+        const Room *r = &m->rooms[rng_below(rng, m->room_count)];
+        ex[i] = r->x + rng_below(rng, r->w);
+        ey[i] = r->y + rng_below(rng, r->h);
+    }
+
+    double t0 = bench_now_ms();
+    for (int t = 0; t < FLOW_TURNS; t++) {
+        const Room *r = &m->rooms[t % m->room_count];
+        int px = r->x + t % r->w, py = r->y;
+        for (int i = 0; i < enemies; i++) {
+            int nx, ny;
+            sink += path_next_step(m, ex[i], ey[i], px, py, &nx, &ny);
+        }
+    }
+    double t1 = bench_now_ms();
+    flow_init(&f);
+    for (int t = 0; t < FLOW_TURNS; t++) {
+        const Room *r = &m->rooms[t % m->room_count];
+        flow_update(&f, m, r->x + t % r->w, r->y);
+        for (int i = 0; i < enemies; i++)
+            sink += flow_dist(&f, ex[i], ey[i]);
+    }
+    double t2 = bench_now_ms();
+    printf("%8d %12.2f %12.2f\n", enemies,
+           1000.0 * (t1 - t0) / FLOW_TURNS, 1000.0 * (t2 - t1) / FLOW_TURNS);
+}
+
+void bench_flow(void) {
+    static Map m;
+    Rng rng;
+    rng_seed(&rng, 1);
+    map_generate_layout(&m, BSP_FIRST_LEVEL, LAYOUT_BSP, &rng);
+
+    BENCH_HEADER("Chasing the player, per turn");
+    printf("%8s %12s %12s\n", "enemies", "paths us", "field us");
+    static const int counts[] = { 1, 4, 8, MAX_ENEMIES };
+    for (int i = 0; i < 4; i++)
+        time_chase(&m, counts[i], &rng);
+}
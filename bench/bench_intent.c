@@ -0,0 +1,84 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench_utils.h"
+#include <stdint.h>
+#include "../src/game/intent.h"
+
+#define INTENT_HORDE_MAX 4096
+#define INTENT_WORK      (1 << 20) // plans made per row, whatever the horde size
+
+// Wall time, since the point is how much sooner the threads finish
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// FNV-1a over the plans, to show every thread count planned the same
+static uint64_t checksum(const EnemyIntent *plans, int n) {
+    uint64_t h = 1469598103934665603ULL;
+    for (int i = 0; i < n; i++) {
+        int v[3] = { plans[i].kind, plans[i].x, plans[i].y };
+        for (int k = 0; k < 3; k++) {
+            h ^= (uint64_t)(unsigned)v[k];
+            h *= 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+// One planning pass over a horde of `count`, repeated, at each thread
+// count up to the machine's
+static void time_horde(const GameState *g, const int *xs, const int *ys,
+                       const int *ids, int count) {
+    static EnemyIntent plans[INTENT_HORDE_MAX];
+    int reps = INTENT_WORK / count;
+    int cpus = pool_cpu_count();
+    double base = 0;
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > cpus) threads = cpus;
+        ThreadPool pool;
+        int got = pool_init(&pool, threads);
+        double t0 = now_s();
+        for (int r = 0; r < reps; r++)
+            intent_plan(g, xs, ys, ids, count, plans, &pool);
+        double us = 1e6 * (now_s() - t0) / reps;
+        pool_free(&pool);
+
+        if (base == 0) base = us;
+        printf("%8d %8d %12.1f %7.2fx  %016llx\n", count, got, us, base / us,
+               (unsigned long long)checksum(plans, count));
+        if (threads >= cpus) break;
+    }
+}
+
+void bench_intent(void) {
+    static GameState g;
+    static int xs[INTENT_HORDE_MAX], ys[INTENT_HORDE_MAX];
+    static int ids[INTENT_HORDE_MAX];
+    Rng rng;
+    rng_seed(&rng, 1);
+    game_init(&g);
+    map_generate_layout(&g.map, BSP_FIRST_LEVEL, LAYOUT_BSP, &rng);
+    const Room *home = &g.map.rooms[0];
+    g.player.x = home->x + home->w / 2;
+    g.player.y = home->y + home->h / 2;
+    g.enemies.count = 0;
+    game_refresh_regions(&g);
+    game_refresh_occupancy(&g);
+    flow_update(&g.flow, &g.map, g.player.x, g.player.y);
+    senses_update(&g.senses, &g.regions, &g.open, g.player.x, g.player.y);
+
+    for (int i = 0; i < INTENT_HORDE_MAX; i++) {
+        const Room *r = &g.map.rooms[rng_below(&rng, g.map.room_count)];
+        xs[i]  = r->x + rng_below(&rng, r->w);
+        ys[i]  = r->y + rng_below(&rng, r->h);
+        ids[i] = i;
+    }
+
+    BENCH_HEADER("Planning a horde's moves, per wave");
+    printf("%8s %8s %12s %8s %18s\n", "enemies", "threads", "us", "speedup", "checksum");
+    for (int count = 64; count <= INTENT_HORDE_MAX; count *= 4)
+        time_horde(&g, xs, ys, ids, count);
+    game_free(&g);
+}
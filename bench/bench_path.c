@@ -0,0 +1,53 @@
+#include "bench_utils.h"
+#include "../src/game/path.h"
+
+#define PATH_LEVELS  20
+#define PATH_QUERIES 50
+
+// Stairs-to-stairs plus random room-to-room queries on generated levels
+static void time_queries(const char *name, MapLayout layout) {
+    static Map  m;
+    static Path p;
+    Rng rng;
+    rng_seed(&rng, 1);
+
+    double room_ms = 0, flat_ms = 0;
+    long room_steps = 0, flat_steps = 0;
+    int queries = 0;
+    int q[PATH_QUERIES][4];
+    for (int level = 0; level < PATH_LEVELS; level++) {
+        map_generate_layout(&m, BSP_FIRST_LEVEL, layout, &rng);
+        q[0][0] = m.stairs_up_x;   q[0][1] = m.stairs_up_y;
+        q[0][2] = m.stairs_down_x; q[0][3] = m.stairs_down_y;
+        for (int i = 1; i < PATH_QUERIES; i++) {
+            const Room *a = &m.rooms[rng_below(&rng, m.room_count)];
+            const Room *b = &m.rooms[rng_below(&rng, m.room_count)];
+            q[i][0] = a->x + rng_below(&rng, a->w);
+            q[i][1] = a->y + rng_below(&rng, a->h);
+            q[i][2] = b->x + rng_below(&rng, b->w);
+            q[i][3] = b->y + rng_below(&rng, b->h);
+        }
+
+        double t0 = bench_now_ms();
+        for (int i = 0; i < PATH_QUERIES; i++)
+            room_steps += path_find(&m, q[i][0], q[i][1], q[i][2], q[i][3], &p);
+        double t1 = bench_now_ms();
+        for (int i = 0; i < PATH_QUERIES; i++)
+            flat_steps += path_find_flat(&m, q[i][0], q[i][1], q[i][2], q[i][3], &p);
+        double t2 = bench_now_ms();
+        room_ms += t1 - t0;
+        flat_ms += t2 - t1;
+        queries += PATH_QUERIES;
+    }
+    printf("%-10s %8d %12.2f %12.2f %12.3f\n", name, queries,
+           1000.0 * room_ms / queries, 1000.0 * flat_ms / queries,
+           (double)room_steps / flat_steps);
+}
+
+void bench_path(void) {
+    BENCH_HEADER("Pathfinding");
+    printf("%-10s %8s %12s %12s %12s\n",
+           "layout", "queries", "rooms us", "flat us", "length ratio");
+    time_queries("scatter", LAYOUT_SCATTER);
+    time_queries("bsp", LAYOUT_BSP);
+}
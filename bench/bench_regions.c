@@ -0,0 +1,38 @@
+#include "bench_utils.h"
+#include "../src/game/regions.h"
+#include "../src/game/cave.h"
+
+#define REGION_RUNS 2000
+
+static void time_labeling(const char *name, const Map *m) {
+    static Regions r;
+    double t0 = bench_now_ms();
+    for (int i = 0; i < REGION_RUNS; i++)
+        regions_build(&r, m);
+    double ms = (bench_now_ms() - t0) / REGION_RUNS;
+    double tiles = (double)m->w * m->h;
+    printf("%-10s %5dx%-4d %8d %10.4f %14.0f\n",
+           name, m->w, m->h, r.count, ms, tiles / ms);
+}
+
+void bench_regions(void) {
+    static Map m;
+    Rng rng;
+    rng_seed(&rng, 1);
+
+    BENCH_HEADER("Region labeling");
+    printf("%-10s %10s %8s %10s %14s\n", "level", "size", "regions", "ms", "tiles/ms");
+
+    map_generate_layout(&m, 1, LAYOUT_SCATTER, &rng);
+    time_labeling("scatter", &m);
+    map_generate_layout(&m, BSP_FIRST_LEVEL, LAYOUT_BSP, &rng);
+    time_labeling("bsp", &m);
+    cave_generate(&m, 1, &rng);
+    time_labeling("cave", &m);
+
+    // Worst case for run counts: a checkerboard of isolated tiles
+    for (int y = 0; y < MAP_H; y++)
+        for (int x = 0; x < MAP_W; x++)
+            m.tiles[y][x] = (x + y) % 2 ? TILE_WALL : TILE_FLOOR;
+    time_labeling("checker", &m);
+}
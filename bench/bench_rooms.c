@@ -0,0 +1,56 @@
+#include "bench_utils.h"
+#include "../src/game/rooms.h"
+#include <stdlib.h>
+
+// Areas grow with the room count so density matches a scattered level
+// today (MAX_ROOMS rooms on the 121 x 65 tiles they can reach)
+static const struct {
+    int rooms, area_w, area_h, runs;
+} cases[] = {
+    {   10,  121,  65, 2000 },
+    {  100,  383, 206,  100 },
+    { 1000, 1210, 650,    5 },
+};
+
+// Same budget per room as map_generate's 200 attempts for 10 rooms
+#define SCATTER_ATTEMPTS_PER_ROOM 20
+
+void bench_rooms(void) {
+    BENCH_HEADER("Room placement");
+    printf("%6s  %14s %12s  %14s %12s\n",
+           "rooms", "scatter yield", "scatter ms", "bsp full-size", "bsp ms");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        int n = cases[c].rooms;
+        Room     *rooms = malloc(sizeof(Room) * n);
+        RoomLink *links = malloc(sizeof(RoomLink) * n);
+        Rng rng;
+        rng_seed(&rng, 1);
+
+        long placed = 0;
+        int link_count;
+        double t0 = bench_now_ms();
+        for (int r = 0; r < cases[c].runs; r++)
+            placed += rooms_place_scatter(rooms, n, cases[c].area_w, cases[c].area_h,
+                                          n * SCATTER_ATTEMPTS_PER_ROOM,
+                                          links, &link_count, &rng);
+        double scatter_ms = (bench_now_ms() - t0) / cases[c].runs;
+
+        t0 = bench_now_ms();
+        for (int r = 0; r < cases[c].runs; r++)
+            rooms_place_bsp(rooms, n, cases[c].area_w, cases[c].area_h, links, &rng);
+        double bsp_ms = (bench_now_ms() - t0) / cases[c].runs;
+
+        // BSP always yields n rooms; report how many it had to shrink
+        int full = 0;
+        for (int i = 0; i < n; i++)
+            full += rooms[i].w >= MIN_ROOM_W && rooms[i].h >= MIN_ROOM_H;
+
+        printf("%6d  %13.1f%% %12.4f  %13.1f%% %12.4f\n", n,
+               100.0 * placed / ((double)n * cases[c].runs), scatter_ms,
+               100.0 * full / n, bsp_ms);
+
+        free(rooms);
+        free(links);
+    }
+}
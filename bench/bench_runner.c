@@ -0,0 +1,18 @@
+#include "bench_utils.h"
+
+void bench_rooms(void);
+void bench_regions(void);
+void bench_path(void);
+void bench_flow(void);
+void bench_intent(void);
+
+int main(void) {
+    printf("=== CONR Benchmarks ===\n");
+    bench_rooms();
+    bench_regions();
+    bench_path();
+    bench_flow();
+    bench_intent();
+    printf("\n");
+    return 0;
+}
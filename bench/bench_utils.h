@@ -0,0 +1,14 @@
+#ifndef BENCH_UTILS_HEADER_H
+#define BENCH_UTILS_HEADER_H
+
+#include <stdio.h>
+#include <time.h>
+
+// CPU time in milliseconds since an arbitrary start
+static inline double bench_now_ms(void) {
+    return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+#define BENCH_HEADER(title) printf("\n== %s ==\n", title)
+
+#endif
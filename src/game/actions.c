@@ -4,14 +4,13 @@
 #include <string.h>
 #include <stdio.h>
 #include "item.h"
+#include "intent.h"
 // sfx.h is excluded from the test runner because it links SDL2_mixer,
 // which is not available in the test build. TEST_BUILD is defined in CMakeLists.txt.
 #ifndef TEST_BUILD
 #include "../audio/sfx.h"
 #endif
 
-static int abs_int(int n) { return n < 0 ? -n : n; }
-
 static Action make_move_or_attack(int tx, int ty) {
     Action a;
     a.target_x = tx;
@@ -20,17 +19,12 @@ static Action make_move_or_attack(int tx, int ty) {
     return a;
 }
 
-void push_message(GameState *g, const char *msg) {
-    if (g->message_count < MAX_MESSAGES) {
-        strncpy(g->messages[g->message_count], msg, MAX_MESSAGE_LEN - 1);
-        g->messages[g->message_count][MAX_MESSAGE_LEN - 1] = '\0';
-        g->message_count++;
-    } else {
-        for (int i = 0; i < MAX_MESSAGES - 1; i++)
-            strncpy(g->messages[i], g->messages[i + 1], MAX_MESSAGE_LEN);
-        strncpy(g->messages[MAX_MESSAGES - 1], msg, MAX_MESSAGE_LEN - 1);
-        g->messages[MAX_MESSAGES - 1][MAX_MESSAGE_LEN - 1] = '\0';
-    }
+GameEvent *game_log(GameState *g, EventKind kind) {
+    return events_push(&g->events, kind, g->turn);
+}
+
+void game_note(GameState *g, NoteId note) {
+    game_log(g, EVENT_NOTE)->subject = (unsigned char)note;
 }
 
 static Item random_weapon(int level) {
@@ -52,64 +46,31 @@ static Item random_weapon(int level) {
     }
 }
 
-static int enemy_score(EnemyType type) {
-    switch (type) {
-        case ENEMY_SKELETON:    return 10;
-        case ENEMY_GOBLIN:      return 15;
-        case ENEMY_ZOMBIE:      return 20;
-        case ENEMY_ORC:         return 30;
-        case ENEMY_TROLL:       return 50;
-        case ENEMY_GIANT:       return 80;
-        case ENEMY_GOBLIN_KING: return 500;
-        case ENEMY_LICH_KING:   return 1000;
-        case ENEMY_DEMON_LORD:  return 2000;
-        case ENEMY_RED_DRAGON:  return 3500;
-        case ENEMY_TARRASQUE:   return 5000;
-        default:                return 0;
-    }
-}
+static void drop_loot(GameState *g, int i) {
+    const EnemyArchetype *kind = ENEMY_KIND(&g->enemies, i);
+    int ex = g->enemies.x[i], ey = g->enemies.y[i];
+    int gold = kind->gold_span ? kind->gold_min + rand() % kind->gold_span : 0;
 
-static void drop_loot(GameState *g, int x, int y, EnemyType type, int is_boss) {
-    // Gold dropstatic void drop_loot(GameState *g, int x, int y, EnemyType type) {
-    int gold = 0;
-    switch (type) {
-        case ENEMY_SKELETON: gold = 2 + rand() % 4;  break;
-        case ENEMY_GOBLIN:   gold = 3 + rand() % 5;  break;
-        case ENEMY_ZOMBIE:   gold = 4 + rand() % 6;  break;
-        case ENEMY_ORC:      gold = 6 + rand() % 8;  break;
-        case ENEMY_TROLL:    gold = 10 + rand() % 10; break;
-        case ENEMY_GIANT:    gold = 15 + rand() % 15; break;
-        case ENEMY_GOBLIN_KING: break;
-        case ENEMY_LICH_KING:  break;
-        case ENEMY_DEMON_LORD:  break;
-        case ENEMY_RED_DRAGON: break;
-        case ENEMY_TARRASQUE:  break;
-    }
-    
     // 50% chance to drop gold
-    if (is_boss || rand() % 100 < 20) {
+    if (kind->is_boss || rand() % 100 < 20) {
         g->gold += gold;
         g->score += gold;
-        char msg[MAX_MESSAGE_LEN];
-        snprintf(msg, sizeof(msg), "Found %d gold!", gold);
-        push_message(g, msg);
+        game_log(g, EVENT_GOLD)->a = gold;
     }
 
     // Boss guaranteed drop
-    if (is_boss) {
+    if (kind->is_boss) {
         if (g->floor_item_count < MAX_FLOOR_ITEMS) {
             Item boss_drop = rand() % 2 == 0
                 ? random_weapon(g->level)
                 : item_make_chain_mail();
             FloorItem fi = {0};
             fi.active = 1;
-            fi.x = x; fi.y = y;
+            fi.x = ex; fi.y = ey;
             fi.item = boss_drop;
-            g->map.tiles[y][x] = TILE_ITEM;
+            g->map.tiles[ey][ex] = TILE_ITEM;
             g->floor_items[g->floor_item_count++] = fi;
-            char msg[MAX_MESSAGE_LEN];
-            snprintf(msg, sizeof(msg), "%s dropped!", boss_drop.name);
-            push_message(g, msg);
+            event_set_name(game_log(g, EVENT_LOOT), boss_drop.name);
         }
         return;
     }
@@ -150,20 +111,27 @@ static void drop_loot(GameState *g, int x, int y, EnemyType type, int is_boss) {
 
     FloorItem fi = {0};
     fi.active = 1;
-    fi.x      = x;
-    fi.y      = y;
+    fi.x      = ex;
+    fi.y      = ey;
     fi.item   = item;
     g->floor_items[g->floor_item_count++] = fi;
 
-    g->map.tiles[y][x] = TILE_ITEM;
-    char item_msg[MAX_MESSAGE_LEN];
-    snprintf(item_msg, sizeof(item_msg), "%s dropped!", item.name);
-    push_message(g, item_msg);
+    g->map.tiles[ey][ex] = TILE_ITEM;
+    event_set_name(game_log(g, EVENT_LOOT), item.name);
+}
+
+// An enemy's stats with its effects
+static int enemy_attack(const GameState *g, int i) {
+    return ENEMY_KIND(&g->enemies, i)->attack + g->effects.mods[i].attack;
+}
+
+static int enemy_defense(const GameState *g, int i) {
+    return ENEMY_KIND(&g->enemies, i)->defense + g->effects.mods[i].defense;
 }
 
 static void set_trail(GameState *g, int sx, int sy,
                       int tx, int ty, int dx, int dy,
-                      int range, Uint8 r, Uint8 gr, Uint8 b) {
+                      int range, uint8_t r, uint8_t gr, uint8_t b) {
     g->trail_count  = 0;
     g->trail_frames = 4;
     int cx = sx;
@@ -185,6 +153,42 @@ static void set_trail(GameState *g, int sx, int sy,
     }
 }
 
+// Where a thrown blast lands: `range` tiles along the player's last
+// step, or short of the first wall on the way
+static void blast_landing(const GameState *g, int range, int *x, int *y) {
+    *x = g->player.x;
+    *y = g->player.y;
+    for (int step = 1; step <= range; step++) {
+        int nx = g->player.x + g->player.last_dx * step;
+        int ny = g->player.y + g->player.last_dy * step;
+        if (!map_is_walkable(&g->map, nx, ny)) break;
+        *x = nx;
+        *y = ny;
+    }
+}
+
+// Deal `dmg` to every enemy that template `t` placed at (ox, oy) reaches.
+// Returns how many it hit.
+static int blast(GameState *g, const AoeTemplate *t, int ox, int oy, int dmg) {
+    AoeTile tiles[AOE_MAX_CELLS];
+    int n = aoe_cast(t, &g->open, ox, oy, tiles);
+    senses_noise(&g->senses, ox, oy, NOISE_BLAST);
+    int *hp = g->enemies.hp, hits = 0;
+    for (int k = 0; k < n; k++) {
+        int i = game_enemy_at(g, tiles[k].x, tiles[k].y);
+        if (i == ENEMY_NONE) continue;
+        hp[i] -= dmg;
+        game_wake_enemy(g, i);
+        if (hp[i] <= 0) {
+            game_kill_enemy(g, i);
+            drop_loot(g, i);
+            player_gain_xp(g, ENEMY_KIND(&g->enemies, i)->experience);
+        }
+        hits++;
+    }
+    return hits;
+}
+
 void action_resolve_player(GameState *g, Action a) {
     if (a.type == ACTION_NONE) return;
 
@@ -194,7 +198,7 @@ void action_resolve_player(GameState *g, Action a) {
                 game_descend(g);
                 g->score += g->level * 100;
             } else {
-                push_message(g, "Clear the level first!");
+                game_note(g, NOTE_CLEAR_LEVEL);
             }
         }
         return;
@@ -203,11 +207,7 @@ void action_resolve_player(GameState *g, Action a) {
     if (a.type == ACTION_ASCEND) {
         if (g->map.tiles[g->player.y][g->player.x] == TILE_STAIRS_UP) {
             if (g->level == 1) {
-                g->location = LOCATION_TOWN;
-                int spawn_x, spawn_y;
-                map_generate_town(&g->map, &spawn_x, &spawn_y);
-                g->player.x = spawn_x;
-                g->player.y = spawn_y;
+                game_return_to_town(g);
             } else {
                 game_ascend(g);
             }
@@ -221,18 +221,16 @@ void action_resolve_player(GameState *g, Action a) {
             if (!fi->active) continue;
             if (fi->x != g->player.x || fi->y != g->player.y) continue;
             if (g->inventory_count >= MAX_INVENTORY) {
-                push_message(g, "Inventory full!");
+                game_note(g, NOTE_INVENTORY_FULL);
                 return;
             }
             g->inventory[g->inventory_count++] = fi->item;
             fi->active = 0;
             g->map.tiles[fi->y][fi->x] = TILE_FLOOR;
-            char msg[MAX_MESSAGE_LEN];
-            snprintf(msg, sizeof(msg), "Picked up %s", fi->item.name);
-            push_message(g, msg);
+            event_set_name(game_log(g, EVENT_PICK_UP), fi->item.name);
             return;
         }
-        push_message(g, "Nothing to pick up");
+        game_note(g, NOTE_NOTHING_HERE);
         return;
     }
 
@@ -240,31 +238,33 @@ void action_resolve_player(GameState *g, Action a) {
         int idx = a.target_x;
         if (idx < 0 || idx >= g->inventory_count) return;
         Item *item = &g->inventory[idx];
-        char msg[MAX_MESSAGE_LEN];
+        GameEvent *ev;
 
         if (item->type == ITEM_POTION_HEALTH) {
             int healed = item->heal_hp;
             g->player.hp += healed;
             if (g->player.hp > g->player.max_hp)
                 g->player.hp = g->player.max_hp;
-            snprintf(msg, sizeof(msg), "Drank %s +%d HP", item->name, healed);
-            push_message(g, msg);
+            ev = game_log(g, EVENT_DRINK_HP);
+            event_set_name(ev, item->name);
+            ev->a = healed;
         } else if (item->type == ITEM_POTION_MANA) {
             int restored = item->heal_mp;
             g->player.mp += restored;
             if (g->player.mp > g->player.max_mp)
                 g->player.mp = g->player.max_mp;
-            snprintf(msg, sizeof(msg), "Drank %s +%d MP", item->name, restored);
-            push_message(g, msg);
+            ev = game_log(g, EVENT_DRINK_MP);
+            event_set_name(ev, item->name);
+            ev->a = restored;
         } else if (item->type == ITEM_SCROLL) {
             for (int i = 0; i < g->player.known_spell_count; i++) {
                 if (g->player.known_spells[i].id == item->spell_id) {
-                    push_message(g, "Already know that spell");
+                    game_note(g, NOTE_SPELL_KNOWN);
                     return;
                 }
             }
             if (g->player.known_spell_count >= MAX_SPELLS) {
-                push_message(g, "Cannot learn more spells");
+                game_note(g, NOTE_SPELLS_FULL);
                 return;
             }
             Spell learned;
@@ -275,10 +275,9 @@ void action_resolve_player(GameState *g, Action a) {
                 default: return;
             }
             g->player.known_spells[g->player.known_spell_count++] = learned;
-            snprintf(msg, sizeof(msg), "Learned %s!", learned.name);
-            push_message(g, msg);
+            event_set_name(game_log(g, EVENT_LEARN), learned.name);
         } else {
-            push_message(g, "Cannot use that item");
+            game_note(g, NOTE_CANNOT_USE);
             return;
         }
 
@@ -293,7 +292,6 @@ void action_resolve_player(GameState *g, Action a) {
         int idx = a.target_x;
         if (idx < 0 || idx >= g->inventory_count) return;
         Item *item = &g->inventory[idx];
-        char msg[MAX_MESSAGE_LEN];
 
         if (item->type == ITEM_WEAPON) {
             if (g->equipped_weapon >= 0 &&
@@ -301,18 +299,16 @@ void action_resolve_player(GameState *g, Action a) {
                 g->player.attack -= g->inventory[g->equipped_weapon].attack_bonus;
             g->equipped_weapon = idx;
             g->player.attack  += item->attack_bonus;
-            snprintf(msg, sizeof(msg), "Equipped %s", item->name);
-            push_message(g, msg);
+            event_set_name(game_log(g, EVENT_EQUIP), item->name);
         } else if (item->type == ITEM_ARMOR) {
             if (g->equipped_armor >= 0 &&
                 g->equipped_armor < g->inventory_count)
                 g->player.defense -= g->inventory[g->equipped_armor].defense_bonus;
             g->equipped_armor  = idx;
             g->player.defense += item->defense_bonus;
-            snprintf(msg, sizeof(msg), "Equipped %s", item->name);
-            push_message(g, msg);
+            event_set_name(game_log(g, EVENT_EQUIP), item->name);
         } else {
-            push_message(g, "Cannot equip that item");
+            game_note(g, NOTE_CANNOT_EQUIP);
         }
         return;
     }
@@ -320,7 +316,7 @@ void action_resolve_player(GameState *g, Action a) {
         int idx = a.target_x;
         if (idx < 0 || idx >= g->inventory_count) return;
         if (g->floor_item_count >= MAX_FLOOR_ITEMS) {
-            push_message(g, "No room to drop item!");
+            game_note(g, NOTE_NO_ROOM_TO_DROP);
             return;
         }
 
@@ -353,28 +349,26 @@ void action_resolve_player(GameState *g, Action a) {
             g->inventory[i] = g->inventory[i + 1];
         g->inventory_count--;
 
-        char msg[MAX_MESSAGE_LEN];
-        snprintf(msg, sizeof(msg), "Dropped %s", fi.item.name);
-        push_message(g, msg);
+        event_set_name(game_log(g, EVENT_DROP), fi.item.name);
         return;
     }
 
     if (a.type == ACTION_CAST_SPELL) {
         if (g->player.equipped_spell < 0 ||
             g->player.equipped_spell >= g->player.known_spell_count) {
-            push_message(g, "No spell equipped!");
+            game_note(g, NOTE_NO_SPELL);
             return;
         }
 
         Spell *sp = &g->player.known_spells[g->player.equipped_spell];
 
         if (g->player.mp < sp->mp_cost) {
-            push_message(g, "Not enough MP!");
+            game_note(g, NOTE_NO_MP);
             return;
         }
 
         if (g->player.last_dx == 0 && g->player.last_dy == 0) {
-            push_message(g, "Move first to aim!");
+            game_note(g, NOTE_AIM_FIRST);
             return;
         }
 
@@ -389,8 +383,8 @@ void action_resolve_player(GameState *g, Action a) {
                 g->player.last_dx, g->player.last_dy,
                 sp->range, 40, 120, 220);
         } else if (sp->type == SPELL_TYPE_DAMAGE_AREA) {
-            int ex = g->player.x + g->player.last_dx * sp->range;
-            int ey = g->player.y + g->player.last_dy * sp->range;
+            int ex, ey;
+            blast_landing(g, sp->range, &ex, &ey);
             set_trail(g, g->player.x, g->player.y,
                 ex, ey,
                 g->player.last_dx, g->player.last_dy,
@@ -418,73 +412,45 @@ void action_resolve_player(GameState *g, Action a) {
                 cx = g->player.x + g->player.last_dx * step;
                 cy = g->player.y + g->player.last_dy * step;
                 if (!map_is_walkable(&g->map, cx, cy)) break;
-                for (int i = 0; i < g->enemy_count; i++) {
-                    Enemy *e = &g->enemies[i];
-                    if (!e->active) continue;
-                    if (e->x == cx && e->y == cy) {
-                        int dmg = sp->damage + g->player.level * 2;
-                        e->hp -= dmg;
-                        char msg[MAX_MESSAGE_LEN];
-                        if (e->hp <= 0) {
-                            e->active = 0;
-                            int all_clear = 1;
-                            for (int j = 0; j < g->enemy_count; j++)
-                                if (g->enemies[j].active) { all_clear = 0; break; }
-                            if (all_clear) g->level_cleared = 1;
-                            drop_loot(g, e->x, e->y, e->type, e->is_boss);
-                            player_gain_xp(g, e->experience);
-                            g->score += enemy_score(e->type);
-                            snprintf(msg, sizeof(msg), "%s killed %s!",
-                                sp->name, e->name);
-                        } else {
-                            snprintf(msg, sizeof(msg), "%s hit %s: %d dmg",
-                                sp->name, e->name, dmg);
-                        }
-                        push_message(g, msg);
-                        hit = 1;
+                int e = game_enemy_at(g, cx, cy);
+                if (e != ENEMY_NONE) {
+                    int dmg = sp->damage + g->player.level * 2;
+                    g->enemies.hp[e] -= dmg;
+                    senses_noise(&g->senses, cx, cy, NOISE_FIGHT);
+                    game_wake_enemy(g, e); // a hit from afar wakes it
+                    GameEvent *ev;
+                    if (g->enemies.hp[e] <= 0) {
+                        game_kill_enemy(g, e);
+                        drop_loot(g, e);
+                        player_gain_xp(g, ENEMY_KIND(&g->enemies, e)->experience);
+                        g->score += ENEMY_KIND(&g->enemies, e)->score;
+                        ev = game_log(g, EVENT_SPELL_KILL);
+                    } else {
+                        ev = game_log(g, EVENT_SPELL_HIT);
+                        ev->a = dmg;
                     }
+                    event_set_name(ev, sp->name);
+                    ev->subject = g->enemies.type[e];
+                    hit = 1;
                 }
             }
-            if (!hit) push_message(g, "Spell missed!");
+            if (!hit) game_note(g, NOTE_SPELL_MISSED);
 
         } else if (sp->type == SPELL_TYPE_HEAL) {
             int healed = sp->heal_hp + g->player.level * 2;
             g->player.hp += healed;
             if (g->player.hp > g->player.max_hp)
                 g->player.hp = g->player.max_hp;
-            char msg[MAX_MESSAGE_LEN];
-            snprintf(msg, sizeof(msg), "Healed %d HP!", healed);
-            push_message(g, msg);
+            game_log(g, EVENT_SPELL_HEAL)->a = healed;
 
         } else if (sp->type == SPELL_TYPE_DAMAGE_AREA) {
-            // Travel then explode in radius
-            int cx = g->player.x + g->player.last_dx * sp->range;
-            int cy = g->player.y + g->player.last_dy * sp->range;
-            int hits = 0;
-            for (int i = 0; i < g->enemy_count; i++) {
-                Enemy *e = &g->enemies[i];
-                if (!e->active) continue;
-                int dx = e->x - cx;
-                int dy = e->y - cy;
-                int dist = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
-                if (dist <= sp->radius) {
-                    int dmg = sp->damage + g->player.level * 2;
-                    e->hp -= dmg;
-                    if (e->hp <= 0) {
-                        e->active = 0;
-                        drop_loot(g, e->x, e->y, e->type, e->is_boss);
-                        player_gain_xp(g, e->experience);
-                    }
-                    hits++;
-                }
-            }
-            int all_clear = 1;
-            for (int j = 0; j < g->enemy_count; j++)
-                if (g->enemies[j].active) { all_clear = 0; break; }
-            if (all_clear) g->level_cleared = 1;
-            char msg[MAX_MESSAGE_LEN];
-            snprintf(msg, sizeof(msg), "Fireball hit %d enemies!", hits);
-            push_message(g, msg);
+            // Travel then explode in the spell's shape, which walls stop
+            int cx, cy;
+            blast_landing(g, sp->range, &cx, &cy);
+            const AoeTemplate *t = aoe_template((AoeShape)sp->shape, sp->radius,
+                                                g->player.last_dx, g->player.last_dy);
+            int hits = blast(g, t, cx, cy, sp->damage + g->player.level * 2);
+            game_log(g, EVENT_FIREBALL)->a = hits;
         }
         return;
     }
@@ -492,18 +458,18 @@ void action_resolve_player(GameState *g, Action a) {
     if (a.type == ACTION_RANGED_ATTACK) {
         if (g->equipped_weapon < 0 ||
             g->equipped_weapon >= g->inventory_count) {
-            push_message(g, "No weapon equipped!");
+            game_note(g, NOTE_NO_WEAPON);
             return;
         }
 
         Item *wpn = &g->inventory[g->equipped_weapon];
         if (!wpn->is_ranged) {
-            push_message(g, "No ranged weapon equipped!");
+            game_note(g, NOTE_NO_RANGED);
             return;
         }
 
         if (g->player.last_dx == 0 && g->player.last_dy == 0) {
-            push_message(g, "Move first to aim!");
+            game_note(g, NOTE_AIM_FIRST);
             return;
         }
 
@@ -512,30 +478,25 @@ void action_resolve_player(GameState *g, Action a) {
             int tx = g->player.x + g->player.last_dx * step;
             int ty = g->player.y + g->player.last_dy * step;
             if (!map_is_walkable(&g->map, tx, ty)) break;
-            for (int i = 0; i < g->enemy_count; i++) {
-                Enemy *e = &g->enemies[i];
-                if (!e->active) continue;
-                if (e->x != tx || e->y != ty) continue;
-                int dmg = g->player.attack - e->defense;
-                if (dmg < 1) dmg = 1;
-                e->hp -= dmg;
-                char msg[MAX_MESSAGE_LEN];
-                if (e->hp <= 0) {
-                    e->active = 0;
-                    int all_clear = 1;
-                    for (int j = 0; j < g->enemy_count; j++)
-                        if (g->enemies[j].active) { all_clear = 0; break; }
-                    if (all_clear) g->level_cleared = 1;
-                    drop_loot(g, e->x, e->y, e->type, e->is_boss);
-                    player_gain_xp(g, e->experience);
-                    snprintf(msg, sizeof(msg), "Attack killed %s!", e->name);
-                } else {
-                    snprintf(msg, sizeof(msg), "Attack hit %s: %d dmg",
-                        e->name, dmg);
-                }
-                push_message(g, msg);
-                hit = 1;
+            int e = game_enemy_at(g, tx, ty);
+            if (e == ENEMY_NONE) continue;
+            int dmg = g->player.attack - enemy_defense(g, e);
+            if (dmg < 1) dmg = 1;
+            g->enemies.hp[e] -= dmg;
+            senses_noise(&g->senses, tx, ty, NOISE_FIGHT);
+            game_wake_enemy(g, e);
+            GameEvent *ev;
+            if (g->enemies.hp[e] <= 0) {
+                game_kill_enemy(g, e);
+                drop_loot(g, e);
+                player_gain_xp(g, ENEMY_KIND(&g->enemies, e)->experience);
+                ev = game_log(g, EVENT_SHOT_KILL);
+            } else {
+                ev = game_log(g, EVENT_SHOT_HIT);
+                ev->a = dmg;
             }
+            ev->subject = g->enemies.type[e];
+            hit = 1;
         }
         // Gray trail for ranged weapon
         int ex = g->player.x + g->player.last_dx * wpn->range;
@@ -544,7 +505,7 @@ void action_resolve_player(GameState *g, Action a) {
             ex, ey,
             g->player.last_dx, g->player.last_dy,
             wpn->range, 160, 160, 160);
-        if (!hit) push_message(g, "Attack missed!");
+        if (!hit) game_note(g, NOTE_ATTACK_MISSED);
         return;
     }
 
@@ -553,37 +514,28 @@ void action_resolve_player(GameState *g, Action a) {
         int ty = a.target_y;
 
         // Check for enemy at target
-        for (int i = 0; i < g->enemy_count; i++) {
-            Enemy *e = &g->enemies[i];
-            if (!e->active) continue;
-            if (e->x == tx && e->y == ty) {
-                // Melee attack
-                int dmg = g->player.attack - e->defense;
-                if (dmg < 1) dmg = 1;
-                e->hp -= dmg;
-                #ifndef TEST_BUILD
-                sfx_play_attack();
-                #endif
-                char msg[MAX_MESSAGE_LEN];
-                if (e->hp <= 0) {
-                    e->active = 0;
-                    drop_loot(g, e->x, e->y, e->type, e->is_boss);
-                    player_gain_xp(g, e->experience);
-                    int all_clear = 1;
-                    for (int j = 0; j < g->enemy_count; j++) {
-                        if (g->enemies[j].active) { all_clear = 0; break; }
-                    }
-                    if (all_clear) g->level_cleared = 1;
-                    char msg[MAX_MESSAGE_LEN];
-                    snprintf(msg, sizeof(msg), "Killed %s!", e->name);
-                    push_message(g, msg);
-                } else {
-                    char msg[MAX_MESSAGE_LEN];
-                    snprintf(msg, sizeof(msg), "Hit %s: %d dmg", e->name, dmg);
-                    push_message(g, msg);
-                }
-                return;
+        int e = game_enemy_at(g, tx, ty);
+        if (e != ENEMY_NONE) {
+            // Melee attack
+            int dmg = g->player.attack - enemy_defense(g, e);
+            if (dmg < 1) dmg = 1;
+            g->enemies.hp[e] -= dmg;
+            senses_noise(&g->senses, tx, ty, NOISE_FIGHT);
+            #ifndef TEST_BUILD
+            sfx_play_attack();
+            #endif
+            GameEvent *ev;
+            if (g->enemies.hp[e] <= 0) {
+                game_kill_enemy(g, e);
+                drop_loot(g, e);
+                player_gain_xp(g, ENEMY_KIND(&g->enemies, e)->experience);
+                ev = game_log(g, EVENT_KILL);
+            } else {
+                ev = game_log(g, EVENT_HIT);
+                ev->a = dmg;
             }
+            ev->subject = g->enemies.type[e];
+            return;
         }
         // Check for town exit
         if (g->location == LOCATION_TOWN &&
@@ -611,14 +563,14 @@ void action_resolve_player(GameState *g, Action a) {
             else if (roll == 1) trap_type = TILE_TRAP_FIRE;
             else                trap_type = TILE_TRAP_POISON;
             g->map.tiles[py][px] = trap_type;
+            senses_noise(&g->senses, px, py, NOISE_TRAP);
 
             int dmg = 0;
-            char msg[MAX_MESSAGE_LEN];
 
             if (trap_type == TILE_TRAP_SPIKE) {
                 dmg = 5 + rand() % 10;
                 g->player.hp -= dmg;
-                snprintf(msg, sizeof(msg), "Spike trap! -%d HP", dmg);
+                game_log(g, EVENT_TRAP_SPIKE)->a = dmg;
                 // Red flash
                 g->trail_count  = 0;
                 g->trail_frames = 4;
@@ -629,7 +581,7 @@ void action_resolve_player(GameState *g, Action a) {
             } else if (trap_type == TILE_TRAP_FIRE) {
                 dmg = 4 + rand() % 8;
                 g->player.hp -= dmg;
-                snprintf(msg, sizeof(msg), "Fire trap! -%d HP", dmg);
+                game_log(g, EVENT_TRAP_FIRE)->a = dmg;
                 // Orange flash
                 g->trail_count  = 0;
                 g->trail_frames = 4;
@@ -638,8 +590,8 @@ void action_resolve_player(GameState *g, Action a) {
                 t->r = 220; t->g = 100; t->b = 20;
                 t->is_impact = 1;
             } else if (trap_type == TILE_TRAP_POISON) {
-                g->player.poison_turns = 3;
-                snprintf(msg, sizeof(msg), "Poison trap! 3 turns");
+                game_apply_effect(g, EFFECT_PLAYER, EFFECT_POISON, 3);
+                game_log(g, EVENT_TRAP_POISON)->a = 3;
                 // Green flash
                 g->trail_count  = 0;
                 g->trail_frames = 4;
@@ -648,57 +600,81 @@ void action_resolve_player(GameState *g, Action a) {
                 t->r = 40; t->g = 180; t->b = 40;
                 t->is_impact = 1;
             }
-            push_message(g, msg);
-        }
-
-        // Apply poison damage each turn
-        if (g->player.poison_turns > 0) {
-            int dmg = 3;
-            g->player.hp -= dmg;
-            g->player.poison_turns--;
-            char msg[MAX_MESSAGE_LEN];
-            snprintf(msg, sizeof(msg), "Poison! -%d HP (%d left)",
-                dmg, g->player.poison_turns);
-            push_message(g, msg);
+        } else if (tile == TILE_GOLD) {
+            // Gold piles come from treasure vaults
+            int gold = 5 * g->level + rand() % (5 * g->level + 1);
+            g->gold  += gold;
+            g->score += gold;
+            g->map.tiles[py][px] = TILE_FLOOR;
+            game_log(g, EVENT_GOLD)->a = gold;
         }
     }
 }
 
-void action_resolve_enemies(GameState *g) {
-    for (int i = 0; i < g->enemy_count; i++) {
-        Enemy *e = &g->enemies[i];
-        if (!e->active) continue;
-
-        int dx = g->player.x - e->x;
-        int dy = g->player.y - e->y;
-
-        // Adjacent to player — melee attack
-        if (abs_int(dx) <= 1 && abs_int(dy) <= 1 &&
-            !(dx == 0 && dy == 0)) {
-                int dmg = e->attack - g->player.defense;
-                if (dmg < 1) dmg = 1;
-                g->player.hp -= dmg;
-                char msg[MAX_MESSAGE_LEN];
-                snprintf(msg, sizeof(msg), "%s: %d dmg", e->name, dmg);
-                push_message(g, msg);
-                continue;
-        }
+// Planning threads for enemy waves; NULL plans in place
+static ThreadPool *intent_pool;
 
-        // Move toward player
-        if (e->type == ENEMY_ZOMBIE) { // Zombies move every other turn
-            e->move_timer++;
-            if (e->move_timer % 2 != 0) continue;
-        }
+void action_set_intent_pool(ThreadPool *pool) {
+    intent_pool = pool;
+}
 
-        int mx = (dx > 0) ? 1 : (dx < 0) ? -1 : 0;
-        int my = (dy > 0) ? 1 : (dy < 0) ? -1 : 0;
-        int tx = e->x + mx;
-        int ty = e->y + my;
+// Carry out enemy `i`'s plan. A step onto a tile an earlier enemy in the
+// wave has just taken is decided again from where things now stand.
+static void enemy_act(GameState *g, int i, EnemyIntent in) {
+    EnemyPool *p = &g->enemies;
+    if (in.kind == INTENT_MOVE && game_enemy_at(g, in.x, in.y) != ENEMY_NONE)
+        in = intent_decide(g, p->x[i], p->y[i]);
+
+    if (in.kind == INTENT_ATTACK) {
+        int dmg = enemy_attack(g, i) - g->player.defense;
+        if (dmg < 1) dmg = 1;
+        g->player.hp -= dmg;
+        senses_noise(&g->senses, p->x[i], p->y[i], NOISE_FIGHT);
+        GameEvent *ev = game_log(g, EVENT_HURT);
+        ev->subject = p->type[i];
+        ev->a       = dmg;
+    } else if (in.kind == INTENT_MOVE) {
+        int from_x = p->x[i], from_y = p->y[i];
+        p->x[i] = in.x;
+        p->y[i] = in.y;
+        occupancy_move(&g->occupancy, p, i, from_x, from_y);
+    }
+}
 
-        if (map_is_walkable(&g->map, tx, ty) &&
-            !(tx == g->player.x && ty == g->player.y)) {
-            e->x = tx;
-            e->y = ty;
+void action_resolve_enemies(GameState *g) {
+    g->turn++; // the clock cached levels catch up against
+    game_tick_effects(g);
+    senses_update(&g->senses, &g->regions, &g->open, g->player.x, g->player.y);
+    game_wake_near_player(g);
+    game_wake_on_noise(g);
+    // One field serves every enemy; it is rebuilt only when the player moves
+    if (g->schedule.count > 0)
+        flow_update(&g->flow, &g->map, g->player.x, g->player.y);
+
+    // A hasted player's turn is over sooner, so less happens in it
+    int then = g->clock, due;
+    g->clock += TURN_TICKS * 100 / effects_speed(&g->effects, EFFECT_PLAYER);
+
+    // Only enemies whose time has come are taken off the schedule; a fast
+    // one may come round more than once, a slow one not at all. Those due
+    // together act as a wave: all plan, then all act in schedule order.
+    EnemyPool *p = &g->enemies;
+    int wave[MAX_ENEMIES];
+    EnemyIntent plans[MAX_ENEMIES];
+    for (;;) {
+        int n = 0, i;
+        while ((i = schedule_peek(&g->schedule, &due)) != SCHEDULE_NONE && due <= g->clock) {
+            schedule_pop(&g->schedule);
+            // One that fell behind (woken between turns, or back from the
+            // level store) starts over from now instead of catching up
+            if (due <= then) due = g->clock;
+            p->next_act[i] = due + enemy_act_delay(p, i) * 100 / effects_speed(&g->effects, i);
+            wave[n++] = i;
         }
+        if (n == 0) break;
+        for (int k = 0; k < n; k++)
+            schedule_add(&g->schedule, wave[k], p->next_act[wave[k]]);
+        intent_plan(g, p->x, p->y, wave, n, plans, intent_pool);
+        for (int k = 0; k < n; k++) enemy_act(g, wave[k], plans[k]);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,144 @@
+#include "aoe.h"
+#include <string.h>
+
+#define DIRS 8
+// Cells in the square boxes of every radius, a bound on any one shape's
+// cells summed over radii
+#define BOX_CELLS ((AOE_MAX_RADIUS + 1) * (2 * AOE_MAX_RADIUS + 1) * (2 * AOE_MAX_RADIUS + 3) / 3)
+// Centred shapes are stored once, lines and cones once per direction
+#define POOL_CELLS ((3 + 2 * DIRS) * BOX_CELLS)
+
+static const int DIR_STEPS[DIRS][2] = {
+    { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 },
+    { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }
+};
+
+static AoeCell     pool[POOL_CELLS];
+static int         pool_used;
+static AoeTemplate templates[AOE_SHAPE_COUNT][AOE_MAX_RADIUS + 1][DIRS];
+static int         built;
+
+static int abs_int(int n) { return n < 0 ? -n : n; }
+
+static int steps(int dx, int dy) {
+    return abs_int(dx) > abs_int(dy) ? abs_int(dx) : abs_int(dy);
+}
+
+// a / b rounded to nearest, halves away from zero; b > 0
+static int div_round(int a, int b) {
+    return a >= 0 ? (2 * a + b) / (2 * b) : -((-2 * a + b) / (2 * b));
+}
+
+static int in_shape(AoeShape shape, int r, int ux, int uy, int dx, int dy) {
+    switch (shape) {
+        case AOE_DIAMOND: return abs_int(dx) + abs_int(dy) <= r;
+        case AOE_DISK:    return dx * dx + dy * dy <= r * r + r;
+        case AOE_CROSS:   return (dx == 0 || dy == 0) && abs_int(dx) + abs_int(dy) <= r;
+        case AOE_LINE: {
+            int n = steps(dx, dy);
+            return n >= 1 && n <= r && dx == ux * n && dy == uy * n;
+        }
+        case AOE_CONE: {
+            // Within 45 degrees either side of (ux, uy)
+            int dot = dx * ux + dy * uy;
+            return steps(dx, dy) <= r && dot > 0 &&
+                   2 * dot * dot >= (dx * dx + dy * dy) * (ux * ux + uy * uy);
+        }
+        default: return 0;
+    }
+}
+
+static void build(AoeTemplate *t, AoeShape shape, int r, int ux, int uy) {
+    int index[AOE_SPAN][AOE_SPAN];
+    memset(index, 0xFF, sizeof(index)); // -1 everywhere
+    AoeCell *cells = &pool[pool_used];
+    int count = 0;
+
+    memset(t, 0, sizeof(*t));
+    // Ring by ring outward, so a cell's parent is always listed first
+    for (int n = 0; n <= r; n++) {
+        for (int dy = -n; dy <= n; dy++) {
+            for (int dx = -n; dx <= n; dx++) {
+                if (steps(dx, dy) != n || !in_shape(shape, r, ux, uy, dx, dy)) continue;
+                AoeCell *c = &cells[count];
+                c->dx = (int8_t)dx;
+                c->dy = (int8_t)dy;
+                c->parent = AOE_ORIGIN;
+                // The nearest earlier cell on the line back to the origin
+                for (int m = n - 1; m >= 1; m--) {
+                    int p = index[div_round(dy * m, n) + AOE_MAX_RADIUS]
+                                 [div_round(dx * m, n) + AOE_MAX_RADIUS];
+                    if (p >= 0) { c->parent = (uint8_t)p; break; }
+                }
+                index[dy + AOE_MAX_RADIUS][dx + AOE_MAX_RADIUS] = count++;
+                t->rows[dy + r] |= (uint16_t)(1u << (dx + r));
+            }
+        }
+    }
+    t->cells  = cells;
+    t->count  = count;
+    t->radius = r;
+    pool_used += count;
+}
+
+void aoe_init(void) {
+    if (built) return;
+    pool_used = 0;
+    for (int s = 0; s < AOE_SHAPE_COUNT; s++) {
+        int directed = s == AOE_LINE || s == AOE_CONE;
+        for (int r = 0; r <= AOE_MAX_RADIUS; r++) {
+            for (int d = 0; d < DIRS; d++) {
+                if (!directed && d > 0) {
+                    templates[s][r][d] = templates[s][r][0];
+                    continue;
+                }
+                build(&templates[s][r][d], (AoeShape)s, r, DIR_STEPS[d][0], DIR_STEPS[d][1]);
+            }
+        }
+    }
+    built = 1;
+}
+
+const AoeTemplate *aoe_template(AoeShape shape, int radius, int dx, int dy) {
+    if (!built) aoe_init();
+    if (radius < 0) radius = 0;
+    if (radius > AOE_MAX_RADIUS) radius = AOE_MAX_RADIUS;
+    int sx = (dx > 0) - (dx < 0);
+    int sy = (dy > 0) - (dy < 0);
+    int d = 0;
+    for (int k = 0; k < DIRS; k++)
+        if (DIR_STEPS[k][0] == sx && DIR_STEPS[k][1] == sy) d = k;
+    return &templates[shape][radius][d];
+}
+
+// Bits [x0, x0 + w) of row y of `b`, bit 0 for x0; off the grid reads as 0
+static uint32_t row_window(const BitGrid *b, int y, int x0, int w) {
+    if (y < 0 || y >= MAP_H) return 0;
+    int lo = x0 < 0 ? 0 : x0;
+    if (lo >= MAP_W) return 0;
+    int word = lo / 64, bit = lo % 64;
+    uint64_t v = b->rows[y][word] >> bit;
+    if (bit && word + 1 < BITGRID_WORDS) v |= b->rows[y][word + 1] << (64 - bit);
+    v <<= lo - x0;
+    return (uint32_t)(v & ((1u << w) - 1));
+}
+
+int aoe_cast(const AoeTemplate *t, const BitGrid *open, int ox, int oy,
+             AoeTile *out) {
+    int r = t->radius;
+    uint32_t hit[AOE_SPAN]; // open tiles of the shape, a row at a time
+    for (int row = 0; row <= 2 * r; row++)
+        hit[row] = t->rows[row] ? row_window(open, oy + row - r, ox - r, 2 * r + 1) & t->rows[row] : 0;
+
+    int origin_open = bitgrid_get(open, ox, oy);
+    uint8_t reached[AOE_MAX_CELLS];
+    int count = 0;
+    for (int i = 0; i < t->count; i++) {
+        const AoeCell *c = &t->cells[i];
+        int ok = (int)((hit[c->dy + r] >> (c->dx + r)) & 1);
+        if (ok) ok = c->parent == AOE_ORIGIN ? origin_open : reached[c->parent];
+        reached[i] = (uint8_t)ok;
+        if (ok) out[count++] = (AoeTile){ ox + c->dx, oy + c->dy };
+    }
+    return count;
+}
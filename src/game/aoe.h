@@ -0,0 +1,58 @@
+#ifndef AOE_HEADER_H
+#define AOE_HEADER_H
+
+#include <stdint.h>
+#include "bitgrid.h"
+
+// Area-of-effect shapes, worked out once per shape, size and direction
+// as a list of offsets (nearest first) and a bitmask per row. Casting
+// one ANDs the row masks with the walkable bitboard a row at a time and
+// keeps a tile only if the tile before it on the line back to the origin
+// was kept too, so walls stop a blast the way they stop sight. That is
+// one pass over the shape's own tiles, whatever the level holds.
+
+typedef enum {
+    AOE_DIAMOND = 0, // tiles within `radius` steps of 4-way movement
+    AOE_DISK,        // round
+    AOE_CROSS,       // straight out along the four axes
+    AOE_LINE,        // `radius` tiles in one of 8 directions
+    AOE_CONE,        // a 90 degree wedge `radius` deep in one of 8 directions
+    AOE_SHAPE_COUNT
+} AoeShape;
+
+#define AOE_MAX_RADIUS 6
+#define AOE_SPAN       (2 * AOE_MAX_RADIUS + 1)
+#define AOE_MAX_CELLS  (AOE_SPAN * AOE_SPAN)
+#define AOE_ORIGIN     0xFF // parent of a cell next to the origin
+
+typedef struct {
+    int8_t  dx, dy;
+    uint8_t parent; // index of the cell before it, or AOE_ORIGIN
+} AoeCell;
+
+typedef struct {
+    const AoeCell *cells;
+    int            count;
+    int            radius;
+    uint16_t       rows[AOE_SPAN]; // bit dx + radius of row dy + radius
+} AoeTemplate;
+
+typedef struct {
+    int x, y;
+} AoeTile;
+
+// Build every template; called once at startup, and by aoe_template if
+// it has not been
+void aoe_init(void);
+
+// The template for `shape`, `radius` (clamped to AOE_MAX_RADIUS) and,
+// for lines and cones, the direction (dx, dy). Centred shapes include
+// the origin itself; lines and cones start next to it.
+const AoeTemplate *aoe_template(AoeShape shape, int radius, int dx, int dy);
+
+// Tiles of `t` placed at (ox, oy) that a blast through `open` reaches,
+// nearest first. `out` must hold AOE_MAX_CELLS. Returns how many.
+int aoe_cast(const AoeTemplate *t, const BitGrid *open, int ox, int oy,
+             AoeTile *out);
+
+#endif
@@ -0,0 +1,190 @@
+#include "bitgrid.h"
+#include <string.h>
+
+void bitgrid_clear(BitGrid *b) {
+    memset(b, 0, sizeof(*b));
+}
+
+int bitgrid_get(const BitGrid *b, int x, int y) {
+    if (x < 0 || x >= MAP_W || y < 0 || y >= MAP_H) return 0;
+    return (int)((b->rows[y][x / 64] >> (x % 64)) & 1);
+}
+
+void bitgrid_set(BitGrid *b, int x, int y, int on) {
+    if (x < 0 || x >= MAP_W || y < 0 || y >= MAP_H) return;
+    uint64_t bit = 1ULL << (x % 64);
+    if (on) b->rows[y][x / 64] |=  bit;
+    else    b->rows[y][x / 64] &= ~bit;
+}
+
+int bitgrid_count(const BitGrid *b) {
+    int n = 0;
+    for (int y = 0; y < MAP_H; y++)
+        for (int i = 0; i < BITGRID_WORDS; i++)
+            n += bitgrid_popcount64(b->rows[y][i]);
+    return n;
+}
+
+void bitgrid_and_not(BitGrid *dst, const BitGrid *mask) {
+    for (int y = 0; y < MAP_H; y++)
+        for (int i = 0; i < BITGRID_WORDS; i++)
+            dst->rows[y][i] &= ~mask->rows[y][i];
+}
+
+// Floor and wall make up most of any level and are the tile values 0
+// and 1, so eight tiles that are all one or the other are packed at once,
+// each as its TILE_TRAITS row says. Returns 0 if any of the eight is
+// something else.
+static int pack_floor_wall(uint64_t v, uint64_t *bits) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    if (v & ~ones) return 0;
+    uint64_t walk = (TILE_HAS(TILE_WALL,  TRAIT_WALKABLE) ? v        : 0) |
+                    (TILE_HAS(TILE_FLOOR, TRAIT_WALKABLE) ? v ^ ones : 0);
+    *bits = (walk * 0x0102040810204080ULL) >> 56;
+    return 1;
+}
+
+void bitgrid_from_map(BitGrid *b, const Map *m) {
+    for (int y = 0; y < m->h; y++) {
+        const unsigned char *row = m->tiles[y];
+        for (int i = 0; i < BITGRID_WORDS; i++) {
+            uint64_t bits = 0, packed;
+            int x = i * 64;
+            for (int k = 0; k < 64 && x < m->w; k += 8, x += 8) {
+                if (x + 8 <= m->w) {
+                    uint64_t v;
+                    memcpy(&v, row + x, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                    v = __builtin_bswap64(v); // byte k must hold tile x + k
+#endif
+                    if (pack_floor_wall(v, &packed)) {
+                        bits |= packed << k;
+                        continue;
+                    }
+                }
+                for (int t = 0; t < 8 && x + t < m->w; t++)
+                    bits |= (uint64_t)TILE_HAS(row[x + t], TRAIT_WALKABLE) << (k + t);
+            }
+            b->rows[y][i] = bits;
+        }
+    }
+    memset(b->rows[m->h], 0, sizeof(b->rows[0]) * (MAP_H - m->h));
+}
+
+int bitgrid_nth(const BitGrid *b, int n, int *x, int *y) {
+    for (int ry = 0; ry < MAP_H; ry++) {
+        for (int i = 0; i < BITGRID_WORDS; i++) {
+            uint64_t w = b->rows[ry][i];
+            int c = bitgrid_popcount64(w);
+            if (n >= c) { n -= c; continue; }
+            while (n-- > 0) w &= w - 1; // drop the lowest set bits
+            *x = i * 64 + bitgrid_ctz64(w);
+            *y = ry;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ── Row shifts (bit x moves to x + k / x - k) ───────────────────────────
+
+static void row_shl(uint64_t *dst, const uint64_t *src, int k) {
+    int wk = k / 64, bk = k % 64;
+    for (int i = BITGRID_WORDS - 1; i >= 0; i--) {
+        uint64_t v = 0;
+        if (i - wk >= 0) v = src[i - wk] << bk;
+        if (bk && i - wk - 1 >= 0) v |= src[i - wk - 1] >> (64 - bk);
+        dst[i] = v;
+    }
+    dst[BITGRID_WORDS - 1] &= BITGRID_LAST_MASK;
+}
+
+static void row_shr(uint64_t *dst, const uint64_t *src, int k) {
+    int wk = k / 64, bk = k % 64;
+    for (int i = 0; i < BITGRID_WORDS; i++) {
+        uint64_t v = 0;
+        if (i + wk < BITGRID_WORDS) v = src[i + wk] >> bk;
+        if (bk && i + wk + 1 < BITGRID_WORDS) v |= src[i + wk + 1] << (64 - bk);
+        dst[i] = v;
+    }
+}
+
+// Spread `g` along runs of `open` in both directions. Kogge-Stone style:
+// after the step with shift s, `p` marks tiles whose s tiles behind are
+// all open, so the fill doubles its reach each step.
+static void row_fill(uint64_t *g, const uint64_t *open) {
+    uint64_t gen[BITGRID_WORDS], p[BITGRID_WORDS], t[BITGRID_WORDS];
+
+    memcpy(gen, g, sizeof(gen));
+    memcpy(p, open, sizeof(p));
+    for (int s = 1; s < MAP_W; s *= 2) {
+        row_shl(t, gen, s);
+        for (int i = 0; i < BITGRID_WORDS; i++) gen[i] |= t[i] & p[i];
+        row_shl(t, p, s);
+        for (int i = 0; i < BITGRID_WORDS; i++) p[i] &= t[i];
+    }
+
+    memcpy(p, open, sizeof(p));
+    for (int s = 1; s < MAP_W; s *= 2) {
+        row_shr(t, gen, s);
+        for (int i = 0; i < BITGRID_WORDS; i++) gen[i] |= t[i] & p[i];
+        row_shr(t, p, s);
+        for (int i = 0; i < BITGRID_WORDS; i++) p[i] &= t[i];
+    }
+
+    memcpy(g, gen, sizeof(gen));
+}
+
+int bitgrid_step(BitGrid *dst, const BitGrid *src, const BitGrid *open) {
+    int changed = 0;
+    for (int y = 0; y < MAP_H; y++) {
+        const uint64_t *row = src->rows[y];
+        for (int i = 0; i < BITGRID_WORDS; i++) {
+            uint64_t v = row[i] | (row[i] << 1) | (row[i] >> 1);
+            if (i > 0)                 v |= row[i - 1] >> 63;
+            if (i < BITGRID_WORDS - 1) v |= row[i + 1] << 63;
+            if (y > 0)         v |= src->rows[y - 1][i];
+            if (y < MAP_H - 1) v |= src->rows[y + 1][i];
+            v &= open->rows[y][i];
+            if (v != row[i]) changed = 1;
+            dst->rows[y][i] = v;
+        }
+    }
+    return changed;
+}
+
+// Alternating downward and upward sweeps; each row picks up the row just
+// processed and is then filled sideways, so a sweep follows a passage for
+// its whole length instead of one tile per pass. Rows that gained nothing
+// are already filled, except for seed rows on the first sweep (`fill_all`).
+static int sweep(BitGrid *reach, const BitGrid *open,
+                 int y0, int y1, int dy, int fill_all) {
+    int changed = 0;
+    for (int y = y0; y != y1; y += dy) {
+        uint64_t row[BITGRID_WORDS];
+        int grew = 0, any = 0;
+        for (int i = 0; i < BITGRID_WORDS; i++) {
+            row[i] = reach->rows[y][i];
+            any |= row[i] != 0;
+            if (y - dy >= 0 && y - dy < MAP_H)
+                row[i] |= reach->rows[y - dy][i] & open->rows[y][i];
+            if (row[i] != reach->rows[y][i]) grew = 1;
+        }
+        if (!grew && !(fill_all && any)) continue;
+        row_fill(row, open->rows[y]);
+        for (int i = 0; i < BITGRID_WORDS; i++) {
+            if (row[i] != reach->rows[y][i]) changed = 1;
+            reach->rows[y][i] = row[i];
+        }
+    }
+    return changed;
+}
+
+int bitgrid_flood(BitGrid *reach, const BitGrid *open) {
+    int changed = sweep(reach, open, 0, MAP_H, 1, 1);
+    while (changed) {
+        changed  = sweep(reach, open, MAP_H - 1, -1, -1, 0);
+        changed |= sweep(reach, open, 0, MAP_H, 1, 0);
+    }
+    return bitgrid_count(reach);
+}
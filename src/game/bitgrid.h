@@ -0,0 +1,63 @@
+#ifndef BITGRID_HEADER_H
+#define BITGRID_HEADER_H
+
+#include <stdint.h>
+#include "map.h"
+
+// One bit per tile of a MAP_W x MAP_H grid, 64 tiles to a word, so
+// whole-grid passes (cellular automata, flood fills) run a word at a
+// time. Bit x of a row lives in word x / 64. Bits past MAP_W in the last
+// word of a row are always zero.
+
+#define BITGRID_WORDS ((MAP_W + 63) / 64)
+#define BITGRID_LAST_MASK \
+    ((MAP_W % 64) ? ((1ULL << (MAP_W % 64)) - 1) : ~0ULL)
+
+typedef struct {
+    uint64_t rows[MAP_H][BITGRID_WORDS];
+} BitGrid;
+
+void bitgrid_clear(BitGrid *b);
+int  bitgrid_get(const BitGrid *b, int x, int y); // 0 outside the grid
+void bitgrid_set(BitGrid *b, int x, int y, int on);
+int  bitgrid_count(const BitGrid *b);
+void bitgrid_and_not(BitGrid *dst, const BitGrid *mask);
+
+// Walkable tiles of `m` (TRAIT_WALKABLE, inside its bounds)
+void bitgrid_from_map(BitGrid *b, const Map *m);
+
+// Coordinates of the n-th set bit in row-major order. Returns 0 if fewer
+// than n + 1 bits are set.
+int  bitgrid_nth(const BitGrid *b, int n, int *x, int *y);
+
+// One 4-connected growth step: dst = (src | neighbours of src) & open.
+// Returns 1 if dst differs from src.
+int  bitgrid_step(BitGrid *dst, const BitGrid *src, const BitGrid *open);
+
+// Grow `reach` 4-connected through `open` until it stops changing.
+// `reach` must lie inside `open`. Returns the number of bits reached.
+int  bitgrid_flood(BitGrid *reach, const BitGrid *open);
+
+static inline int bitgrid_popcount64(uint64_t v) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(v);
+#else
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (int)((v * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// v must be non-zero
+static inline int bitgrid_ctz64(uint64_t v) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(v);
+#else
+    int n = 0;
+    while (!(v & 1)) { v >>= 1; n++; }
+    return n;
+#endif
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include "cave.h"
+#include "bitgrid.h"
+#include <stdlib.h>
+
+#define CAVE_FILL_PERCENT   45 // initial wall density
+#define CAVE_ITERATIONS     5
+#define CAVE_MIN_OPEN       (MAP_W * MAP_H / 4) // reroll smaller caves
+#define CAVE_ATTEMPTS       8
+#define CAVE_TRAP_CLEARANCE 6  // no traps this close to the stairs up
+#define CAVE_FALLBACK_W     12 // room carved if every attempt comes up empty
+#define CAVE_FALLBACK_H     8
+
+static void set_border(BitGrid *walls) {
+    for (int i = 0; i < BITGRID_WORDS; i++) {
+        walls->rows[0][i]         = ~0ULL;
+        walls->rows[MAP_H - 1][i] = ~0ULL;
+    }
+    walls->rows[0][BITGRID_WORDS - 1]         &= BITGRID_LAST_MASK;
+    walls->rows[MAP_H - 1][BITGRID_WORDS - 1] &= BITGRID_LAST_MASK;
+    for (int y = 1; y < MAP_H - 1; y++) {
+        bitgrid_set(walls, 0, y, 1);
+        bitgrid_set(walls, MAP_W - 1, y, 1);
+    }
+}
+
+static void random_fill(BitGrid *walls, Rng *rng) {
+    uint32_t threshold = (uint32_t)(0xffffffffu / 100 * CAVE_FILL_PERCENT);
+    for (int y = 0; y < MAP_H; y++) {
+        for (int i = 0; i < BITGRID_WORDS; i++) {
+            uint64_t w = 0;
+            for (int b = 0; b < 64; b++)
+                if (rng_next(rng) < threshold) w |= 1ULL << b;
+            walls->rows[y][i] = w;
+        }
+        walls->rows[y][BITGRID_WORDS - 1] &= BITGRID_LAST_MASK;
+    }
+    set_border(walls);
+}
+
+// Walls in each tile plus its left and right neighbour (0..3), bit-sliced
+// into a low and a high bit plane. Off the edge counts as wall.
+static void row_sums(const uint64_t *row, uint64_t *lo, uint64_t *hi) {
+    uint64_t pad[BITGRID_WORDS];
+    for (int i = 0; i < BITGRID_WORDS; i++) pad[i] = row[i];
+    pad[BITGRID_WORDS - 1] |= ~BITGRID_LAST_MASK;
+
+    for (int i = 0; i < BITGRID_WORDS; i++) {
+        uint64_t c = pad[i];
+        uint64_t l = (c << 1) | (i > 0 ? pad[i - 1] >> 63 : 1);
+        uint64_t r = (c >> 1) | ((i + 1 < BITGRID_WORDS ? pad[i + 1] : ~0ULL) << 63);
+        lo[i] = l ^ c ^ r;
+        hi[i] = (l & c) | (l & r) | (c & r);
+    }
+}
+
+// One 4-5 rule step: a tile is wall if at least 5 of the 9 tiles in its
+// 3x3 block are walls (a wall with 4+ wall neighbours survives, a floor
+// with 5+ fills in). The count is summed with adders across bit planes,
+// so every word op updates 64 tiles.
+static void ca_step(BitGrid *walls) {
+    // Rows -1 and MAP_H are solid rock: all three tiles walls
+    uint64_t lo[MAP_H + 2][BITGRID_WORDS], hi[MAP_H + 2][BITGRID_WORDS];
+    for (int i = 0; i < BITGRID_WORDS; i++) {
+        lo[0][i] = hi[0][i] = ~0ULL;
+        lo[MAP_H + 1][i] = hi[MAP_H + 1][i] = ~0ULL;
+    }
+    for (int y = 0; y < MAP_H; y++)
+        row_sums(walls->rows[y], lo[y + 1], hi[y + 1]);
+
+    for (int y = 0; y < MAP_H; y++) {
+        for (int i = 0; i < BITGRID_WORDS; i++) {
+            uint64_t s0 = lo[y][i], s1 = lo[y + 1][i], s2 = lo[y + 2][i];
+            uint64_t c0 = hi[y][i], c1 = hi[y + 1][i], c2 = hi[y + 2][i];
+
+            // count = ones + 2 * twos
+            uint64_t ones_lo = s0 ^ s1 ^ s2;
+            uint64_t ones_hi = (s0 & s1) | (s0 & s2) | (s1 & s2);
+            uint64_t twos_lo = c0 ^ c1 ^ c2;
+            uint64_t twos_hi = (c0 & c1) | (c0 & c2) | (c1 & c2);
+
+            // count = ones_lo + 2 * mid_lo + 4 * top_lo + 8 * top_hi
+            uint64_t mid_lo = ones_hi ^ twos_lo;
+            uint64_t mid_hi = ones_hi & twos_lo;
+            uint64_t top_lo = mid_hi ^ twos_hi;
+            uint64_t top_hi = mid_hi & twos_hi;
+
+            walls->rows[y][i] = top_hi | (top_lo & (mid_lo | ones_lo));
+        }
+        walls->rows[y][BITGRID_WORDS - 1] &= BITGRID_LAST_MASK;
+    }
+    set_border(walls);
+}
+
+static void open_tiles(const BitGrid *walls, BitGrid *open) {
+    for (int y = 0; y < MAP_H; y++) {
+        for (int i = 0; i < BITGRID_WORDS; i++)
+            open->rows[y][i] = ~walls->rows[y][i];
+        open->rows[y][BITGRID_WORDS - 1] &= BITGRID_LAST_MASK;
+    }
+}
+
+// Keep only the biggest 4-connected pocket of `open` (the player moves
+// orthogonally). Returns its size.
+static int largest_region(const BitGrid *open, BitGrid *best) {
+    BitGrid remaining = *open;
+    BitGrid region;
+    int best_n = 0;
+    int left   = bitgrid_count(&remaining);
+
+    bitgrid_clear(best);
+    while (left > best_n) {
+        int x, y;
+        bitgrid_nth(&remaining, 0, &x, &y);
+        bitgrid_clear(&region);
+        bitgrid_set(&region, x, y, 1);
+        int n = bitgrid_flood(&region, open);
+        if (n > best_n) {
+            best_n = n;
+            *best  = region;
+        }
+        bitgrid_and_not(&remaining, &region);
+        left -= n;
+    }
+    return best_n;
+}
+
+// Grow outward from (x, y) one step at a time; the tiles added by the
+// last step are the ones furthest away by walking distance.
+static void farthest_tile(const BitGrid *open, int x, int y, Rng *rng,
+                          int *fx, int *fy) {
+    BitGrid buf[3];
+    BitGrid *prev = &buf[0], *cur = &buf[1], *next = &buf[2];
+    bitgrid_clear(prev);
+    bitgrid_clear(cur);
+    bitgrid_set(cur, x, y, 1);
+    while (bitgrid_step(next, cur, open)) {
+        BitGrid *t = prev;
+        prev = cur;
+        cur  = next;
+        next = t;
+    }
+    bitgrid_and_not(cur, prev);
+    bitgrid_nth(cur, rng_below(rng, bitgrid_count(cur)), fx, fy);
+}
+
+int cave_generate(Map *m, int level, Rng *rng) {
+    BitGrid walls, open, cave, best;
+    int best_n = 0;
+
+    bitgrid_clear(&best);
+    for (int attempt = 0; attempt < CAVE_ATTEMPTS; attempt++) {
+        random_fill(&walls, rng);
+        for (int it = 0; it < CAVE_ITERATIONS; it++)
+            ca_step(&walls);
+        open_tiles(&walls, &open);
+
+        int n = largest_region(&open, &cave);
+        if (n > best_n) {
+            best_n = n;
+            best   = cave;
+        }
+        if (best_n >= CAVE_MIN_OPEN) break;
+    }
+
+    // Too little cave for two stairs (a stuck random stream fills it
+    // solid): fall back to a plain room in the middle
+    if (best_n < 2) {
+        bitgrid_clear(&best);
+        int x0 = (MAP_W - CAVE_FALLBACK_W) / 2, y0 = (MAP_H - CAVE_FALLBACK_H) / 2;
+        for (int y = y0; y < y0 + CAVE_FALLBACK_H; y++)
+            for (int x = x0; x < x0 + CAVE_FALLBACK_W; x++)
+                bitgrid_set(&best, x, y, 1);
+        best_n = CAVE_FALLBACK_W * CAVE_FALLBACK_H;
+    }
+
+    m->w = MAP_W;
+    m->h = MAP_H;
+    m->room_count     = 0;
+    m->corridor_count = 0;
+    m->link_count     = 0;
+    m->lair_x = m->lair_y = -1;
+    for (int y = 0; y < MAP_H; y++)
+        for (int x = 0; x < MAP_W; x++)
+            m->tiles[y][x] = bitgrid_get(&best, x, y) ? TILE_FLOOR : TILE_WALL;
+
+    // Stairs up anywhere, stairs down as far away as the cave allows
+    int ux, uy, dx, dy;
+    bitgrid_nth(&best, rng_below(rng, best_n), &ux, &uy);
+    farthest_tile(&best, ux, uy, rng, &dx, &dy);
+    m->stairs_up_x   = ux;
+    m->stairs_up_y   = uy;
+    m->stairs_down_x = dx;
+    m->stairs_down_y = dy;
+    m->tiles[uy][ux] = TILE_STAIRS_UP;
+    m->tiles[dy][dx] = TILE_STAIRS_DOWN;
+
+    // Same trap count as room levels, kept clear of the arrival point
+    int num_traps = 2 + level;
+    if (num_traps > 12) num_traps = 12;
+    for (int t = 0; t < num_traps; t++) {
+        int tx, ty;
+        bitgrid_nth(&best, rng_below(rng, best_n), &tx, &ty);
+        if (abs(tx - ux) + abs(ty - uy) < CAVE_TRAP_CLEARANCE) continue;
+        if (m->tiles[ty][tx] != TILE_FLOOR) continue;
+        m->tiles[ty][tx] = TILE_TRAP_HIDDEN;
+    }
+
+    return best_n;
+}
@@ -0,0 +1,15 @@
+#ifndef CAVE_HEADER_H
+#define CAVE_HEADER_H
+
+#include "map.h"
+
+// Organic cave levels from the 4-5 cellular automaton rule, run on a
+// bit-packed grid 64 tiles per word. Only the largest connected cave is
+// kept; stairs sit at opposite ends of it. Fills the whole MAP_W x MAP_H
+// grid and leaves room_count at 0.
+//
+// Returns the number of walkable tiles so callers can roll several
+// candidates and keep the one they like best.
+int cave_generate(Map *m, int level, Rng *rng);
+
+#endif
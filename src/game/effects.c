@@ -0,0 +1,178 @@
+#include "effects.h"
+#include <string.h>
+
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_BITS 6 // log2 of WHEEL_SLOTS
+
+const EffectTraits EFFECT_TRAITS[EFFECT_KIND_COUNT] = {
+    //                  name      period  hp  speed  atk def
+    [EFFECT_POISON] = { "Poison",   1,    -3,    0,   0,  0 },
+    [EFFECT_BURN]   = { "Burn",     1,    -2,    0,   0,  0 },
+    [EFFECT_REGEN]  = { "Regen",    1,     2,    0,   0,  0 },
+    [EFFECT_HASTE]  = { "Haste",    0,     0,  100,   0,  0 },
+    [EFFECT_SLOW]   = { "Slow",     0,     0,  -50,   0,  0 },
+    [EFFECT_MIGHT]  = { "Might",    0,     0,    0,   4,  0 },
+    [EFFECT_WARD]   = { "Ward",     0,     0,    0,   0,  4 },
+};
+
+static int due(const Effect *e) {
+    return e->next_tick && e->next_tick < e->expires ? e->next_tick : e->expires;
+}
+
+static void unlink_effect(Effects *fx, int id) {
+    Effect *e = &fx->pool[id];
+    if (e->level < 0) return;
+    if (e->prev >= 0) fx->pool[e->prev].next = e->next;
+    else {
+        int at = e->level == 0 ? due(e) & WHEEL_MASK : (due(e) >> WHEEL_BITS) & WHEEL_MASK;
+        fx->slot[e->level][at] = e->next;
+    }
+    if (e->next >= 0) fx->pool[e->next].prev = e->prev;
+    e->level = -1;
+}
+
+// File the effect under its due turn: to the turn if it is within
+// WHEEL_SLOTS of now, else to its span
+static void link_effect(Effects *fx, int id) {
+    Effect *e = &fx->pool[id];
+    int when  = due(e);
+    int level = when - fx->now < WHEEL_SLOTS ? 0 : 1;
+    int at    = level == 0 ? when & WHEEL_MASK : (when >> WHEEL_BITS) & WHEEL_MASK;
+    e->level = (int8_t)level;
+    e->prev  = -1;
+    e->next  = fx->slot[level][at];
+    if (e->next >= 0) fx->pool[e->next].prev = (int16_t)id;
+    fx->slot[level][at] = (int16_t)id;
+}
+
+static void apply_mods(Effects *fx, const Effect *e, int sign) {
+    const EffectTraits *t = &EFFECT_TRAITS[e->kind];
+    EffectMods *m = &fx->mods[e->target];
+    m->attack  += sign * t->attack;
+    m->defense += sign * t->defense;
+    m->speed   += sign * t->speed;
+}
+
+static void drop(Effects *fx, int id) {
+    unlink_effect(fx, id);
+    apply_mods(fx, &fx->pool[id], -1);
+    fx->pool[id].used = 0;
+    fx->count--;
+}
+
+void effects_init(Effects *fx, int turn) {
+    memset(fx, 0, sizeof(*fx));
+    memset(fx->slot, 0xFF, sizeof(fx->slot)); // -1 everywhere
+    fx->now = turn;
+}
+
+static int find(const Effects *fx, int target, EffectKind kind) {
+    for (int i = 0; i < MAX_EFFECTS; i++) {
+        const Effect *e = &fx->pool[i];
+        if (e->used && e->target == target && e->kind == kind) return i;
+    }
+    return -1;
+}
+
+int effects_add(Effects *fx, int target, EffectKind kind, int turns) {
+    if (target < 0 || target >= EFFECT_TARGETS || turns <= 0) return -1;
+    if (turns > EFFECT_MAX_TURNS) turns = EFFECT_MAX_TURNS;
+    int id = find(fx, target, kind);
+    if (id >= 0) {
+        Effect *e = &fx->pool[id];
+        if (fx->now + turns <= e->expires) return 0;
+        unlink_effect(fx, id);
+        e->expires = fx->now + turns;
+        link_effect(fx, id);
+        return 0;
+    }
+    for (id = 0; id < MAX_EFFECTS && fx->pool[id].used; id++) {}
+    if (id == MAX_EFFECTS) return -1;
+
+    Effect *e = &fx->pool[id];
+    int period   = EFFECT_TRAITS[kind].period;
+    e->kind      = (uint8_t)kind;
+    e->target    = (uint8_t)target;
+    e->used      = 1;
+    e->expires   = fx->now + turns;
+    e->next_tick = period ? fx->now + period : 0;
+    link_effect(fx, id);
+    apply_mods(fx, e, 1);
+    fx->count++;
+    return 1;
+}
+
+int effects_has(const Effects *fx, int target, EffectKind kind) {
+    return find(fx, target, kind) >= 0;
+}
+
+void effects_clear_target(Effects *fx, int target) {
+    for (int i = 0; i < MAX_EFFECTS; i++)
+        if (fx->pool[i].used && fx->pool[i].target == target) drop(fx, i);
+}
+
+void effects_clear_enemies(Effects *fx) {
+    for (int i = 0; i < MAX_EFFECTS; i++)
+        if (fx->pool[i].used && fx->pool[i].target != EFFECT_PLAYER) drop(fx, i);
+}
+
+// Fire everything filed under turn `turn`
+static int fire(Effects *fx, int turn, EffectFired *out, int max) {
+    int fired = 0;
+    int id = fx->slot[0][turn & WHEEL_MASK];
+    fx->slot[0][turn & WHEEL_MASK] = -1;
+    while (id >= 0) {
+        Effect *e = &fx->pool[id];
+        int next = e->next;
+        e->level = -1;
+        if (due(e) != turn) { // not ours after all; file it again
+            link_effect(fx, id);
+            id = next;
+            continue;
+        }
+        EffectFired f = { e->kind, e->target, 0, e->expires - turn };
+        if (e->next_tick == turn) {
+            f.hp = EFFECT_TRAITS[e->kind].hp;
+            e->next_tick += EFFECT_TRAITS[e->kind].period;
+        }
+        if (turn >= e->expires) {
+            apply_mods(fx, e, -1);
+            e->used = 0;
+            fx->count--;
+        } else {
+            link_effect(fx, id);
+        }
+        if (fired < max) out[fired++] = f;
+        id = next;
+    }
+    return fired;
+}
+
+// Bring the span starting at `turn` down to single turns
+static void cascade(Effects *fx, int turn) {
+    int at = (turn >> WHEEL_BITS) & WHEEL_MASK;
+    int id = fx->slot[1][at];
+    fx->slot[1][at] = -1;
+    while (id >= 0) {
+        int next = fx->pool[id].next;
+        fx->pool[id].level = -1;
+        link_effect(fx, id);
+        id = next;
+    }
+}
+
+int effects_advance(Effects *fx, int turn, EffectFired *out, int max) {
+    if (fx->count == 0 && turn > fx->now) fx->now = turn; // nothing to step through
+    int fired = 0;
+    while (fx->now < turn) {
+        fx->now++;
+        if ((fx->now & WHEEL_MASK) == 0) cascade(fx, fx->now);
+        fired += fire(fx, fx->now, out + fired, max - fired);
+    }
+    return fired;
+}
+
+int effects_speed(const Effects *fx, int target) {
+    int pct = 100 + fx->mods[target].speed;
+    return pct < 25 ? 25 : pct;
+}
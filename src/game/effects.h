@@ -0,0 +1,95 @@
+#ifndef EFFECTS_HEADER_H
+#define EFFECTS_HEADER_H
+
+#include <stdint.h>
+#include "enemy.h"
+
+// Timed status effects on the player and enemies. Each effect is one
+// timer, due at its next tick or its expiry, whichever comes first, on a
+// two-level timer wheel keyed by game turn: WHEEL_SLOTS turns one apiece,
+// then WHEEL_SLOTS spans of WHEEL_SLOTS turns that are cascaded down as
+// the turn reaches them. Advancing a turn only touches the effects that
+// fire (plus, once per span, those cascading), never every effect.
+//
+// The wheel knows nothing of hit points or messages: effects_advance
+// reports what fired and game_tick_effects applies it. Stat and speed
+// changes are summed per target in `mods` while the effects last.
+
+typedef enum {
+    EFFECT_POISON = 0,
+    EFFECT_BURN,
+    EFFECT_REGEN,
+    EFFECT_HASTE,
+    EFFECT_SLOW,
+    EFFECT_MIGHT, // attack up
+    EFFECT_WARD,  // defense up
+    EFFECT_KIND_COUNT
+} EffectKind;
+
+typedef struct {
+    const char *name;
+    int period;          // turns between ticks, 0 if it never ticks
+    int hp;              // per tick, negative to hurt
+    int speed;           // percent added to speed while it lasts
+    int attack, defense; // added while it lasts
+} EffectTraits;
+
+extern const EffectTraits EFFECT_TRAITS[EFFECT_KIND_COUNT];
+
+#define MAX_EFFECTS    32
+#define EFFECT_PLAYER  MAX_ENEMIES       // target id of the player; enemies are their index
+#define EFFECT_TARGETS (MAX_ENEMIES + 1)
+#define WHEEL_SLOTS    64
+#define EFFECT_MAX_TURNS (WHEEL_SLOTS * WHEEL_SLOTS - WHEEL_SLOTS) // longest the wheel can hold
+
+typedef struct {
+    uint8_t kind;      // EffectKind
+    uint8_t target;    // enemy index or EFFECT_PLAYER
+    uint8_t used;
+    int8_t  level;     // wheel level holding it, -1 if none
+    int16_t next, prev;
+    int     expires;   // last turn it is in force
+    int     next_tick; // turn of its next tick
+} Effect;
+
+typedef struct {
+    int attack, defense;
+    int speed; // percent added
+} EffectMods;
+
+typedef struct {
+    Effect     pool[MAX_EFFECTS];
+    int        count;
+    int16_t    slot[2][WHEEL_SLOTS]; // first effect due in each slot, -1 if none
+    int        now;                  // turn the wheel has advanced to
+    EffectMods mods[EFFECT_TARGETS];
+} Effects;
+
+// What an effect did on the turn it fired
+typedef struct {
+    uint8_t kind, target;
+    int     hp;         // change this turn, 0 if it did not tick
+    int     turns_left; // 0 once it has worn off
+} EffectFired;
+
+void effects_init(Effects *fx, int turn);
+
+// Put `kind` on `target` for `turns` turns from the wheel's turn, ticking
+// first on the next one. Renewing an effect the target already has only
+// extends it. Returns 1 if the effect is new (its mods now apply), 0 if
+// renewed, -1 if the pool is full.
+int  effects_add(Effects *fx, int target, EffectKind kind, int turns);
+int  effects_has(const Effects *fx, int target, EffectKind kind);
+// Drop every effect on `target` at once, e.g. when it dies
+void effects_clear_target(Effects *fx, int target);
+// Drop every effect on an enemy, e.g. on leaving the level
+void effects_clear_enemies(Effects *fx);
+
+// Move the wheel on to `turn`, writing up to `max` fired effects to
+// `out`. Returns how many fired.
+int  effects_advance(Effects *fx, int turn, EffectFired *out, int max);
+
+// Speed of `target` as a percent of its own, never below a quarter
+int  effects_speed(const Effects *fx, int target);
+
+#endif
@@ -0,0 +1,32 @@
+#include "enemy.h"
+
+const EnemyArchetype ENEMY_ARCHETYPES[ENEMY_TYPE_COUNT] = {
+    //                     name           hp  atk def    xp  score  gold  boss speed
+    [ENEMY_SKELETON]    = { "Skeleton",    10,  3,  0,    8,    10,  2,  4, 0, SPEED_NORMAL },
+    [ENEMY_GOBLIN]      = { "Goblin",      15,  4,  1,   10,    15,  3,  5, 0, SPEED_NORMAL },
+    [ENEMY_ZOMBIE]      = { "Zombie",      22,  6,  1,   14,    20,  4,  6, 0, SPEED_NORMAL / 2 },
+    [ENEMY_ORC]         = { "Orc",         25,  7,  2,   20,    30,  6,  8, 0, SPEED_NORMAL },
+    [ENEMY_TROLL]       = { "Troll",       40, 10,  4,   30,    50, 10, 10, 0, SPEED_NORMAL },
+    [ENEMY_GIANT]       = { "Giant",       60, 14,  6,   50,    80, 15, 15, 0, SPEED_NORMAL },
+    // Bosses drop an item instead of gold
+    [ENEMY_GOBLIN_KING] = { "Goblin King", 100, 15,  5,  200,  500,  0,  0, 1, SPEED_NORMAL },
+    [ENEMY_LICH_KING]   = { "Lich King",   200, 25, 10,  400, 1000,  0,  0, 1, SPEED_NORMAL },
+    [ENEMY_DEMON_LORD]  = { "Demon Lord",  350, 38, 15,  700, 2000,  0,  0, 1, SPEED_NORMAL },
+    [ENEMY_RED_DRAGON]  = { "Red Dragon",  500, 55, 22, 1200, 3500,  0,  0, 1, SPEED_NORMAL },
+    [ENEMY_TARRASQUE]   = { "Tarrasque",   800, 80, 35, 2000, 5000,  0,  0, 1, SPEED_NORMAL },
+};
+
+void enemy_spawn(EnemyPool *p, int i, EnemyType type, int x, int y) {
+    p->x[i]        = x;
+    p->y[i]        = y;
+    p->active[i]   = 1;
+    p->type[i]     = (uint8_t)type;
+    p->hp[i]       = ENEMY_ARCHETYPES[type].max_hp;
+    p->max_hp[i]   = ENEMY_ARCHETYPES[type].max_hp;
+    p->next_act[i] = 0;
+    p->awake[i]    = 0;
+}
+
+int enemy_act_delay(const EnemyPool *p, int i) {
+    return TURN_TICKS * SPEED_NORMAL / ENEMY_KIND(p, i)->speed;
+}
@@ -1,7 +1,10 @@
 #ifndef ENEMY_HEADER_H
 #define ENEMY_HEADER_H
 
+#include <stdint.h>
+
 #define MAX_ENEMIES 15
+#define ENEMY_NONE  -1 // no enemy, where an index is expected
 
 typedef enum {
     ENEMY_SKELETON = 0,
@@ -14,19 +17,48 @@ typedef enum {
     ENEMY_LICH_KING,
     ENEMY_DEMON_LORD,
     ENEMY_RED_DRAGON,
-    ENEMY_TARRASQUE
+    ENEMY_TARRASQUE,
+    ENEMY_TYPE_COUNT
 } EnemyType;
 
+// Time runs in ticks, TURN_TICKS per player turn. An enemy of speed
+// SPEED_NORMAL acts once a turn, one of half that every other turn.
+#define TURN_TICKS   100
+#define SPEED_NORMAL 100
+
+// What every enemy of a type shares, in one place. Adding an enemy
+// means an EnemyType value and a row in ENEMY_ARCHETYPES (enemy.c).
+typedef struct {
+    const char *name;
+    int max_hp;
+    int attack, defense;
+    int experience;
+    int score;               // for the kill, on top of any gold
+    int gold_min, gold_span; // gold_min + rand() % gold_span, none if no span
+    int is_boss;
+    int speed;               // SPEED_NORMAL for one action a turn
+} EnemyArchetype;
+
+extern const EnemyArchetype ENEMY_ARCHETYPES[ENEMY_TYPE_COUNT];
+
+// Every enemy on a level, one array per field, so the loops over them
+// (turn order, occupancy, area damage) touch only the fields they read.
+// An enemy is its index; what its type shares is ENEMY_KIND.
 typedef struct {
-    int       x, y;
-    int       active;
-    EnemyType type;
-    char      name[16];
-    int       hp, max_hp;
-    int       attack, defense;
-    int       experience;
-    int       move_timer;
-    int       is_boss;
-} Enemy;
-
-#endif
\ No newline at end of file
+    int     count;                 // slots in use, dead or alive
+    int     x[MAX_ENEMIES], y[MAX_ENEMIES];
+    int     hp[MAX_ENEMIES], max_hp[MAX_ENEMIES];
+    int     next_act[MAX_ENEMIES]; // tick of its next action while awake
+    uint8_t type[MAX_ENEMIES];     // EnemyType
+    uint8_t active[MAX_ENEMIES];
+    uint8_t awake[MAX_ENEMIES];    // simulated each turn; see game_wake_near_player
+} EnemyPool;
+
+#define ENEMY_KIND(p, i) (&ENEMY_ARCHETYPES[(p)->type[i]])
+
+// Make slot `i` of `p` a fresh, dormant enemy of `type` at full health
+void enemy_spawn(EnemyPool *p, int i, EnemyType type, int x, int y);
+// Ticks between one action of enemy `i` and its next
+int  enemy_act_delay(const EnemyPool *p, int i);
+
+#endif
@@ -0,0 +1,136 @@
+#include "events.h"
+#include "enemy.h"
+#include "effects.h"
+#include <stdio.h>
+#include <string.h>
+
+const char *const NOTES[NOTE_COUNT] = {
+    [NOTE_CLEAR_LEVEL]     = "Clear the level first!",
+    [NOTE_INVENTORY_FULL]  = "Inventory full!",
+    [NOTE_NOTHING_HERE]    = "Nothing to pick up",
+    [NOTE_SPELL_KNOWN]     = "Already know that spell",
+    [NOTE_SPELLS_FULL]     = "Cannot learn more spells",
+    [NOTE_CANNOT_USE]      = "Cannot use that item",
+    [NOTE_CANNOT_EQUIP]    = "Cannot equip that item",
+    [NOTE_NO_ROOM_TO_DROP] = "No room to drop item!",
+    [NOTE_NO_SPELL]        = "No spell equipped!",
+    [NOTE_NO_MP]           = "Not enough MP!",
+    [NOTE_AIM_FIRST]       = "Move first to aim!",
+    [NOTE_SPELL_MISSED]    = "Spell missed!",
+    [NOTE_NO_WEAPON]       = "No weapon equipped!",
+    [NOTE_NO_RANGED]       = "No ranged weapon equipped!",
+    [NOTE_ATTACK_MISSED]   = "Attack missed!",
+    [NOTE_NO_PATH]         = "No path there",
+    [NOTE_ENEMY_NEARBY]    = "Enemy nearby!",
+    [NOTE_NO_GOLD]         = "Not enough gold!",
+    [NOTE_NO_SHOP]         = "No shop nearby",
+};
+
+// Which fields an event's format takes, in order
+typedef enum {
+    ARGS_A,          // a
+    ARGS_NAME,       // name
+    ARGS_NAME_A,     // name, a
+    ARGS_ENEMY,      // enemy name
+    ARGS_ENEMY_A,    // enemy name, a
+    ARGS_NAME_ENEMY, // name, enemy name, a (if the format has it)
+    ARGS_EFFECT,     // effect name, a, b (if the format has them)
+    ARGS_ENEMY_DIED, // enemy name, effect name from a
+} EventArgs;
+
+typedef struct {
+    const char *format;
+    EventArgs   args;
+} EventFormat;
+
+static const EventFormat EVENT_FORMATS[EVENT_KIND_COUNT] = {
+    [EVENT_NOTE]        = { NULL,                       ARGS_A },
+    [EVENT_GOLD]        = { "Found %d gold!",           ARGS_A },
+    [EVENT_LOOT]        = { "%s dropped!",              ARGS_NAME },
+    [EVENT_PICK_UP]     = { "Picked up %s",             ARGS_NAME },
+    [EVENT_DROP]        = { "Dropped %s",               ARGS_NAME },
+    [EVENT_DRINK_HP]    = { "Drank %s +%d HP",          ARGS_NAME_A },
+    [EVENT_DRINK_MP]    = { "Drank %s +%d MP",          ARGS_NAME_A },
+    [EVENT_LEARN]       = { "Learned %s!",              ARGS_NAME },
+    [EVENT_EQUIP]       = { "Equipped %s",              ARGS_NAME },
+    [EVENT_BUY]         = { "Bought %s",                ARGS_NAME },
+    [EVENT_SELL]        = { "Sold %s for %d gold",      ARGS_NAME_A },
+    [EVENT_SPELL_HIT]   = { "%s hit %s: %d dmg",        ARGS_NAME_ENEMY },
+    [EVENT_SPELL_KILL]  = { "%s killed %s!",            ARGS_NAME_ENEMY },
+    [EVENT_SPELL_HEAL]  = { "Healed %d HP!",            ARGS_A },
+    [EVENT_FIREBALL]    = { "Fireball hit %d enemies!", ARGS_A },
+    [EVENT_SHOT_HIT]    = { "Attack hit %s: %d dmg",    ARGS_ENEMY_A },
+    [EVENT_SHOT_KILL]   = { "Attack killed %s!",        ARGS_ENEMY },
+    [EVENT_HIT]         = { "Hit %s: %d dmg",           ARGS_ENEMY_A },
+    [EVENT_KILL]        = { "Killed %s!",               ARGS_ENEMY },
+    [EVENT_HURT]        = { "%s: %d dmg",               ARGS_ENEMY_A },
+    [EVENT_TRAP_SPIKE]  = { "Spike trap! -%d HP",       ARGS_A },
+    [EVENT_TRAP_FIRE]   = { "Fire trap! -%d HP",        ARGS_A },
+    [EVENT_TRAP_POISON] = { "Poison trap! %d turns",    ARGS_A },
+    [EVENT_EFFECT_TICK] = { "%s! %d HP (%d left)",      ARGS_EFFECT },
+    [EVENT_EFFECT_END]  = { "%s wore off",              ARGS_EFFECT },
+    [EVENT_EFFECT_KILL] = { "%s died of %s",            ARGS_ENEMY_DIED },
+    [EVENT_LEVEL_UP]    = { "Level up! Now level %d",   ARGS_A },
+};
+
+void events_clear(EventLog *log) {
+    log->total = 0;
+}
+
+GameEvent *events_push(EventLog *log, EventKind kind, int turn) {
+    GameEvent *ev = &log->ring[log->total++ & (EVENT_LOG_SIZE - 1)];
+    memset(ev, 0, sizeof(*ev));
+    ev->kind = (unsigned char)kind;
+    ev->turn = turn;
+    return ev;
+}
+
+void event_set_name(GameEvent *ev, const char *name) {
+    strncpy(ev->name, name, EVENT_NAME_LEN - 1);
+}
+
+int events_count(const EventLog *log) {
+    return log->total < EVENT_LOG_SIZE ? (int)log->total : EVENT_LOG_SIZE;
+}
+
+const GameEvent *events_recent(const EventLog *log, int i) {
+    if (i < 0 || i >= events_count(log)) return NULL;
+    return &log->ring[(log->total - 1 - (unsigned)i) & (EVENT_LOG_SIZE - 1)];
+}
+
+// Names by id, with a stand-in for ids from a damaged save
+static const char *enemy_name(int type) {
+    return type < ENEMY_TYPE_COUNT ? ENEMY_ARCHETYPES[type].name : "?";
+}
+
+static const char *effect_name(int kind) {
+    return kind >= 0 && kind < EFFECT_KIND_COUNT ? EFFECT_TRAITS[kind].name : "?";
+}
+
+void event_format(const GameEvent *ev, char *buf, size_t len) {
+    if (ev->kind >= EVENT_KIND_COUNT) {
+        snprintf(buf, len, "?");
+        return;
+    }
+    if (ev->kind == EVENT_NOTE) {
+        snprintf(buf, len, "%s", ev->subject < NOTE_COUNT ? NOTES[ev->subject] : "?");
+        return;
+    }
+    const EventFormat *f = &EVENT_FORMATS[ev->kind];
+    switch (f->args) {
+        case ARGS_A:          snprintf(buf, len, f->format, ev->a); break;
+        case ARGS_NAME:       snprintf(buf, len, f->format, ev->name); break;
+        case ARGS_NAME_A:     snprintf(buf, len, f->format, ev->name, ev->a); break;
+        case ARGS_ENEMY:      snprintf(buf, len, f->format, enemy_name(ev->subject)); break;
+        case ARGS_ENEMY_A:    snprintf(buf, len, f->format, enemy_name(ev->subject), ev->a); break;
+        case ARGS_NAME_ENEMY:
+            snprintf(buf, len, f->format, ev->name, enemy_name(ev->subject), ev->a);
+            break;
+        case ARGS_EFFECT:
+            snprintf(buf, len, f->format, effect_name(ev->subject), ev->a, ev->b);
+            break;
+        case ARGS_ENEMY_DIED:
+            snprintf(buf, len, f->format, enemy_name(ev->subject), effect_name(ev->a));
+            break;
+    }
+}
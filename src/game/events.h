@@ -0,0 +1,101 @@
+#ifndef EVENTS_HEADER_H
+#define EVENTS_HEADER_H
+
+#include <stddef.h>
+
+// What happened in play, as typed records on a fixed ring: an event is
+// its kind and the ids and amounts it concerns, written in place with no
+// text made. event_format turns one into a line only when the message
+// bar (or anything else reading the log) shows it, so hits and kills
+// cost no string work on the turn, and the log doubles as a machine
+// readable record of the run.
+
+typedef enum {
+    EVENT_NOTE = 0,      // subject: NoteId
+    EVENT_GOLD,          // a: gold found
+    EVENT_LOOT,          // name: item an enemy dropped
+    EVENT_PICK_UP,       // name
+    EVENT_DROP,          // name
+    EVENT_DRINK_HP,      // name, a: hp
+    EVENT_DRINK_MP,      // name, a: mp
+    EVENT_LEARN,         // name: spell
+    EVENT_EQUIP,         // name
+    EVENT_BUY,           // name
+    EVENT_SELL,          // name, a: price
+    EVENT_SPELL_HIT,     // name: spell, subject: EnemyType, a: damage
+    EVENT_SPELL_KILL,    // name: spell, subject: EnemyType
+    EVENT_SPELL_HEAL,    // a: hp
+    EVENT_FIREBALL,      // a: enemies hit
+    EVENT_SHOT_HIT,      // subject: EnemyType, a: damage
+    EVENT_SHOT_KILL,     // subject: EnemyType
+    EVENT_HIT,           // subject: EnemyType, a: damage
+    EVENT_KILL,          // subject: EnemyType
+    EVENT_HURT,          // subject: EnemyType that hit the player, a: damage
+    EVENT_TRAP_SPIKE,    // a: damage
+    EVENT_TRAP_FIRE,     // a: damage
+    EVENT_TRAP_POISON,   // a: turns
+    EVENT_EFFECT_TICK,   // subject: EffectKind, a: hp, b: turns left
+    EVENT_EFFECT_END,    // subject: EffectKind
+    EVENT_EFFECT_KILL,   // subject: EnemyType, a: EffectKind
+    EVENT_LEVEL_UP,      // a: new level
+    EVENT_KIND_COUNT
+} EventKind;
+
+// Fixed lines, for EVENT_NOTE
+typedef enum {
+    NOTE_CLEAR_LEVEL = 0,
+    NOTE_INVENTORY_FULL,
+    NOTE_NOTHING_HERE,
+    NOTE_SPELL_KNOWN,
+    NOTE_SPELLS_FULL,
+    NOTE_CANNOT_USE,
+    NOTE_CANNOT_EQUIP,
+    NOTE_NO_ROOM_TO_DROP,
+    NOTE_NO_SPELL,
+    NOTE_NO_MP,
+    NOTE_AIM_FIRST,
+    NOTE_SPELL_MISSED,
+    NOTE_NO_WEAPON,
+    NOTE_NO_RANGED,
+    NOTE_ATTACK_MISSED,
+    NOTE_NO_PATH,
+    NOTE_ENEMY_NEARBY,
+    NOTE_NO_GOLD,
+    NOTE_NO_SHOP,
+    NOTE_COUNT
+} NoteId;
+
+extern const char *const NOTES[NOTE_COUNT];
+
+#define EVENT_LOG_SIZE 64 // a power of two
+#define EVENT_NAME_LEN 20
+
+typedef struct {
+    unsigned char kind;    // EventKind
+    unsigned char subject; // see EventKind
+    int  a, b;
+    int  turn;
+    char name[EVENT_NAME_LEN]; // item or spell, cut short if need be
+} GameEvent;
+
+typedef struct {
+    GameEvent ring[EVENT_LOG_SIZE];
+    unsigned  total; // events ever pushed; the newest is at total - 1
+} EventLog;
+
+void events_clear(EventLog *log);
+
+// Claim the next record, overwriting the oldest once the ring is full.
+// It comes back zeroed but for `kind` and `turn`, for the caller to fill.
+GameEvent *events_push(EventLog *log, EventKind kind, int turn);
+void       event_set_name(GameEvent *ev, const char *name);
+
+// How many events the ring still holds, and the `i`th most recent of
+// them (0 the newest), NULL past the end
+int              events_count(const EventLog *log);
+const GameEvent *events_recent(const EventLog *log, int i);
+
+// The line for an event, as the message bar shows it
+void event_format(const GameEvent *ev, char *buf, size_t len);
+
+#endif
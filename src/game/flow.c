@@ -0,0 +1,62 @@
+#include "flow.h"
+#include <string.h>
+
+#define BOX_SIDE (2 * FLOW_RADIUS + 1)
+
+static const int DIRS[8][2] = {
+    { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+    { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 }
+};
+
+void flow_init(FlowField *f) {
+    memset(f->dist, FLOW_UNREACHED, sizeof(f->dist));
+    f->x = f->y = -1;
+    f->x0 = f->y0 = f->x1 = f->y1 = 0;
+}
+
+void flow_invalidate(FlowField *f) {
+    for (int y = f->y0; y < f->y1; y++)
+        memset(&f->dist[y][f->x0], FLOW_UNREACHED, f->x1 - f->x0);
+    f->x = f->y = -1;
+    f->x0 = f->y0 = f->x1 = f->y1 = 0;
+}
+
+int flow_update(FlowField *f, const Map *m, int x, int y) {
+    if (f->x == x && f->y == y) return 0;
+    flow_invalidate(f);
+    if (!map_is_walkable(m, x, y)) return 1;
+
+    f->x  = x;
+    f->y  = y;
+    f->x0 = x - FLOW_RADIUS < 0 ? 0 : x - FLOW_RADIUS;
+    f->y0 = y - FLOW_RADIUS < 0 ? 0 : y - FLOW_RADIUS;
+    f->x1 = x + FLOW_RADIUS + 1 > m->w ? m->w : x + FLOW_RADIUS + 1;
+    f->y1 = y + FLOW_RADIUS + 1 > m->h ? m->h : y + FLOW_RADIUS + 1;
+
+    // Every tile within FLOW_RADIUS steps lies inside the box, so the
+    // box bounds the queue as well as the search
+    uint16_t queue[BOX_SIDE * BOX_SIDE];
+    int head = 0, tail = 0;
+    f->dist[y][x] = 0;
+    queue[tail++] = (uint16_t)(y * MAP_W + x);
+    while (head < tail) {
+        int cx = queue[head] % MAP_W, cy = queue[head] / MAP_W;
+        head++;
+        int d = f->dist[cy][cx];
+        if (d == FLOW_RADIUS) continue;
+        for (int k = 0; k < 8; k++) {
+            int nx = cx + DIRS[k][0], ny = cy + DIRS[k][1];
+            if (nx < f->x0 || nx >= f->x1 || ny < f->y0 || ny >= f->y1) continue;
+            if (f->dist[ny][nx] != FLOW_UNREACHED) continue;
+            if (!TILE_HAS(m->tiles[ny][nx], TRAIT_WALKABLE)) continue;
+            f->dist[ny][nx] = (uint8_t)(d + 1);
+            queue[tail++] = (uint16_t)(ny * MAP_W + nx);
+        }
+    }
+    return 1;
+}
+
+int flow_dist(const FlowField *f, int x, int y) {
+    if (x < f->x0 || x >= f->x1 || y < f->y0 || y >= f->y1) return FLOW_UNREACHED;
+    return f->dist[y][x];
+}
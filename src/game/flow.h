@@ -0,0 +1,31 @@
+#ifndef FLOW_HEADER_H
+#define FLOW_HEADER_H
+
+#include <stdint.h>
+#include "map.h"
+
+// Steps from every walkable tile near the player to the player, moving
+// the way enemies do (8 directions), by one breadth-first pass out to
+// FLOW_RADIUS. Enemies read their next step off it instead of each
+// finding a path, so chasing costs one field per player move however
+// many enemies there are. Only the box around the origin is ever
+// written, and cleared again before the next pass.
+
+#define FLOW_RADIUS    40
+#define FLOW_UNREACHED 0xFF // farther than FLOW_RADIUS, walled off, or a wall
+
+typedef struct {
+    uint8_t dist[MAP_H][MAP_W];
+    int     x, y;           // origin, -1 if the field is stale
+    int     x0, y0, x1, y1; // box the field covers, [x0, x1) x [y0, y1)
+} FlowField;
+
+void flow_init(FlowField *f);
+// Drop the field, e.g. because the map it was built on was replaced
+void flow_invalidate(FlowField *f);
+// Rebuild the field toward (x, y) unless it already leads there.
+// Returns 1 if it was rebuilt.
+int  flow_update(FlowField *f, const Map *m, int x, int y);
+int  flow_dist(const FlowField *f, int x, int y);
+
+#endif
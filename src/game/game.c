@@ -5,201 +5,84 @@
 #include <string.h>
 #include <stdio.h>
 #include "../game/actions.h"
+#include "pregen.h"
+#include "room_index.h"
 
-static void spawn_enemy(Enemy *e, EnemyType type, int x, int y) {
-    e->active  = 1;
-    e->type    = type;
-    e->x       = x;
-    e->y       = y;
-switch (type) {
-        case ENEMY_SKELETON:
-            strncpy(e->name, "Skeleton", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 10; e->hp = 10;
-            e->attack = 3;  e->defense = 0;
-            e->experience = 8;
-            break;
-        case ENEMY_GOBLIN:
-            strncpy(e->name, "Goblin", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 15; e->hp = 15;
-            e->attack = 4;  e->defense = 1;
-            e->experience = 10;
-            break;
-        case ENEMY_ZOMBIE:
-            strncpy(e->name, "Zombie", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 22; e->hp = 22;
-            e->attack = 6;  e->defense = 1;
-            e->experience = 14;
-            e->move_timer = 0;
-            break;
-        case ENEMY_ORC:
-            strncpy(e->name, "Orc", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 25; e->hp = 25;
-            e->attack = 7;  e->defense = 2;
-            e->experience = 20;
-            break;
-        case ENEMY_TROLL:
-            strncpy(e->name, "Troll", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 40; e->hp = 40;
-            e->attack = 10; e->defense = 4;
-            e->experience = 30;
-            break;
-        case ENEMY_GIANT:
-            strncpy(e->name, "Giant", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 60; e->hp = 60;
-            e->attack = 14; e->defense = 6;
-            e->experience = 50;
-            break;
-        case ENEMY_GOBLIN_KING:
-            strncpy(e->name, "Goblin King", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 100; e->hp = 100;
-            e->attack = 15;  e->defense = 5;
-            e->experience = 200;
-            e->is_boss = 1;
-            break;
-        case ENEMY_LICH_KING:
-            strncpy(e->name, "Lich King", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 200; e->hp = 200;
-            e->attack = 25;  e->defense = 10;
-            e->experience = 400;
-            e->is_boss = 1;
-            break;
-        case ENEMY_DEMON_LORD:
-            strncpy(e->name, "Demon Lord", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 350; e->hp = 350;
-            e->attack = 38;  e->defense = 15;
-            e->experience = 700;
-            e->is_boss = 1;
-            break;
-        case ENEMY_RED_DRAGON:
-            strncpy(e->name, "Red Dragon", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 500; e->hp = 500;
-            e->attack = 55;  e->defense = 22;
-            e->experience = 1200;
-            e->is_boss = 1;
-            break;
-        case ENEMY_TARRASQUE:
-            strncpy(e->name, "Tarrasque", sizeof(e->name) - 1);
-            e->name[sizeof(e->name) - 1] = '\0';
-            e->max_hp = 800; e->hp = 800;
-            e->attack = 80;  e->defense = 35;
-            e->experience = 2000;
-            e->is_boss = 1;
-            break;
+#define TRAVEL_ALERT_RANGE 6 // walks stop when an enemy is this close
+#define WAKE_RADIUS        8 // enemies this close to the player wake up
+
+// Catch-up for cached levels, see level_catch_up
+#define REGEN_TURNS     10  // an enemy left alone heals 1 HP per this many turns
+#define WANDER_TURNS    4   // and drifts one step toward the stairs per this many
+#define STAIRS_GAP      2   // drifting stops this many steps short of the stairs
+#define RESPAWN_TURNS   300 // a cleared level gains one enemy per this many turns
+
+void enemies_spawn(GameState *g) {
+    Rng rng;
+    rng_seed(&rng, (uint64_t)rand());
+    enemies_spawn_level(&g->map, g->level, &g->enemies, &rng);
+}
+
+static EnemyType roll_enemy_type(int level, Rng *rng) {
+    int roll = rng_below(rng, 100);
+
+    if (level <= 2) {
+        return roll < 60 ? ENEMY_SKELETON : ENEMY_GOBLIN;
+    } else if (level <= 4) {
+        if (roll < 30)      return ENEMY_SKELETON;
+        else if (roll < 70) return ENEMY_GOBLIN;
+        else                return ENEMY_ZOMBIE;
+    } else if (level <= 6) {
+        if (roll < 20)      return ENEMY_GOBLIN;
+        else if (roll < 60) return ENEMY_ZOMBIE;
+        else                return ENEMY_ORC;
+    } else if (level <= 8) {
+        if (roll < 20)      return ENEMY_ZOMBIE;
+        else if (roll < 60) return ENEMY_ORC;
+        else                return ENEMY_TROLL;
+    } else if (level <= 10) {
+        if (roll < 20)      return ENEMY_ORC;
+        else if (roll < 60) return ENEMY_TROLL;
+        else                return ENEMY_GIANT;
     }
+    return roll < 50 ? ENEMY_TROLL : ENEMY_GIANT;
 }
 
-// static void spawn_boss(GameState *g) {
-
-//     // Find room containing stairs down
-//     int stair_room = 0;
-//     for (int i = 0; i < g->map.room_count; i++) {
-//         Room *room = &g->map.rooms[i];
-//         if (g->map.stairs_down_x >= room->x &&
-//             g->map.stairs_down_x < room->x + room->w &&
-//             g->map.stairs_down_y >= room->y &&
-//             g->map.stairs_down_y < room->y + room->h) {
-//             stair_room = i;
-//             break;
-//         }
-//     }
-//     Room *room = &g->map.rooms[stair_room];
-//     int bx = room->x + room->w / 2;
-//     int by = room->y + room->h / 2;
-
-//     EnemyType type;
-//     switch (g->level) {
-//         case 5:  type = ENEMY_GOBLIN_KING; break;
-//         case 10: type = ENEMY_LICH_KING;   break;
-//         case 15: type = ENEMY_DEMON_LORD;  break;
-//         case 20: type = ENEMY_RED_DRAGON;  break;
-//         case 25: type = ENEMY_TARRASQUE;   break;
-//         default: return;
-//     }
-
-//     #ifdef DEBUG
-//     printf("DEBUG spawn_boss: level=%d type=%d at (%d,%d)\n",
-//         g->level, type, bx, by);
-//     #endif
-
-//     int idx = g->enemy_count;
-//     if (idx >= MAX_ENEMIES) return;
-//     spawn_enemy(&g->enemies[idx], type, bx, by);
-//     g->enemy_count++;
-// }
+static int is_boss_level(int level) {
+    return level == 5 || level == 10 || level == 15 || level == 20 || level == 25;
+}
 
-void enemies_spawn(GameState *g) {
-    g->enemy_count = 0;
-    if (g->map.room_count == 0) return;
+// Regular monsters a level starts with, leaving a slot for the boss now
+// that every regular spawn lands
+static int regular_enemy_count(int level) {
+    int count = 10 + level;
+    int cap   = is_boss_level(level) ? MAX_ENEMIES - 1 : MAX_ENEMIES;
+    return count < cap ? count : cap;
+}
 
-    int num_enemies = 10 + g->level;
-    if (num_enemies > MAX_ENEMIES) num_enemies = MAX_ENEMIES;
+void enemies_spawn_level(const Map *m, int level, EnemyPool *enemies, Rng *rng) {
+    RoomIndex ri;
+    room_index_build(&ri, m);
+    enemies->count = 0;
 
-    for (int i = 0; i < num_enemies; i++) {
-        int room_idx = rand() % (g->map.room_count - 1) + 1;
-        if (room_idx >= g->map.room_count) room_idx = 0;
-        Room *room = &g->map.rooms[room_idx];
-        if (room->w < 3 || room->h < 3) continue;
-        int ex = room->x + 1 + rand() % (room->w - 2);
-        int ey = room->y + 1 + rand() % (room->h - 2);
-        if (!map_is_walkable(&g->map, ex, ey)) continue;
-
-        // Check no other enemy already occupies this tile
-        int occupied = 0;
-        for (int j = 0; j < i; j++) {
-            if (g->enemies[j].active &&
-                g->enemies[j].x == ex &&
-                g->enemies[j].y == ey) {
-                occupied = 1;
-                break;
-            }
-        }
-        if (occupied) continue;
-
-        EnemyType type;
-        int roll = rand() % 100;
-        int level = g->level;
-
-        if (level <= 2) {
-            type = roll < 60 ? ENEMY_SKELETON : ENEMY_GOBLIN;
-        } else if (level <= 4) {
-            if (roll < 30)      type = ENEMY_SKELETON;
-            else if (roll < 70) type = ENEMY_GOBLIN;
-            else                type = ENEMY_ZOMBIE;
-        } else if (level <= 6) {
-            if (roll < 20)      type = ENEMY_GOBLIN;
-            else if (roll < 60) type = ENEMY_ZOMBIE;
-            else                type = ENEMY_ORC;
-        } else if (level <= 8) {
-            if (roll < 20)      type = ENEMY_ZOMBIE;
-            else if (roll < 60) type = ENEMY_ORC;
-            else                type = ENEMY_TROLL;
-        } else if (level <= 10) {
-            if (roll < 20)      type = ENEMY_ORC;
-            else if (roll < 60) type = ENEMY_TROLL;
-            else                type = ENEMY_GIANT;
-        } else {
-            type = roll < 50 ? ENEMY_TROLL : ENEMY_GIANT;
-        }
+    int boss_level = is_boss_level(level);
+
+    // A lair vault marks where the boss waits; keep the spot clear
+    int lair = boss_level && room_index_claim(&ri, m->lair_x, m->lair_y);
+
+    int num_enemies = regular_enemy_count(level);
 
-        spawn_enemy(&g->enemies[i], type, ex, ey);
-        g->enemy_count++;
+    // Keep out of room 0 (player arrives there) while other rooms have space
+    for (int i = 0; i < num_enemies; i++) {
+        int ex, ey;
+        if (!room_index_take_any(&ri, 1, rng, &ex, &ey)) break;
+        enemy_spawn(enemies, enemies->count++, roll_enemy_type(level, rng), ex, ey);
     }
-    // Spawn boss on boss levels in a random walkable tile
-    if (g->level == 5  || g->level == 10 || g->level == 15 ||
-        g->level == 20 || g->level == 25) {
-        if (g->enemy_count < MAX_ENEMIES) {
+    // Spawn boss on boss levels in its lair, or a random free tile of any room
+    if (boss_level) {
+        if (enemies->count < MAX_ENEMIES) {
             EnemyType boss_type;
-            switch (g->level) {
+            switch (level) {
                 case 5:  boss_type = ENEMY_GOBLIN_KING; break;
                 case 10: boss_type = ENEMY_LICH_KING;   break;
                 case 15: boss_type = ENEMY_DEMON_LORD;  break;
@@ -207,21 +90,13 @@ void enemies_spawn(GameState *g) {
                 case 25: boss_type = ENEMY_TARRASQUE;   break;
                 default: boss_type = ENEMY_GOBLIN_KING; break;
             }
-            // Try to place boss in a walkable tile in any room
-            for (int attempt = 0; attempt < 100; attempt++) {
-                int room_idx = rand() % g->map.room_count;
-                Room *room = &g->map.rooms[room_idx];
-                if (room->w < 3 || room->h < 3) continue;
-                int bx = room->x + 1 + rand() % (room->w - 2);
-                int by = room->y + 1 + rand() % (room->h - 2);
-                if (!map_is_walkable(&g->map, bx, by)) continue;
-                spawn_enemy(&g->enemies[g->enemy_count], boss_type, bx, by);
-                g->enemy_count++;
+            int bx = m->lair_x, by = m->lair_y;
+            if (lair || room_index_take_any(&ri, 0, rng, &bx, &by)) {
+                enemy_spawn(enemies, enemies->count++, boss_type, bx, by);
                 #ifdef DEBUG
                 printf("DEBUG boss spawned: type=%d at (%d,%d)\n",
                     boss_type, bx, by);
                 #endif
-                break;
             }
         }
     }
@@ -230,11 +105,16 @@ void enemies_spawn(GameState *g) {
 void game_init(GameState *g) {
     srand((unsigned)time(NULL));
     g->level = 1;
-    for (int i = 0; i < MAX_DEPTH; i++)
-        g->level_cache[i].valid = 0;
-    g->message_count = 0;
+    level_store_init(&g->levels);
+    flow_init(&g->flow);
+    senses_init(&g->senses);
+    aoe_init();
+    events_clear(&g->events);
     g->level_cleared = 0;
     g->max_level_reached = 1;
+    g->turn = 0;
+    g->clock = 0;
+    effects_init(&g->effects, g->turn);
     g->location = LOCATION_TOWN;
     int spawn_x, spawn_y;
     map_generate_town(&g->map, &spawn_x, &spawn_y);
@@ -261,7 +141,6 @@ void game_init(GameState *g) {
     g->player.equipped_spell = -1;
     g->player.last_dx = 0;
     g->player.last_dy = 0;
-    g->player.poison_turns = 0;
     g->trail_count = 0;
     g->trail_frames = 0;
 
@@ -294,6 +173,207 @@ void game_init(GameState *g) {
 
     // Spawn enemies in random rooms
     enemies_spawn(g);
+
+    game_refresh_regions(g);
+    game_refresh_occupancy(g);
+
+    // A new game always enters the dungeon at a fresh level 1
+    pregen_request(1);
+}
+
+void game_free(GameState *g) {
+    level_store_clear(&g->levels);
+}
+
+void game_refresh_regions(GameState *g) {
+    regions_build(&g->regions, &g->map);
+    bitgrid_from_map(&g->open, &g->map);
+    senses_init(&g->senses);
+    flow_invalidate(&g->flow);
+    game_travel_cancel(g);
+}
+
+void game_refresh_occupancy(GameState *g) {
+    const EnemyPool *p = &g->enemies;
+    occupancy_build(&g->occupancy, p);
+    g->enemies_alive    = 0;
+    g->enemy_free_count = 0;
+    schedule_init(&g->schedule);
+    effects_clear_enemies(&g->effects);
+    for (int i = p->count - 1; i >= 0; i--) {
+        if (!p->active[i]) {
+            g->enemy_free[g->enemy_free_count++] = (uint16_t)i;
+            continue;
+        }
+        g->enemies_alive++;
+        if (p->awake[i]) schedule_add(&g->schedule, i, p->next_act[i]);
+    }
+    g->wake_x    = -1; // look around again on the next turn
+    g->wake_room = -1;
+}
+
+int game_spawn_enemy(GameState *g, EnemyType type, int x, int y) {
+    int i;
+    if (g->enemy_free_count > 0) i = g->enemy_free[--g->enemy_free_count];
+    else if (g->enemies.count < MAX_ENEMIES) i = g->enemies.count++;
+    else return ENEMY_NONE;
+    enemy_spawn(&g->enemies, i, type, x, y);
+    occupancy_move(&g->occupancy, &g->enemies, i, -1, -1);
+    g->enemies_alive++;
+    return i;
+}
+
+void game_kill_enemy(GameState *g, int i) {
+    occupancy_remove(&g->occupancy, &g->enemies, i);
+    g->enemies.active[i] = 0;
+    schedule_remove(&g->schedule, i);
+    effects_clear_target(&g->effects, i);
+    g->enemy_free[g->enemy_free_count++] = (uint16_t)i;
+    if (--g->enemies_alive == 0) g->level_cleared = 1;
+}
+
+void game_apply_effect(GameState *g, int target, EffectKind kind, int turns) {
+    if (effects_add(&g->effects, target, kind, turns) != 1 || target != EFFECT_PLAYER)
+        return;
+    // The player's stats carry buffs the way they carry equipment
+    g->player.attack  += EFFECT_TRAITS[kind].attack;
+    g->player.defense += EFFECT_TRAITS[kind].defense;
+}
+
+static void effect_on_player(GameState *g, const EffectFired *f) {
+    const EffectTraits *t = &EFFECT_TRAITS[f->kind];
+    if (f->hp < 0) {
+        g->player.hp += f->hp;
+        GameEvent *ev = game_log(g, EVENT_EFFECT_TICK);
+        ev->subject = f->kind;
+        ev->a       = f->hp;
+        ev->b       = f->turns_left;
+    } else if (f->hp > 0) {
+        g->player.hp += f->hp;
+        if (g->player.hp > g->player.max_hp) g->player.hp = g->player.max_hp;
+    }
+    if (f->turns_left == 0) {
+        g->player.attack  -= t->attack;
+        g->player.defense -= t->defense;
+        if (!t->period) game_log(g, EVENT_EFFECT_END)->subject = f->kind;
+    }
+}
+
+static void effect_on_enemy(GameState *g, const EffectFired *f) {
+    EnemyPool *p = &g->enemies;
+    int i = f->target;
+    if (i >= p->count || !p->active[i] || f->hp == 0) return;
+    p->hp[i] += f->hp;
+    if (p->hp[i] > p->max_hp[i]) p->hp[i] = p->max_hp[i];
+    if (p->hp[i] > 0) return;
+    game_kill_enemy(g, i);
+    player_gain_xp(g, ENEMY_KIND(p, i)->experience);
+    GameEvent *ev = game_log(g, EVENT_EFFECT_KILL);
+    ev->subject = p->type[i];
+    ev->a       = f->kind;
+}
+
+void game_tick_effects(GameState *g) {
+    EffectFired fired[MAX_EFFECTS];
+    int n = effects_advance(&g->effects, g->turn, fired, MAX_EFFECTS);
+    for (int k = 0; k < n; k++) {
+        if (fired[k].target == EFFECT_PLAYER) effect_on_player(g, &fired[k]);
+        else effect_on_enemy(g, &fired[k]);
+    }
+}
+
+void game_wake_enemy(GameState *g, int i) {
+    EnemyPool *p = &g->enemies;
+    if (!p->active[i] || p->awake[i]) return;
+    p->awake[i]    = 1;
+    p->next_act[i] = g->clock; // acts on the enemy turn under way or the next
+    schedule_add(&g->schedule, i, p->next_act[i]);
+}
+
+void game_wake_near_player(GameState *g) {
+    int px = g->player.x, py = g->player.y;
+    if (px == g->wake_x && py == g->wake_y) return;
+    g->wake_x = px;
+    g->wake_y = py;
+
+    for (int y = py - WAKE_RADIUS; y <= py + WAKE_RADIUS; y++)
+        for (int x = px - WAKE_RADIUS; x <= px + WAKE_RADIUS; x++) {
+            int i = game_enemy_at(g, x, y);
+            if (i != ENEMY_NONE && !g->enemies.awake[i] &&
+                regions_same(&g->regions, x, y, px, py))
+                game_wake_enemy(g, i);
+        }
+
+    int room = map_room_at(&g->map, px, py);
+    if (room < 0 || room == g->wake_room) {
+        g->wake_room = room;
+        return;
+    }
+    g->wake_room = room;
+    const Room *r = &g->map.rooms[room];
+    for (int y = r->y; y < r->y + r->h; y++)
+        for (int x = r->x; x < r->x + r->w; x++) {
+            int i = game_enemy_at(g, x, y);
+            if (i != ENEMY_NONE) game_wake_enemy(g, i);
+        }
+}
+
+void game_wake_on_noise(GameState *g) {
+    if (!g->senses.fresh) return;
+    const EnemyPool *p = &g->enemies;
+    for (int i = 0; i < p->count; i++)
+        if (p->active[i] && !p->awake[i] && senses_heard(&g->senses, p->x[i], p->y[i]))
+            game_wake_enemy(g, i);
+}
+
+int game_enemy_at(const GameState *g, int x, int y) {
+    return occupancy_at(&g->occupancy, &g->enemies, x, y);
+}
+
+int game_travel_to(GameState *g, int x, int y) {
+    g->travel_step = 0;
+    if (path_find(&g->map, g->player.x, g->player.y, x, y, &g->travel) < 0) {
+        g->travel.len = 0;
+        game_note(g, NOTE_NO_PATH);
+        return -1;
+    }
+    return g->travel.len;
+}
+
+void game_travel_cancel(GameState *g) {
+    g->travel.len  = 0;
+    g->travel_step = 0;
+}
+
+static int enemy_near(const GameState *g) {
+    const EnemyPool *p = &g->enemies;
+    for (int i = 0; i < p->count; i++) {
+        if (!p->active[i]) continue;
+        if (abs(p->x[i] - g->player.x) > TRAVEL_ALERT_RANGE ||
+            abs(p->y[i] - g->player.y) > TRAVEL_ALERT_RANGE) continue;
+        if (regions_same(&g->regions, p->x[i], p->y[i], g->player.x, g->player.y))
+            return 1;
+    }
+    return 0;
+}
+
+Action game_travel_step(GameState *g) {
+    Action a = {ACTION_NONE, 0, 0};
+    if (g->travel_step >= g->travel.len) return a;
+
+    int nx = g->travel.cells[g->travel_step] % MAP_W;
+    int ny = g->travel.cells[g->travel_step] / MAP_W;
+    if (abs(nx - g->player.x) + abs(ny - g->player.y) != 1) {
+        game_travel_cancel(g);
+        return a;
+    }
+    if (enemy_near(g)) {
+        game_note(g, NOTE_ENEMY_NEARBY);
+        game_travel_cancel(g);
+        return a;
+    }
+    g->travel_step++;
+    return (Action){ACTION_MOVE, nx, ny};
 }
 
 void game_move_player(GameState *g, int dx, int dy) {
@@ -304,98 +384,233 @@ void game_move_player(GameState *g, int dx, int dy) {
     g->player.y = ny;
 }
 
-void game_descend(GameState *g) {
-    if (g->level >= 1 && g->level <= MAX_DEPTH) {
-        g->level_cache[g->level - 1].map         = g->map;
-        g->level_cache[g->level - 1].enemy_count = g->enemy_count;
-        for (int i = 0; i < g->enemy_count; i++)
-            g->level_cache[g->level - 1].enemies[i] = g->enemies[i];
-        g->level_cache[g->level - 1].valid = 1;
-        g->level_cache[g->level - 1].level_cleared = g->level_cleared;
+// Copy the current level into the level store. Only the level's bounded
+// tile area is copied (see map_copy).
+static void level_cache_store(GameState *g) {
+    if (g->level < 1 || g->level > MAX_DEPTH) return;
+    LevelCache *c = level_store_put(&g->levels, g->level);
+    map_copy(&c->map, &g->map);
+    c->enemies       = g->enemies;
+    c->level_cleared = g->level_cleared;
+    c->left_turn = g->turn;
+}
+
+// Returns the number of turns the level sat in the store
+static int level_cache_load(GameState *g) {
+    const LevelCache *c = level_store_get(&g->levels, g->level);
+    map_copy(&g->map, &c->map);
+    g->enemies       = c->enemies;
+    g->level_cleared = c->level_cleared;
+    return g->turn - c->left_turn;
+}
+
+static int tile_taken(GameState *g, int x, int y) {
+    if (abs(x - g->player.x) <= 1 && abs(y - g->player.y) <= 1) return 1;
+    return game_enemy_at(g, x, y) != ENEMY_NONE;
+}
+
+#define DRIFT_UNREACHED UINT16_MAX
+
+// Steps from every tile to the player on the stairs, 4-connected the way
+// path_find walks, filled by one breadth-first pass that every drifting
+// enemy then reads. Game thread only, like path_find's scratch.
+static uint16_t drift_dist[MAP_H][MAP_W];
+
+static const int DRIFT_STEPS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+static void drift_field_build(const Map *m, int x, int y) {
+    static uint16_t queue[MAP_W * MAP_H];
+    for (int row = 0; row < m->h; row++)
+        memset(drift_dist[row], 0xFF, sizeof(drift_dist[row][0]) * m->w);
+    if (!map_is_walkable(m, x, y)) return;
+    int head = 0, tail = 0;
+    drift_dist[y][x] = 0;
+    queue[tail++] = (uint16_t)(y * MAP_W + x);
+    while (head < tail) {
+        int cx = queue[head] % MAP_W, cy = queue[head] / MAP_W;
+        head++;
+        for (int k = 0; k < 4; k++) {
+            int nx = cx + DRIFT_STEPS[k][0], ny = cy + DRIFT_STEPS[k][1];
+            if (nx < 0 || nx >= m->w || ny < 0 || ny >= m->h) continue;
+            if (drift_dist[ny][nx] != DRIFT_UNREACHED) continue;
+            if (!TILE_HAS(m->tiles[ny][nx], TRAIT_WALKABLE)) continue;
+            drift_dist[ny][nx] = (uint16_t)(drift_dist[cy][cx] + 1);
+            queue[tail++] = (uint16_t)(ny * MAP_W + nx);
+        }
+    }
+}
+
+// Move enemy `i` as far down the drift field as it could have wandered
+// in `elapsed` turns, stopping short of the stairs and of tiles already
+// taken
+static void drift_toward_player(GameState *g, int i, int elapsed) {
+    EnemyPool *p = &g->enemies;
+    int steps = elapsed / WANDER_TURNS * ENEMY_KIND(p, i)->speed / SPEED_NORMAL;
+    int x = p->x[i], y = p->y[i];
+    int d = drift_dist[y][x];
+    if (d == DRIFT_UNREACHED) return;
+    if (steps > d - STAIRS_GAP) steps = d - STAIRS_GAP;
+    int to_x = x, to_y = y;
+    for (int s = 0; s < steps; s++) {
+        for (int k = 0; k < 4; k++) {
+            int nx = x + DRIFT_STEPS[k][0], ny = y + DRIFT_STEPS[k][1];
+            if (nx < 0 || nx >= g->map.w || ny < 0 || ny >= g->map.h) continue;
+            if (drift_dist[ny][nx] != d - 1) continue;
+            x = nx;
+            y = ny;
+            d--;
+            break;
+        }
+        if (!tile_taken(g, x, y)) {
+            to_x = x;
+            to_y = y;
+        }
     }
+    if (to_x == p->x[i] && to_y == p->y[i]) return;
+    int from_x = p->x[i], from_y = p->y[i];
+    p->x[i] = to_x;
+    p->y[i] = to_y;
+    occupancy_move(&g->occupancy, p, i, from_x, from_y);
+}
+
+// Refill a cleared level with regular monsters, one per RESPAWN_TURNS
+// away, up to half its original count. The stairs stay open.
+static void respawn_enemies(GameState *g, int elapsed, Rng *rng) {
+    int want = elapsed / RESPAWN_TURNS, room = regular_enemy_count(g->level) / 2 - g->enemies_alive;
+    if (want > room) want = room;
+
+    RoomIndex ri;
+    room_index_build(&ri, &g->map);
+    for (int i = 0; i < g->enemies.count; i++)
+        if (g->enemies.active[i])
+            room_index_claim(&ri, g->enemies.x[i], g->enemies.y[i]);
+    while (want > 0) {
+        int x, y;
+        if (!room_index_take_any(&ri, 1, rng, &x, &y)) break;
+        if (tile_taken(g, x, y)) continue;
+        if (game_spawn_enemy(g, roll_enemy_type(g->level, rng), x, y) == ENEMY_NONE) break;
+        want--;
+    }
+}
+
+// Account for the turns a cached level spent unattended, once the player
+// is standing on its stairs. Nothing is stepped turn by turn: healing is
+// one multiply, one search from the stairs serves every enemy's drift,
+// and respawns are placed directly, so a level left for ten thousand
+// turns costs the same as one left for ten.
+static void level_catch_up(GameState *g, int elapsed) {
+    if (elapsed <= 0) return;
+    EnemyPool *p = &g->enemies;
+    int healed = elapsed / REGEN_TURNS;
+    int drift  = elapsed >= WANDER_TURNS;
+    if (drift) drift_field_build(&g->map, g->player.x, g->player.y);
+    for (int i = 0; i < p->count; i++) {
+        if (!p->active[i]) continue;
+        p->hp[i] = healed >= p->max_hp[i] - p->hp[i] ? p->max_hp[i] : p->hp[i] + healed;
+        if (drift && !ENEMY_KIND(p, i)->is_boss) drift_toward_player(g, i, elapsed); // bosses hold their lair
+    }
+    if (g->level_cleared && elapsed >= RESPAWN_TURNS) {
+        Rng rng;
+        rng_seed(&rng, (uint64_t)rand());
+        respawn_enemies(g, elapsed, &rng);
+    }
+}
+
+// Adopt the background-generated level if it is this one, otherwise
+// generate it in place
+static void level_generate(GameState *g) {
+    if (pregen_take(g->level, &g->map, &g->enemies)) return;
+    map_generate(&g->map, g->level);
+    enemies_spawn(g);
+}
+
+// Start building the level below in the background unless it is cached
+static void pregen_next_level(GameState *g) {
+    int next = g->level + 1;
+    if (level_store_has(&g->levels, next)) return;
+    pregen_request(next);
+}
+
+// From town the dungeon resumes at the deepest cached level, or starts
+// over at a fresh level 1 (see game_enter_dungeon)
+static void pregen_dungeon_entry(GameState *g) {
+    if (level_store_has(&g->levels, g->max_level_reached)) return;
+    pregen_request(1);
+}
+
+void game_descend(GameState *g) {
+    level_cache_store(g);
 
     g->level++;
     if (g->level > g->max_level_reached)
         g->max_level_reached = g->level;
     g->level_cleared = 0;
-    if (g->level <= MAX_DEPTH && g->level_cache[g->level - 1].valid) {
-        g->map         = g->level_cache[g->level - 1].map;
-        g->enemy_count = g->level_cache[g->level - 1].enemy_count;
-        for (int i = 0; i < g->enemy_count; i++)
-            g->enemies[i] = g->level_cache[g->level - 1].enemies[i];
-        g->level_cleared = g->level_cache[g->level - 1].level_cleared;
+    int elapsed = 0;
+    if (level_store_has(&g->levels, g->level)) {
+        elapsed = level_cache_load(g);
     } else {
         g->level_cleared = 0;
-        map_generate(&g->map, g->level);
-        enemies_spawn(g);
+        level_generate(g);
     }
     g->player.x = g->map.stairs_up_x;
     g->player.y = g->map.stairs_up_y;
+    game_refresh_occupancy(g);
+    level_catch_up(g, elapsed);
+    game_refresh_regions(g);
+    pregen_next_level(g);
 }
 
 void game_ascend(GameState *g) {
     if (g->level <= 1) return;
 
-    if (g->level <= MAX_DEPTH) {
-        g->level_cache[g->level - 1].map           = g->map;
-        g->level_cache[g->level - 1].enemy_count   = g->enemy_count;
-        g->level_cache[g->level - 1].level_cleared = g->level_cleared;
-        for (int i = 0; i < g->enemy_count; i++)
-            g->level_cache[g->level - 1].enemies[i] = g->enemies[i];
-        g->level_cache[g->level - 1].valid = 1;
-    }
+    level_cache_store(g);
 
     g->level--;
 
-    if (g->level_cache[g->level - 1].valid) {
-        g->map         = g->level_cache[g->level - 1].map;
-        g->enemy_count = g->level_cache[g->level - 1].enemy_count;
-        g->level_cleared = g->level_cache[g->level - 1].level_cleared;
-        for (int i = 0; i < g->enemy_count; i++)
-            g->enemies[i] = g->level_cache[g->level - 1].enemies[i];
+    int elapsed = 0;
+    if (level_store_has(&g->levels, g->level)) {
+        elapsed = level_cache_load(g);
     } else {
+        // Dropped from the store (its file failed, or a snapshot lost it)
         g->level_cleared = 0;
+        level_generate(g);
     }
 
     g->player.x = g->map.stairs_down_x;
     g->player.y = g->map.stairs_down_y;
+    game_refresh_occupancy(g);
+    level_catch_up(g, elapsed);
+    game_refresh_regions(g);
+    pregen_next_level(g);
 }
 
 void game_enter_dungeon(GameState *g) {
     g->location = LOCATION_DUNGEON;
 
-    if (g->max_level_reached > 1 &&
-        g->level_cache[g->max_level_reached - 1].valid) {
+    if (level_store_has(&g->levels, g->max_level_reached)) {
         g->level = g->max_level_reached;
-        g->map         = g->level_cache[g->level - 1].map;
-        g->enemy_count = g->level_cache[g->level - 1].enemy_count;
-        for (int i = 0; i < g->enemy_count; i++)
-            g->enemies[i] = g->level_cache[g->level - 1].enemies[i];
+        int elapsed = level_cache_load(g);
         g->level_cleared = 1;
         g->player.x = g->map.stairs_up_x;
         g->player.y = g->map.stairs_up_y;
+        game_refresh_occupancy(g);
+        level_catch_up(g, elapsed);
     } else {
         g->level         = 1;
         g->level_cleared = 0;
-        for (int i = 0; i < MAX_DEPTH; i++)
-            g->level_cache[i].valid = 0;
-        map_generate(&g->map, g->level);
-        enemies_spawn(g);
+        level_store_clear(&g->levels);
+        level_generate(g);
         g->player.x = g->map.stairs_up_x;
         g->player.y = g->map.stairs_up_y;
+        game_refresh_occupancy(g);
     }
+    game_refresh_regions(g);
+    pregen_next_level(g);
 }
 
 void game_return_to_town(GameState *g) {
     // Cache current level before leaving
-    if (g->level >= 1 && g->level <= MAX_DEPTH) {
-        g->level_cache[g->level - 1].map = g->map;
-        g->level_cache[g->level - 1].enemy_count   = g->enemy_count;
-        g->level_cache[g->level - 1].level_cleared = g->level_cleared;
-        for (int i = 0; i < g->enemy_count; i++)
-            g->level_cache[g->level - 1].enemies[i] = g->enemies[i];
-        g->level_cache[g->level - 1].valid = 1;
-    }
+    level_cache_store(g);
 
     g->location = LOCATION_TOWN;
     int spawn_x, spawn_y;
@@ -403,7 +618,10 @@ void game_return_to_town(GameState *g) {
     g->player.x = spawn_x;
     g->player.y = spawn_y;
     g->floor_item_count = 0;
-    g->enemy_count = 0;
+    g->enemies.count = 0;
+    game_refresh_regions(g);
+    game_refresh_occupancy(g);
+    pregen_dungeon_entry(g);
 }
 
 void player_gain_xp(GameState *g, int xp) {
@@ -424,8 +642,6 @@ void player_gain_xp(GameState *g, int xp) {
 
         g->player.experience_next = g->player.level * 100;
 
-        char msg[MAX_MESSAGE_LEN];
-        snprintf(msg, sizeof(msg), "Level up! Now level %d", g->player.level);
-        push_message(g, msg);
+        game_log(g, EVENT_LEVEL_UP)->a = g->player.level;
     }
 }
\ No newline at end of file
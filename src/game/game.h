@@ -7,9 +7,19 @@
 #include "actions.h"
 #include <stdio.h>
 #include "spell.h"
-#include <SDL2/SDL.h>
+#include "regions.h"
+#include "path.h"
+#include "level_store.h"
+#include "occupancy.h"
+#include "flow.h"
+#include "schedule.h"
+#include "effects.h"
+#include "events.h"
+#include "aoe.h"
+#include "senses.h"
+#include <stdint.h>
 
-#define MAX_MESSAGES 3
+#define MAX_MESSAGES 3    // shown on the message bar
 #define MAX_MESSAGE_LEN 40
 
 #define MAX_TRAIL 16
@@ -17,7 +27,7 @@
 typedef struct {
     int active;
     int x, y;
-    Uint8 r, g, b;
+    uint8_t r, g, b;
     int is_impact;
 } TrailTile;
 
@@ -38,18 +48,9 @@ typedef struct {
     int   known_spell_count;
     int   equipped_spell;
     int   last_dx, last_dy;
-    int poison_turns;
     PlayerClass player_class;
 } Player;
 
-typedef struct {
-    Map   map;
-    Enemy enemies[MAX_ENEMIES];
-    int   enemy_count;
-    int   valid;
-    int   level_cleared;
-} LevelCache;
-
 typedef enum {
     LOCATION_TOWN,
     LOCATION_DUNGEON
@@ -59,11 +60,14 @@ typedef struct {
     Player     player;
     Map        map;
     int        level;
-    Enemy      enemies[MAX_ENEMIES];
-    int        enemy_count;
-    LevelCache level_cache[MAX_DEPTH];
-    char       messages[MAX_MESSAGES][MAX_MESSAGE_LEN];
-    int        message_count;
+    EnemyPool  enemies;
+    int        enemies_alive;    // see game_refresh_occupancy
+    uint16_t   enemy_free[MAX_ENEMIES]; // dead slots, reused by game_spawn_enemy
+    int        enemy_free_count;
+    Schedule   schedule;         // awake enemies by next action, see action_resolve_enemies
+    int        wake_x, wake_y, wake_room; // where the player last woke enemies
+    LevelStore levels;    // levels the player has left, see game_descend
+    EventLog   events;    // what happened, newest last; see game_log
     int        level_cleared;
     Location   location;
     int max_level_reached;
@@ -78,21 +82,72 @@ typedef struct {
     int       trail_count;
     int       trail_frames;
     int score;
+    Regions   regions; // of `map`, see game_refresh_regions
+    BitGrid   open;      // walkable tiles of `map`, for area effects
+    Occupancy occupancy; // of `enemies`, see game_refresh_occupancy
+    FlowField flow;      // toward the player, see action_resolve_enemies
+    Senses    senses;    // player scent and fight noise, the same
+    Path      travel;      // walk in progress, see game_travel_to
+    int       travel_step; // next cell of `travel` to step onto
+    int       turn;        // enemy turns resolved so far, see action_resolve_enemies
+    int       clock;       // `schedule` time, TURN_TICKS a turn at the player's normal speed
+    Effects   effects;     // on the player and enemies, see game_tick_effects
 } GameState;
 
 void game_init(GameState *g);
+// Release what the run holds outside GameState (the level store's file)
+void game_free(GameState *g);
 void game_move_player(GameState *g, int dx, int dy);
 void game_descend(GameState *g);
 void game_ascend(GameState *g);
 void enemies_spawn(GameState *g);
+void enemies_spawn_level(const Map *m, int level, EnemyPool *enemies, Rng *rng);
 void game_enter_dungeon(GameState *g);
 
 void action_resolve_player(GameState *g, Action a);
 void action_resolve_enemies(GameState *g);
 
 void player_gain_xp(GameState *g, int xp);
-void push_message(GameState *g, const char *msg);
+// Log an event of `kind` this turn, returning it for the caller to fill
+// in; its text is only made if it is shown
+GameEvent *game_log(GameState *g, EventKind kind);
+void       game_note(GameState *g, NoteId note);
 
 void game_return_to_town(GameState *g);
+// Relabel `regions` and rebuild `open` after `map` is replaced; also ends
+// any walk in progress and drops the flow field
+void game_refresh_regions(GameState *g);
+// Rebuild `occupancy`, `enemies_alive`, the free slots and `schedule`
+// after `enemies` is replaced or moved wholesale
+void game_refresh_occupancy(GameState *g);
+// Bring an enemy onto the level, in a dead one's slot if there is one.
+// Returns its index, or ENEMY_NONE if every slot holds a live enemy.
+int  game_spawn_enemy(GameState *g, EnemyType type, int x, int y);
+// Take slain enemy `i` off the board; the last one clears the level
+void game_kill_enemy(GameState *g, int i);
+// Put an effect on an enemy (its index) or EFFECT_PLAYER for `turns`
+// turns; see effects_add
+void game_apply_effect(GameState *g, int target, EffectKind kind, int turns);
+// Fire the effects due this turn: damage, healing, wearing off
+void game_tick_effects(GameState *g);
+// Enemies sleep until woken and cost nothing per turn until then. The
+// player wakes every enemy in a room by entering it and any enemy within
+// WAKE_RADIUS tiles in the same region; only the enemies around the
+// player are looked at, and only when the player has moved.
+void game_wake_near_player(GameState *g);
+// Wake every sleeping enemy that can hear noise where it stands. Sleepers
+// stay put and spread noise only fades, so only turns with new sounds look.
+void game_wake_on_noise(GameState *g);
+// Wake enemy `i`, e.g. one hit from afar
+void game_wake_enemy(GameState *g, int i);
+// Index of the active enemy standing on (x, y), or ENEMY_NONE
+int  game_enemy_at(const GameState *g, int x, int y);
+
+// Plan a walk to (x, y). Returns its number of steps, or -1 if unreachable.
+int    game_travel_to(GameState *g, int x, int y);
+// Next move of the walk, or ACTION_NONE once it is over. The walk stops
+// early when an enemy comes near or the player is moved off the route.
+Action game_travel_step(GameState *g);
+void   game_travel_cancel(GameState *g);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "intent.h"
+
+static int abs_int(int n) { return n < 0 ? -n : n; }
+
+// Neighbours of a tile, the way enemies move
+static const int STEPS[8][2] = {
+    { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+    { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 }
+};
+
+static int occupied(const GameState *g, int x, int y) {
+    return occupancy_at(&g->occupancy, &g->enemies, x, y) != OCCUPANCY_NONE;
+}
+
+// The free neighbour of (x, y) closest to the player on the flow field,
+// trying the straight line (mx, my) first so open ground is crossed the
+// way it always was. Returns 0 if no free tile is closer.
+static int flow_step(const GameState *g, int x, int y, int mx, int my,
+                     int *tx, int *ty) {
+    int best  = flow_dist(&g->flow, x, y);
+    int found = 0;
+    for (int k = -1; k < 8; k++) {
+        int nx = x + (k < 0 ? mx : STEPS[k][0]);
+        int ny = y + (k < 0 ? my : STEPS[k][1]);
+        int d  = flow_dist(&g->flow, nx, ny);
+        if (d >= best || d == 0 || occupied(g, nx, ny)) continue;
+        best  = d;
+        *tx   = nx;
+        *ty   = ny;
+        found = 1;
+    }
+    return found;
+}
+
+// Off the flow field an enemy has to track the player by its senses: up
+// the scent trail, else toward the loudest noise. Returns 0 if it has
+// nothing to go on or no free tile to go to.
+static int sense_step(const GameState *g, int x, int y, int *tx, int *ty) {
+    const Senses *s = &g->senses;
+    for (int pass = 0; pass < 2; pass++) {
+        int best = pass == 0 ? senses_scent(s, x, y) : senses_heard(s, x, y);
+        int found = 0;
+        for (int k = 0; k < 8; k++) {
+            int nx = x + STEPS[k][0];
+            int ny = y + STEPS[k][1];
+            int v  = pass == 0 ? senses_scent(s, nx, ny) : senses_heard(s, nx, ny);
+            if (v <= best || !map_is_walkable(&g->map, nx, ny) || occupied(g, nx, ny))
+                continue;
+            best  = v;
+            *tx   = nx;
+            *ty   = ny;
+            found = 1;
+        }
+        if (found) return 1;
+    }
+    return 0;
+}
+
+EnemyIntent intent_decide(const GameState *g, int x, int y) {
+    EnemyIntent in = { INTENT_WAIT, 0, 0 };
+    int dx = g->player.x - x;
+    int dy = g->player.y - y;
+
+    // Adjacent to player — melee attack
+    if (abs_int(dx) <= 1 && abs_int(dy) <= 1 && !(dx == 0 && dy == 0)) {
+        in.kind = INTENT_ATTACK;
+        return in;
+    }
+
+    // Nothing to chase if the player is walled off from this enemy
+    if (!regions_same(&g->regions, x, y, g->player.x, g->player.y))
+        return in;
+
+    int mx = (dx > 0) ? 1 : (dx < 0) ? -1 : 0;
+    int my = (dy > 0) ? 1 : (dy < 0) ? -1 : 0;
+    int tx = x + mx;
+    int ty = y + my;
+
+    // Downhill on the flow field; out of its reach, by scent or sound
+    if (flow_dist(&g->flow, x, y) != FLOW_UNREACHED) {
+        if (!flow_step(g, x, y, mx, my, &tx, &ty)) return in; // hemmed in by other enemies
+    } else if (!sense_step(g, x, y, &tx, &ty)) {
+        return in; // lost the player
+    }
+
+    if (map_is_walkable(&g->map, tx, ty) &&
+        !(tx == g->player.x && ty == g->player.y) &&
+        !occupied(g, tx, ty)) {
+        in.kind = INTENT_MOVE;
+        in.x    = (int16_t)tx;
+        in.y    = (int16_t)ty;
+    }
+    return in;
+}
+
+typedef struct {
+    const GameState *g;
+    const int       *xs, *ys;
+    const int       *ids;
+    int              count;
+    EnemyIntent     *out;
+} PlanBatch;
+
+static void plan_chunk(void *ctx, int chunk) {
+    const PlanBatch *b = ctx;
+    int end = (chunk + 1) * INTENT_CHUNK;
+    if (end > b->count) end = b->count;
+    for (int k = chunk * INTENT_CHUNK; k < end; k++)
+        b->out[k] = intent_decide(b->g, b->xs[b->ids[k]], b->ys[b->ids[k]]);
+}
+
+void intent_plan(const GameState *g, const int *xs, const int *ys,
+                 const int *ids, int count, EnemyIntent *out, ThreadPool *pool) {
+    PlanBatch b = { g, xs, ys, ids, count, out };
+    int chunks = (count + INTENT_CHUNK - 1) / INTENT_CHUNK;
+    if (!pool || count < INTENT_POOL_MIN) {
+        for (int c = 0; c < chunks; c++) plan_chunk(&b, c);
+        return;
+    }
+    pool_run(pool, chunks, plan_chunk, &b);
+}
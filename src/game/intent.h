@@ -0,0 +1,46 @@
+#ifndef INTENT_HEADER_H
+#define INTENT_HEADER_H
+
+#include <stdint.h>
+#include "game.h"
+#include "thread_pool.h"
+
+// An enemy's action comes in two halves. Deciding what to do (attack the
+// player, step down the flow field or a scent trail, or wait) only reads
+// the game, so all the enemies due at once decide from the same state,
+// on a thread pool when there are enough of them. action_resolve_enemies
+// then carries the decisions out one by one in schedule order; a step
+// onto a tile an earlier enemy has just taken is decided again against
+// the board as it now stands. A plan depends only on the state it was
+// made from, so the game plays out the same on any number of threads.
+
+typedef enum {
+    INTENT_WAIT = 0,
+    INTENT_ATTACK, // the player, from where it stands
+    INTENT_MOVE    // to (x, y)
+} IntentKind;
+
+typedef struct {
+    uint8_t kind; // IntentKind
+    int16_t x, y;
+} EnemyIntent;
+
+#define INTENT_CHUNK    8  // enemies to a pool task
+#define INTENT_POOL_MIN 64 // smaller waves are planned in place, where a
+                           // level's worth takes a few microseconds
+
+// What an enemy standing at (x, y) would do; a plan reads nothing else
+// of the enemy
+EnemyIntent intent_decide(const GameState *g, int x, int y);
+
+// Decide for the enemy at (xs[ids[k]], ys[ids[k]]) into out[k], k <
+// count, on `pool` if given. The positions are usually g->enemies.x and
+// .y; only g's enemies block a step.
+void intent_plan(const GameState *g, const int *xs, const int *ys,
+                 const int *ids, int count, EnemyIntent *out, ThreadPool *pool);
+
+// Pool action_resolve_enemies plans its waves on, or NULL (the default)
+// to plan in place. The caller owns it.
+void action_set_intent_pool(ThreadPool *pool);
+
+#endif
@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L // fileno, ftruncate
+
+#include "level_store.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define RECORD_SIZE   ((long)sizeof(LevelCache))
+#define BACKING_SIZE  ((size_t)RECORD_SIZE * MAX_DEPTH)
+
+#define SAVE_MAGIC    "CLVL"
+#define SAVE_VERSION  1
+
+// Saved level section: this header, then the records at its offsets.
+// Written in the build's own layout; record_size catches a changed one.
+typedef struct {
+    char     magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+    uint64_t run_id;
+    int32_t  offset[MAX_DEPTH]; // -1 if the level has no record
+    uint32_t gen[MAX_DEPTH];    // LevelStore.gen when the record was written
+} SaveHeader;
+
+static uint64_t new_run_id(void) {
+    static unsigned calls;
+    uint64_t id = (uint64_t)time(NULL) << 32 ^ (uint64_t)clock() << 16;
+    id ^= (uint64_t)rand() << 24 ^ (uint64_t)rand() ^ ++calls;
+    return id * 0x9E3779B97F4A7C15ull; // spread the bits
+}
+
+void level_store_init(LevelStore *s) {
+    memset(s, 0, sizeof(*s));
+    for (int i = 0; i < MAX_DEPTH; i++) s->offset[i] = -1;
+    s->run_id = new_run_id();
+}
+
+void level_store_clear(LevelStore *s) {
+    if (s->data) munmap(s->data, BACKING_SIZE);
+    if (s->file) fclose(s->file);
+    level_store_init(s);
+}
+
+static int resident_slot(const LevelStore *s, int level) {
+    for (int i = 0; i < LEVEL_STORE_RESIDENT; i++)
+        if (s->slot_level[i] == level) return i;
+    return -1;
+}
+
+int level_store_has(const LevelStore *s, int level) {
+    if (level < 1 || level > MAX_DEPTH || s->gen[level - 1] == 0) return 0;
+    return s->offset[level - 1] >= 0 || resident_slot(s, level) >= 0;
+}
+
+// The sparse backing file is sized for every depth up front, so it is
+// mapped once and never moved
+static int open_backing(LevelStore *s) {
+    if (s->data) return 1;
+    s->file = tmpfile();
+    if (!s->file) return 0;
+    int fd = fileno(s->file);
+    void *data = MAP_FAILED;
+    if (ftruncate(fd, (off_t)BACKING_SIZE) == 0)
+        data = mmap(NULL, BACKING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        fclose(s->file);
+        s->file = NULL;
+        return 0;
+    }
+    s->data = data;
+    return 1;
+}
+
+// Write slot `i` out if the file lacks its latest record, and free it.
+// Should the file be unusable the level is dropped, and game_descend or
+// game_ascend generates it afresh on the next visit.
+static void page_out(LevelStore *s, int i) {
+    int level = s->slot_level[i];
+    long *at = &s->offset[level - 1];
+    if (s->slot_dirty[i] || *at < 0) {
+        if (!open_backing(s)) {
+            s->gen[level - 1] = 0;
+        } else {
+            if (*at < 0) *at = (long)s->records++ * RECORD_SIZE;
+            memcpy(s->data + *at, &s->slots[i], sizeof(LevelCache));
+        }
+    }
+    s->slot_level[i] = 0;
+    s->slot_dirty[i] = 0;
+}
+
+// A slot for `level`: its own if resident, else a free or evicted one
+static int claim_slot(LevelStore *s, int level) {
+    int slot = resident_slot(s, level);
+    if (slot < 0) {
+        slot = 0;
+        for (int i = 0; i < LEVEL_STORE_RESIDENT; i++) {
+            if (s->slot_level[i] == 0) {
+                slot = i;
+                break;
+            }
+            if (s->slot_used[i] < s->slot_used[slot]) slot = i;
+        }
+        if (s->slot_level[slot]) page_out(s, slot);
+        s->slot_level[slot] = level;
+    }
+    s->slot_used[slot] = ++s->tick;
+    return slot;
+}
+
+const LevelCache *level_store_get(LevelStore *s, int level) {
+    if (!level_store_has(s, level)) return NULL;
+    int slot = resident_slot(s, level);
+    if (slot >= 0) {
+        s->slot_used[slot] = ++s->tick;
+        return &s->slots[slot];
+    }
+    slot = claim_slot(s, level);
+    memcpy(&s->slots[slot], s->data + s->offset[level - 1], sizeof(LevelCache));
+    return &s->slots[slot];
+}
+
+LevelCache *level_store_put(LevelStore *s, int level) {
+    int slot = claim_slot(s, level);
+    s->slot_dirty[slot] = 1;
+    s->gen[level - 1] = ++s->next_gen;
+    return &s->slots[slot];
+}
+
+const LevelCache *level_store_paged_out(const LevelStore *s, int level) {
+    if (!level_store_has(s, level) || resident_slot(s, level) >= 0) return NULL;
+    return (const LevelCache *)(s->data + s->offset[level - 1]);
+}
+
+void level_store_detach(LevelStore *s) {
+    s->file    = NULL;
+    s->data    = NULL;
+    s->records = 0;
+    for (int i = 0; i < MAX_DEPTH; i++) s->offset[i] = -1;
+    for (int i = 0; i < LEVEL_STORE_RESIDENT; i++)
+        s->slot_dirty[i] = s->slot_level[i] != 0;
+}
+
+int level_store_adopt(LevelStore *s, int level, const LevelCache *c) {
+    if (level < 1 || level > MAX_DEPTH || s->gen[level - 1] == 0 ||
+        resident_slot(s, level) >= 0 || !open_backing(s)) return 0;
+    long *at = &s->offset[level - 1];
+    if (*at < 0) *at = (long)s->records++ * RECORD_SIZE;
+    memcpy(s->data + *at, c, sizeof(LevelCache));
+    return 1;
+}
+
+// The latest record of a stored level, wherever it is, without paging
+static const LevelCache *peek(const LevelStore *s, int level) {
+    int slot = resident_slot(s, level);
+    if (slot >= 0) return &s->slots[slot];
+    if (s->offset[level - 1] < 0) return NULL;
+    return (const LevelCache *)(s->data + s->offset[level - 1]);
+}
+
+static int header_ok(const SaveHeader *h) {
+    return memcmp(h->magic, SAVE_MAGIC, 4) == 0 && h->version == SAVE_VERSION &&
+           h->record_size == (uint32_t)RECORD_SIZE;
+}
+
+int level_store_save(const LevelStore *s, const char *path) {
+    SaveHeader old, h;
+    FILE *f = fopen(path, "r+b");
+    int reuse = f && fread(&old, sizeof(old), 1, f) == 1 &&
+                header_ok(&old) && old.run_id == s->run_id;
+    if (!reuse) {
+        if (f) fclose(f);
+        f = fopen(path, "w+b");
+        if (!f) return -1;
+    }
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SAVE_MAGIC, 4);
+    h.version     = SAVE_VERSION;
+    h.record_size = (uint32_t)RECORD_SIZE;
+    h.run_id      = s->run_id;
+    long end = (long)sizeof(h); // where the next new record goes
+    for (int i = 0; reuse && i < MAX_DEPTH; i++)
+        if (old.offset[i] >= 0 && old.offset[i] + RECORD_SIZE > end)
+            end = old.offset[i] + RECORD_SIZE;
+
+    int written = 0, ok = 1;
+    for (int i = 0; i < MAX_DEPTH; i++) {
+        h.offset[i] = -1;
+        const LevelCache *c = s->gen[i] ? peek(s, i + 1) : NULL;
+        if (!c) continue;
+        long at = reuse ? old.offset[i] : -1;
+        if (at >= 0 && old.gen[i] == s->gen[i]) {
+            h.offset[i] = (int32_t)at;
+            h.gen[i]    = s->gen[i];
+            continue;
+        }
+        if (at < 0) {
+            at   = end;
+            end += RECORD_SIZE;
+        }
+        if (fseek(f, at, SEEK_SET) != 0 || fwrite(c, sizeof(*c), 1, f) != 1) {
+            ok = 0;
+            break;
+        }
+        h.offset[i] = (int32_t)at;
+        h.gen[i]    = s->gen[i];
+        written++;
+    }
+    if (ok) ok = fseek(f, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, f) == 1;
+    if (fclose(f) != 0) ok = 0;
+    return ok ? written : -1;
+}
+
+int level_store_load(LevelStore *s, const char *path) {
+    FILE *f = fopen(path, "r+b");
+    if (!f) return 0;
+    SaveHeader h;
+    if (fread(&h, sizeof(h), 1, f) != 1 || !header_ok(&h)) {
+        fclose(f);
+        return 0;
+    }
+
+    level_store_clear(s);
+    unsigned last = 0;
+    for (int i = 0; i < MAX_DEPTH; i++) {
+        if (h.offset[i] < 0) continue;
+        LevelCache *c = level_store_put(s, i + 1);
+        if (fseek(f, h.offset[i], SEEK_SET) != 0 || fread(c, sizeof(*c), 1, f) != 1) {
+            fclose(f);
+            level_store_clear(s);
+            return 0;
+        }
+        s->gen[i] = h.gen[i];
+        if (h.gen[i] > last) last = h.gen[i];
+    }
+    s->next_gen = last;
+
+    // The loaded run may now diverge from other saves of it, so it goes
+    // on under its new id and claims this file. Should that fail, the
+    // next save here just rewrites every level.
+    h.run_id = s->run_id;
+    if (fseek(f, 0, SEEK_SET) == 0) fwrite(&h, sizeof(h), 1, f);
+    fclose(f);
+    return 1;
+}
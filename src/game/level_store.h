@@ -0,0 +1,78 @@
+#ifndef LEVEL_STORE_HEADER_H
+#define LEVEL_STORE_HEADER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "map.h"
+#include "enemy.h"
+
+// Levels the player has left, by depth. Only the LEVEL_STORE_RESIDENT
+// most recently used are kept in memory; the rest are paged out to a
+// single memory-mapped temporary file, each at an offset recorded in the
+// store's index, and paged back in when asked for. A level is only
+// written out again if it was put since it was last paged out.
+//
+// The same records make up the level section of a save (see
+// level_store_save), written as raw bytes rather than JSON, and a save
+// made over an earlier one from the same run skips every level whose
+// record has not changed since.
+
+#define LEVEL_STORE_RESIDENT 4
+
+typedef struct {
+    Map       map;
+    EnemyPool enemies;
+    int       level_cleared;
+    int       left_turn; // GameState.turn when the player last left the level
+} LevelCache;
+
+typedef struct {
+    LevelCache    slots[LEVEL_STORE_RESIDENT];
+    int           slot_level[LEVEL_STORE_RESIDENT]; // 0 if the slot is free
+    unsigned      slot_used[LEVEL_STORE_RESIDENT];  // last touched, for LRU
+    unsigned char slot_dirty[LEVEL_STORE_RESIDENT]; // not yet in the file
+    unsigned      tick;
+    unsigned      gen[MAX_DEPTH];    // bumped on every put, 0 if no record
+    unsigned      next_gen;
+    long          offset[MAX_DEPTH]; // in the backing file, -1 if never paged out
+    int           records;           // records allocated in the backing file
+    FILE         *file;              // opened on the first eviction
+    unsigned char *data;             // the backing file, mapped
+    uint64_t      run_id;            // ties save files to this run
+} LevelStore;
+
+void level_store_init(LevelStore *s);
+// Forget every level and release the backing file. The store stays
+// usable, as after level_store_init.
+void level_store_clear(LevelStore *s);
+
+int  level_store_has(const LevelStore *s, int level);
+
+// The record for `level`, paged in if it was evicted, or NULL if the
+// level was never stored. Valid until the next put or get.
+const LevelCache *level_store_get(LevelStore *s, int level);
+
+// A resident record for `level` for the caller to fill in, evicting the
+// least recently used level if every slot is taken. Valid until the next
+// put or get.
+LevelCache *level_store_put(LevelStore *s, int level);
+
+// Snapshots copy a store byte for byte, which carries over the resident
+// levels but not the backing file. level_store_paged_out gives the record
+// of a level that is only in the file (NULL otherwise). In the copy,
+// level_store_detach forgets the original's file, and level_store_adopt
+// puts each paged out record back; levels not adopted are dropped.
+const LevelCache *level_store_paged_out(const LevelStore *s, int level);
+void level_store_detach(LevelStore *s);
+int  level_store_adopt(LevelStore *s, int level, const LevelCache *c);
+
+// Write every stored level to `path`. Records already there from an
+// earlier save of this run are rewritten only if they changed. Returns
+// the number of records written, or -1 on failure.
+int  level_store_save(const LevelStore *s, const char *path);
+
+// Replace the store's levels with those saved at `path`. Returns 0 if
+// the file is missing or was written by an incompatible build.
+int  level_store_load(LevelStore *s, const char *path);
+
+#endif
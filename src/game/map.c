@@ -1,5 +1,19 @@
 #include "map.h"
+#include "rooms.h"
+#include "regions.h"
+#include "room_index.h"
+#include "vault.h"
 #include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+// Scattered rooms are placed inside this span (roughly the top-left
+// quarter plus room overhang), which keeps those levels compact.
+#define DUNGEON_SPAN_W (MAP_W / 2 + MAX_ROOM_W + 1)
+#define DUNGEON_SPAN_H (MAP_H / 2 + MAX_ROOM_H + 1)
+
+#define SCATTER_ATTEMPTS 200
+#define LAYOUT_ATTEMPTS  3 // rerolls if a level cannot be connected
 
 static void fill_rect(Map *m, int x, int y, int w, int h, TileType t) {
     for (int ry = y; ry < y + h; ry++)
@@ -8,87 +22,326 @@ static void fill_rect(Map *m, int x, int y, int w, int h, TileType t) {
                 m->tiles[ry][rx] = t;
 }
 
+// Only walls are opened, so a repair corridor carved after stairs and
+// traps are placed leaves them alone
+static void open_tile(Map *m, int x, int y) {
+    if (x >= 0 && x < MAP_W && y >= 0 && y < MAP_H && m->tiles[y][x] == TILE_WALL)
+        m->tiles[y][x] = TILE_FLOOR;
+}
+
 static void carve_corridor(Map *m, int x1, int y1, int x2, int y2) {
     // Horizontal then vertical L-shaped corridor
     int x = x1;
     while (x != x2) {
-        if (x >= 0 && x < MAP_W && y1 >= 0 && y1 < MAP_H)
-            m->tiles[y1][x] = TILE_FLOOR;
+        open_tile(m, x, y1);
         x += (x2 > x1) ? 1 : -1;
     }
     int y = y1;
     while (y != y2) {
-        if (x2 >= 0 && x2 < MAP_W && y >= 0 && y < MAP_H)
-            m->tiles[y][x2] = TILE_FLOOR;
+        open_tile(m, x2, y);
         y += (y2 > y1) ? 1 : -1;
     }
-    m->tiles[y2][x2] = TILE_FLOOR;
+    open_tile(m, x2, y2);
 }
 
-static int rooms_overlap(const Room *a, const Room *b) {
-    return !(a->x + a->w + 1 < b->x ||
-             b->x + b->w + 1 < a->x ||
-             a->y + a->h + 1 < b->y ||
-             b->y + b->h + 1 < a->y);
+void map_room_center(const Room *r, int *cx, int *cy) {
+    *cx = r->x + r->w / 2;
+    *cy = r->y + r->h / 2;
 }
 
-static int random_range(int min, int max) {
-    return min + rand() % (max - min + 1);
+int map_room_at(const Map *m, int x, int y) {
+    for (int i = 0; i < m->room_count; i++) {
+        const Room *r = &m->rooms[i];
+        if (x >= r->x && x < r->x + r->w && y >= r->y && y < r->y + r->h)
+            return i;
+    }
+    return -1;
 }
 
-void map_room_center(const Room *r, int *cx, int *cy) {
-    *cx = r->x + r->w / 2;
-    *cy = r->y + r->h / 2;
+// Carve a corridor and keep it for map_build_room_graph
+static void link_rooms(Map *m, int x1, int y1, int x2, int y2) {
+    carve_corridor(m, x1, y1, x2, y2);
+    if (m->corridor_count < MAX_CORRIDORS)
+        m->corridors[m->corridor_count++] =
+            (Corridor){ (short)x1, (short)y1, (short)x2, (short)y2 };
 }
 
-void map_generate(Map *m, int level) {
-    (void)level;
+// Tiles of a corridor in the order carve_corridor opens them
+static int corridor_tiles(int x1, int y1, int x2, int y2, short *xs, short *ys) {
+    int n = 0;
+    for (int x = x1; x != x2; x += (x2 > x1) ? 1 : -1) {
+        xs[n] = (short)x;
+        ys[n++] = (short)y1;
+    }
+    for (int y = y1; y != y2; y += (y2 > y1) ? 1 : -1) {
+        xs[n] = (short)x2;
+        ys[n++] = (short)y;
+    }
+    xs[n] = (short)x2;
+    ys[n++] = (short)y2;
+    return n;
+}
 
-    // Fill with walls
-    for (int y = 0; y < MAP_H; y++)
-        for (int x = 0; x < MAP_W; x++)
-            m->tiles[y][x] = TILE_WALL;
+// One stretch of corridor between leaving a room and entering the next
+typedef struct {
+    int a, b; // rooms at either end, -1 if it ends outside a room
+    int ax, ay, bx, by;
+    int x0, y0, x1, y1;
+} Piece;
 
-    m->room_count = 0;
+// Piece p meets piece q, or room `room`, where its tile (jx, jy) is or
+// touches their tile (kx, ky). Corridors can run side by side for a
+// while, so the first and the last contact are both kept.
+typedef struct {
+    int p, q, room;
+    int jx, jy, kx, ky;
+    int last;
+} Crossing;
 
-    int target_rooms = random_range(MIN_ROOMS, MAX_ROOMS);
-    int attempts = 0;
+// Each leg of an L-shaped corridor crosses a room at most once, so a
+// corridor is cut into at most two pieces per room plus one. Crossings
+// have no such bound; levels come to about half of MAX_CROSSINGS, and one
+// that runs out goes without a room graph (see map_build_room_graph).
+#define MAX_PIECES    (MAX_CORRIDORS * (2 * MAX_ROOMS + 1))
+#define MAX_CROSSINGS 128
 
-    while (m->room_count < target_rooms && attempts < 200) {
-        attempts++;
+static void box_grow(MapLink *l, int x, int y) {
+    if (x < l->x0)     l->x0 = (short)x;
+    if (y < l->y0)     l->y0 = (short)y;
+    if (x + 1 > l->x1) l->x1 = (short)(x + 1);
+    if (y + 1 > l->y1) l->y1 = (short)(y + 1);
+}
 
-        Room r;
-        r.w = random_range(MIN_ROOM_W, MAX_ROOM_W);
-        r.h = random_range(MIN_ROOM_H, MAX_ROOM_H);
-        r.x = random_range(1, MAP_W / 2); // hallway size
-        r.y = random_range(1, MAP_H / 2); // hallway size
-        // r.x = random_range(1, MAP_W - r.w - 2);
-        // r.y = random_range(1, MAP_H - r.h - 2);
+// Rooms are open rectangles, so one link can stand in for another
+// joining the same rooms if walking to its ends inside them is no longer
+static int ends_apart(const MapLink *l, int ax, int ay, int bx, int by) {
+    return abs(l->ax - ax) + abs(l->ay - ay) + abs(l->bx - bx) + abs(l->by - by);
+}
 
-        // Check overlap with existing rooms
-        int overlaps = 0;
-        for (int i = 0; i < m->room_count; i++) {
-            if (rooms_overlap(&r, &m->rooms[i])) {
-                overlaps = 1;
-                break;
+// Returns 0 if the graph had no room left for the link
+static int add_link(Map *m, int a, int ax, int ay, int b, int bx, int by,
+                    int len, int x0, int y0, int x1, int y1) {
+    if (a < 0 || b < 0 || a == b) return 1;
+    if (a > b) {
+        int t;
+        t = a;  a  = b;  b  = t;
+        t = ax; ax = bx; bx = t;
+        t = ay; ay = by; by = t;
+    }
+    MapLink *l = NULL;
+    for (int i = 0; i < m->link_count; i++) {
+        MapLink *o = &m->links[i];
+        if (o->a != a || o->b != b) continue;
+        int apart = ends_apart(o, ax, ay, bx, by);
+        if (o->len + apart <= len) return 1;
+        if (!l && len + apart <= o->len) l = o; // replaces o
+    }
+    if (!l) {
+        if (m->link_count >= MAX_LINKS) return 0;
+        l = &m->links[m->link_count++];
+    }
+    l->a   = (signed char)a;
+    l->b   = (signed char)b;
+    l->ax  = (short)ax;
+    l->ay  = (short)ay;
+    l->bx  = (short)bx;
+    l->by  = (short)by;
+    l->len = (short)len;
+    l->x0  = (short)x0;
+    l->y0  = (short)y0;
+    l->x1  = (short)x1;
+    l->y1  = (short)y1;
+    box_grow(l, ax, ay);
+    box_grow(l, bx, by);
+    return 1;
+}
+
+void map_build_room_graph(Map *m) {
+    Piece    pieces[MAX_PIECES];
+    Crossing crossings[MAX_CROSSINGS];
+    short    owner[MAP_H][MAP_W]; // piece holding each corridor tile
+    short    xs[MAP_W + MAP_H], ys[MAP_W + MAP_H];
+    int np = 0, nc = 0, full = 0;
+
+    for (int y = 0; y < m->h; y++)
+        memset(owner[y], 0xFF, m->w * sizeof(owner[0][0]));
+
+    for (int c = 0; c < m->corridor_count; c++) {
+        const Corridor *cor = &m->corridors[c];
+        int k = corridor_tiles(cor->x1, cor->y1, cor->x2, cor->y2, xs, ys);
+        int room = -1, lx = cor->x1, ly = cor->y1, open = -1;
+        for (int t = 0; t < k; t++) {
+            int x = xs[t], y = ys[t];
+            int r = map_room_at(m, x, y);
+            if (r >= 0 && open < 0 && room >= 0 && r != room) {
+                if (np >= MAX_PIECES) {
+                    full = 1;
+                    break;
+                }
+                // Rooms touching with no corridor between them
+                Piece *p = &pieces[np];
+                *p = (Piece){ room, -1, lx, ly, -1, -1, lx, ly, lx + 1, ly + 1 };
+                open = np++;
+            }
+            if (r >= 0) {
+                if (open >= 0) {
+                    Piece *p = &pieces[open];
+                    p->b  = r;
+                    p->bx = x;
+                    p->by = y;
+                    open = -1;
+                }
+                room = r;
+                lx = x;
+                ly = y;
+                continue;
             }
-        }
-        if (overlaps) continue;
 
-        // Carve room
-        fill_rect(m, r.x, r.y, r.w, r.h, TILE_FLOOR);
+            if (open < 0) {
+                if (np >= MAX_PIECES) {
+                    full = 1;
+                    break;
+                }
+                int sx = room >= 0 ? lx : x, sy = room >= 0 ? ly : y;
+                pieces[np] = (Piece){ room, -1, sx, sy, -1, -1, sx, sy, sx + 1, sy + 1 };
+                open = np++;
+            }
+            Piece *p = &pieces[open];
+            if (x < p->x0)     p->x0 = x;
+            if (y < p->y0)     p->y0 = y;
+            if (x + 1 > p->x1) p->x1 = x + 1;
+            if (y + 1 > p->y1) p->y1 = y + 1;
 
-        // Connect to previous room
-        if (m->room_count > 0) {
-            int cx1, cy1, cx2, cy2;
-            map_room_center(&m->rooms[m->room_count - 1], &cx1, &cy1);
-            map_room_center(&r, &cx2, &cy2);
-            carve_corridor(m, cx1, cy1, cx2, cy2);
+            owner[y][x] = (short)open;
+            for (int d = 0; d < 5; d++) {
+                int kx = x + (d == 1) - (d == 2), ky = y + (d == 3) - (d == 4);
+                if (kx < 0 || kx >= m->w || ky < 0 || ky >= m->h) continue;
+                int q = owner[ky][kx], rk = -1;
+                if (d > 0 && (rk = map_room_at(m, kx, ky)) >= 0) q = -1;
+                else if (q == open || q < 0) continue;
+                Crossing *first = NULL, *slot = NULL;
+                for (int i = 0; i < nc; i++) {
+                    Crossing *c = &crossings[i];
+                    if (c->p != open || c->q != q || c->room != rk) continue;
+                    if (c->last) slot  = c;
+                    else         first = c;
+                }
+                if (!slot) {
+                    if (nc >= MAX_CROSSINGS) {
+                        full = 1;
+                        continue;
+                    }
+                    slot = &crossings[nc++];
+                }
+                *slot = (Crossing){ open, q, rk, x, y, kx, ky, first != NULL };
+            }
         }
+    }
+
+    // Along an L-shaped corridor the walk between two of its tiles is
+    // their Manhattan distance
+    m->link_count = 0;
+    for (int i = 0; i < np; i++) {
+        const Piece *p = &pieces[i];
+        full |= !add_link(m, p->a, p->ax, p->ay, p->b, p->bx, p->by,
+                          abs(p->ax - p->bx) + abs(p->ay - p->by),
+                          p->x0, p->y0, p->x1, p->y1);
+    }
+    for (int i = 0; i < nc; i++) {
+        const Crossing *c = &crossings[i];
+        const Piece *p = &pieces[c->p];
+        int jx = c->jx, jy = c->jy, kx = c->kx, ky = c->ky;
+        int step = abs(jx - kx) + abs(jy - ky);
+        if (c->q < 0) {
+            // Corridor brushing past a room: the room splits the piece
+            full |= !add_link(m, p->a, p->ax, p->ay, c->room, kx, ky,
+                              abs(p->ax - jx) + abs(p->ay - jy) + step,
+                              p->x0, p->y0, p->x1, p->y1);
+            full |= !add_link(m, c->room, kx, ky, p->b, p->bx, p->by,
+                              step + abs(jx - p->bx) + abs(jy - p->by),
+                              p->x0, p->y0, p->x1, p->y1);
+            continue;
+        }
+        const Piece *q = &pieces[c->q];
+        int x0 = p->x0 < q->x0 ? p->x0 : q->x0, y0 = p->y0 < q->y0 ? p->y0 : q->y0;
+        int x1 = p->x1 > q->x1 ? p->x1 : q->x1, y1 = p->y1 > q->y1 ? p->y1 : q->y1;
+        for (int e = 0; e < 4; e++) {
+            int ra = e & 1 ? p->b : p->a, rb = e & 2 ? q->b : q->a;
+            int ax = e & 1 ? p->bx : p->ax, ay = e & 1 ? p->by : p->ay;
+            int bx = e & 2 ? q->bx : q->ax, by = e & 2 ? q->by : q->ay;
+            full |= !add_link(m, ra, ax, ay, rb, bx, by,
+                              abs(ax - jx) + abs(ay - jy) + step + abs(kx - bx) + abs(ky - by),
+                              x0, y0, x1, y1);
+        }
+    }
+
+    // A graph missing edges would send paths the long way round; with
+    // none at all path_find searches the whole level instead
+    if (full) m->link_count = 0;
+}
+
+void map_generate(Map *m, int level) {
+    Rng rng;
+    rng_seed(&rng, (uint64_t)rand());
+    map_generate_rng(m, level, &rng);
+}
+
+void map_generate_rng(Map *m, int level, Rng *rng) {
+    map_generate_layout(m, level, map_layout_for_level(level), rng);
+}
+
+MapLayout map_layout_for_level(int level) {
+    return level >= BSP_FIRST_LEVEL ? LAYOUT_BSP : LAYOUT_SCATTER;
+}
+
+static void layout_rooms(Map *m, int level, MapLayout layout, Rng *rng) {
+    int area_w = DUNGEON_SPAN_W, area_h = DUNGEON_SPAN_H;
+    if (layout == LAYOUT_BSP) {
+        area_w = MAP_W;
+        area_h = MAP_H;
+    }
+
+    // Fill with walls, only as far as rooms can reach
+    for (int y = 0; y < area_h; y++)
+        memset(m->tiles[y], TILE_WALL, area_w);
+
+    RoomLink links[MAX_ROOMS];
+    int link_count = 0;
+    int target_rooms = rng_range(rng, MIN_ROOMS, MAX_ROOMS);
+    if (layout == LAYOUT_BSP) {
+        rooms_place_bsp(m->rooms, target_rooms, area_w, area_h, links, rng);
+        m->room_count = target_rooms;
+        link_count    = target_rooms - 1;
+    } else {
+        m->room_count = rooms_place_scatter(m->rooms, target_rooms,
+                                            area_w, area_h, SCATTER_ATTEMPTS,
+                                            links, &link_count, rng);
+    }
+
+    for (int i = 0; i < m->room_count; i++) {
+        const Room *r = &m->rooms[i];
+        fill_rect(m, r->x, r->y, r->w, r->h, TILE_FLOOR);
+    }
+    m->corridor_count = 0;
+    for (int i = 0; i < link_count; i++) {
+        int cx1, cy1, cx2, cy2;
+        map_room_center(&m->rooms[links[i].a], &cx1, &cy1);
+        map_room_center(&m->rooms[links[i].b], &cx2, &cy2);
+        link_rooms(m, cx1, cy1, cx2, cy2);
+    }
 
-        m->rooms[m->room_count++] = r;
+    // Tight bounds: corridors run between room centers, so the rooms'
+    // bounding box plus one wall column/row covers every carved tile
+    m->w = 0;
+    m->h = 0;
+    for (int i = 0; i < m->room_count; i++) {
+        const Room *r = &m->rooms[i];
+        if (r->x + r->w + 1 > m->w) m->w = r->x + r->w + 1;
+        if (r->y + r->h + 1 > m->h) m->h = r->y + r->h + 1;
     }
 
+    vault_stamp_level(m, level, rng);
+
     // Place stairs up in first room
     int ux, uy;
     map_room_center(&m->rooms[0], &ux, &uy);
@@ -105,30 +358,116 @@ void map_generate(Map *m, int level) {
     m->tiles[dy][dx] = TILE_STAIRS_DOWN;
 
     // Place traps in rooms (skip room 0 — player spawn)
+    RoomIndex ri;
+    room_index_build(&ri, m);
     int num_traps = 2 + level;
     if (num_traps > 12) num_traps = 12;
     for (int t = 0; t < num_traps; t++) {
-        int room_idx = 1 + rand() % (m->room_count - 1);
-        Room *room = &m->rooms[room_idx];
-        int tx = room->x + 1 + rand() % (room->w - 2);
-        int ty = room->y + 1 + rand() % (room->h - 2);
-        if (m->tiles[ty][tx] != TILE_FLOOR) continue;
+        int tx, ty;
+        if (!room_index_take_any(&ri, 1, rng, &tx, &ty)) break;
         m->tiles[ty][tx] = TILE_TRAP_HIDDEN;
     }
 }
 
+void map_generate_layout(Map *m, int level, MapLayout layout, Rng *rng) {
+    for (int attempt = 0; attempt < LAYOUT_ATTEMPTS; attempt++) {
+        layout_rooms(m, level, layout, rng);
+        if (map_connect_regions(m) >= 0) return;
+    }
+    // Never hand out a level with part of it cut off
+    map_chain_rooms(m);
+}
+
+void map_chain_rooms(Map *m) {
+    int px = m->stairs_up_x, py = m->stairs_up_y;
+    for (int i = 0; i <= m->room_count; i++) {
+        int cx = m->stairs_down_x, cy = m->stairs_down_y;
+        if (i < m->room_count) map_room_center(&m->rooms[i], &cx, &cy);
+        link_rooms(m, px, py, cx, cy);
+        px = cx;
+        py = cy;
+    }
+    map_build_room_graph(m);
+}
+
+int map_connect_regions(Map *m) {
+    Regions r;
+    int carved = 0;
+
+    for (int pass = 0; pass <= m->room_count + 1; pass++) {
+        regions_build(&r, m);
+        int home = regions_id(&r, m->stairs_up_x, m->stairs_up_y);
+
+        // First thing cut off from the stairs up: stairs down, then rooms
+        int tx = -1, ty = -1;
+        if (regions_id(&r, m->stairs_down_x, m->stairs_down_y) != home) {
+            tx = m->stairs_down_x;
+            ty = m->stairs_down_y;
+        }
+        for (int i = 0; i < m->room_count && tx < 0; i++) {
+            int cx, cy;
+            map_room_center(&m->rooms[i], &cx, &cy);
+            if (regions_id(&r, cx, cy) != home) {
+                tx = cx;
+                ty = cy;
+            }
+        }
+        if (tx < 0) {
+            map_build_room_graph(m);
+            return carved;
+        }
+
+        // Join it to the nearest room already reachable
+        int bx = m->stairs_up_x, by = m->stairs_up_y;
+        int best = abs(tx - bx) + abs(ty - by);
+        for (int i = 0; i < m->room_count; i++) {
+            int cx, cy;
+            map_room_center(&m->rooms[i], &cx, &cy);
+            int d = abs(tx - cx) + abs(ty - cy);
+            if (d < best && regions_id(&r, cx, cy) == home) {
+                best = d;
+                bx = cx;
+                by = cy;
+            }
+        }
+        link_rooms(m, tx, ty, bx, by);
+        carved++;
+    }
+    return -1;
+}
+
 int map_is_walkable(const Map *m, int x, int y) {
-    if (x < 0 || x >= MAP_W || y < 0 || y >= MAP_H) return 0;
-    return m->tiles[y][x] != TILE_WALL;
+    if (x < 0 || x >= m->w || y < 0 || y >= m->h) return 0;
+    return TILE_HAS(m->tiles[y][x], TRAIT_WALKABLE);
 }
 
-void map_generate_town(Map *m, int *spawn_x, int *spawn_y) {
-    m->room_count = 0;
+TileType map_get_tile(const Map *m, int x, int y) {
+    if (x < 0 || x >= m->w || y < 0 || y >= m->h) return TILE_WALL;
+    return m->tiles[y][x];
+}
+
+void map_copy(Map *dst, const Map *src) {
+    // Header fields first, then only the rows/columns inside the bounds
+    memcpy(dst, src, offsetof(Map, tiles));
+    for (int y = 0; y < src->h; y++)
+        memcpy(dst->tiles[y], src->tiles[y], src->w);
+}
+
+// The town never changes, so it is painted once and copied out after that
+static Map town;
+static int town_ready;
+
+static void paint_town(Map *m) {
+    m->room_count     = 0;
+    m->corridor_count = 0;
+    m->link_count     = 0;
+    m->lair_x = m->lair_y = -1;
+    m->w = TOWN_W;
+    m->h = TOWN_H;
 
     // Fill with walls
-    for (int y = 0; y < MAP_H; y++)
-        for (int x = 0; x < MAP_W; x++)
-            m->tiles[y][x] = TILE_WALL;
+    for (int y = 0; y < TOWN_H; y++)
+        memset(m->tiles[y], TILE_WALL, TOWN_W);
 
     // Town floor
     for (int y = 1; y < TOWN_H - 1; y++)
@@ -157,6 +496,15 @@ void map_generate_town(Map *m, int *spawn_x, int *spawn_y) {
         for (int dx = 0; dx < 5; dx++)
             m->tiles[7 + dy][28 + dx] = TILE_SHOP_ALCHEMIST;
 
+}
+
+void map_generate_town(Map *m, int *spawn_x, int *spawn_y) {
+    if (!town_ready) {
+        paint_town(&town);
+        town_ready = 1;
+    }
+    map_copy(m, &town);
+
     // Spawn at south end of vertical path
     *spawn_x = 20;
     *spawn_y = TOWN_H - 2;
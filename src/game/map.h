@@ -1,6 +1,9 @@
 #ifndef MAP_HEADER_H
 #define MAP_HEADER_H
 
+#include "rng.h"
+#include "tile.h"
+
 #define MAP_W 200
 #define MAP_H 100
 
@@ -16,39 +19,79 @@
 
 #define MAX_DEPTH 25
 
-typedef enum {
-    TILE_FLOOR = 0,
-    TILE_WALL,
-    TILE_STAIRS_UP,
-    TILE_STAIRS_DOWN,
-    TILE_TOWN_FLOOR,
-    TILE_TOWN_PATH,
-    TILE_TOWN_EXIT,
-    TILE_SHOP_BLACKSMITH,
-    TILE_SHOP_ALCHEMIST,
-    TILE_ITEM,
-    TILE_GOLD,
-    TILE_TRAP_HIDDEN,
-    TILE_TRAP_SPIKE,
-    TILE_TRAP_FIRE,
-    TILE_TRAP_POISON
-} TileType;
+#define BSP_FIRST_LEVEL 4 // levels from here on use LAYOUT_BSP
+
+#define MAX_CORRIDORS (2 * MAX_ROOMS + 2) // layout corridors plus repairs
+#define MAX_LINKS     96                  // room graph edges
 
 typedef struct {
     int x, y, w, h;
 } Room;
 
+// Carved horizontally from (x1, y1), then vertically to (x2, y2)
+typedef struct {
+    short x1, y1, x2, y2;
+} Corridor;
+
+// A walk between two rooms along carved corridors: from (ax, ay) in
+// room a to (bx, by) in room b, `len` steps long, never leaving the box
+// [x0, x1) x [y0, y1)
+typedef struct {
+    signed char a, b;
+    short       ax, ay, bx, by;
+    short       len;
+    short       x0, y0, x1, y1;
+} MapLink;
+
+typedef enum {
+    LAYOUT_SCATTER, // rejection-sampled rooms in the top-left quarter
+    LAYOUT_BSP      // partitioned rooms over the whole map, exact count
+} MapLayout;
+
+// Levels only use the top-left w x h corner of the tile grid. Anything
+// outside those bounds is never written, copied or saved, and reads back
+// as TILE_WALL through map_get_tile.
 typedef struct {
-    TileType tiles[MAP_H][MAP_W];
+    int      w, h;
     Room     rooms[MAX_ROOMS];
     int      room_count;
+    Corridor corridors[MAX_CORRIDORS];
+    int      corridor_count;
+    MapLink  links[MAX_LINKS]; // room graph, see map_build_room_graph
+    int      link_count;
     int      stairs_up_x,   stairs_up_y;
     int      stairs_down_x, stairs_down_y;
+    int      lair_x, lair_y; // boss spot marked by a lair vault, -1 if none
+    unsigned char tiles[MAP_H][MAP_W]; // TileType values, keep last (see map_copy)
 } Map;
 
 void map_generate(Map *m, int level);
+void map_generate_rng(Map *m, int level, Rng *rng);
+void map_generate_layout(Map *m, int level, MapLayout layout, Rng *rng);
+MapLayout map_layout_for_level(int level);
+// Check that the stairs down and every room center are reachable from the
+// stairs up, carving corridors to whatever is cut off, then turn the
+// level's corridors into its room graph (`links`). Returns the number of
+// corridors carved, or -1 if the level could not be joined up.
+int  map_connect_regions(Map *m);
+// Carve a corridor from the stairs up through every room center in turn
+// to the stairs down, which joins the level whatever else is in the way,
+// then rebuild the room graph. map_generate_layout falls back on it when
+// every reroll fails to connect.
+void map_chain_rooms(Map *m);
 int  map_is_walkable(const Map *m, int x, int y);
+TileType map_get_tile(const Map *m, int x, int y);
+void map_copy(Map *dst, const Map *src);
 void map_room_center(const Room *r, int *cx, int *cy);
+// Rebuild `links` from the rooms and corridors. Each corridor is cut
+// into pieces at the rooms it passes through, and pieces sharing a tile
+// also join every room at their ends, so the graph keeps the shortcuts
+// crossing corridors make. A level with more crossings or links than the
+// graph holds is left with none, and paths over it search the whole level.
+void map_build_room_graph(Map *m);
+// Index of the room containing (x, y), or -1
+int  map_room_at(const Map *m, int x, int y);
+// Copy of the town, which is painted once on first use
 void map_generate_town(Map *m, int *spawn_x, int *spawn_y);
 
 #endif
\ No newline at end of file
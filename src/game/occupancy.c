@@ -0,0 +1,32 @@
+#include "occupancy.h"
+#include <string.h>
+
+static int on_grid(int x, int y) {
+    return x >= 0 && x < MAP_W && y >= 0 && y < MAP_H;
+}
+
+void occupancy_build(Occupancy *o, const EnemyPool *p) {
+    memset(o->at, 0, sizeof(o->at));
+    for (int i = 0; i < p->count; i++)
+        if (p->active[i]) occupancy_move(o, p, i, -1, -1);
+}
+
+int occupancy_at(const Occupancy *o, const EnemyPool *p, int x, int y) {
+    if (!on_grid(x, y)) return OCCUPANCY_NONE;
+    int i = o->at[y][x] - 1;
+    if (i < 0 || i >= p->count) return OCCUPANCY_NONE;
+    return p->active[i] && p->x[i] == x && p->y[i] == y ? i : OCCUPANCY_NONE;
+}
+
+void occupancy_move(Occupancy *o, const EnemyPool *p, int i,
+                    int from_x, int from_y) {
+    if (on_grid(from_x, from_y) && o->at[from_y][from_x] == i + 1)
+        o->at[from_y][from_x] = 0;
+    int x = p->x[i], y = p->y[i];
+    if (on_grid(x, y)) o->at[y][x] = (uint16_t)(i + 1);
+}
+
+void occupancy_remove(Occupancy *o, const EnemyPool *p, int i) {
+    int x = p->x[i], y = p->y[i];
+    if (on_grid(x, y) && o->at[y][x] == i + 1) o->at[y][x] = 0;
+}
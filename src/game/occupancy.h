@@ -0,0 +1,32 @@
+#ifndef OCCUPANCY_HEADER_H
+#define OCCUPANCY_HEADER_H
+
+#include <stdint.h>
+#include "map.h"
+#include "enemy.h"
+
+// Which enemy stands on each tile, so "who is at (x, y)" is one lookup
+// instead of a scan of the enemy list. Built when a level is entered and
+// kept up to date as enemies move and die. Code that places enemies
+// behind its back (tests, editors) only makes lookups miss: a hit is
+// always checked against the enemy list, so it is never wrong.
+
+#define OCCUPANCY_NONE ENEMY_NONE
+
+typedef struct {
+    uint16_t at[MAP_H][MAP_W]; // enemy index + 1, 0 if empty
+} Occupancy;
+
+void occupancy_build(Occupancy *o, const EnemyPool *p);
+
+// Index of the active enemy standing on (x, y), or OCCUPANCY_NONE
+int  occupancy_at(const Occupancy *o, const EnemyPool *p, int x, int y);
+
+// Record that enemy `i` now stands where `p` says (after a move from
+// (from_x, from_y), or a spawn if that is off the map)
+void occupancy_move(Occupancy *o, const EnemyPool *p, int i,
+                    int from_x, int from_y);
+// Forget enemy `i`, e.g. once it has died
+void occupancy_remove(Occupancy *o, const EnemyPool *p, int i);
+
+#endif
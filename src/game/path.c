@@ -0,0 +1,234 @@
+#include "path.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CLOSED 0x80 // in dir[]: tile expanded, low bits hold the step into it
+
+typedef struct {
+    int x0, y0, x1, y1; // tiles [x0, x1) x [y0, y1)
+} Box;
+
+static const int DIR_X[4] = { 1, -1, 0,  0 };
+static const int DIR_Y[4] = { 0,  0, 1, -1 };
+
+// Search scratch for a whole level, kept out of the stack: paths are
+// found once per enemy when a level catches up, and at 7 bytes a tile
+// that is too much to ask of it every time. Paths are only found on the
+// game thread (generation never asks for one), so one set is enough.
+static uint16_t search_g[MAP_W * MAP_H];
+static uint8_t  search_dir[MAP_W * MAP_H];
+static uint16_t search_now[MAP_W * MAP_H], search_later[MAP_W * MAP_H];
+
+static void box_add(Box *b, int x, int y) {
+    if (x < b->x0)     b->x0 = x;
+    if (y < b->y0)     b->y0 = y;
+    if (x + 1 > b->x1) b->x1 = x + 1;
+    if (y + 1 > b->y1) b->y1 = y + 1;
+}
+
+static void box_add_room(Box *b, const Room *r) {
+    box_add(b, r->x, r->y);
+    box_add(b, r->x + r->w - 1, r->y + r->h - 1);
+}
+
+// A* from (sx, sy) to (gx, gy) without leaving the box; the steps are
+// appended to `out`. Steps cost 1 and the Manhattan heuristic changes by
+// exactly 1 per step, so f never drops and a neighbour's f is either the
+// current f or f + 2: the open list is just two stacks.
+static int search_box(const Map *m, Box b, int sx, int sy, int gx, int gy,
+                      Path *out) {
+    if (b.x0 < 0)    b.x0 = 0;
+    if (b.y0 < 0)    b.y0 = 0;
+    if (b.x1 > m->w) b.x1 = m->w;
+    if (b.y1 > m->h) b.y1 = m->h;
+    int bw = b.x1 - b.x0, bh = b.y1 - b.y0;
+    if (bw <= 0 || bh <= 0) return 0;
+
+    int area = bw * bh;
+    uint16_t *g = search_g, *now = search_now, *later = search_later;
+    uint8_t  *dir = search_dir;
+    int n_now = 0, n_later = 0;
+    memset(g, 0xFF, area * sizeof(g[0]));
+    memset(dir, 0, area * sizeof(dir[0]));
+
+    int start = (sy - b.y0) * bw + (sx - b.x0);
+    int goal  = (gy - b.y0) * bw + (gx - b.x0);
+    g[start] = 0;
+    now[n_now++] = (uint16_t)start;
+
+    int found = 0;
+    while (!found && (n_now > 0 || n_later > 0)) {
+        if (n_now == 0) {
+            memcpy(now, later, n_later * sizeof(now[0]));
+            n_now   = n_later;
+            n_later = 0;
+        }
+        int cur = now[--n_now];
+        if (dir[cur] & CLOSED) continue;
+        dir[cur] |= CLOSED;
+        if (cur == goal) {
+            found = 1;
+            break;
+        }
+
+        int cx = b.x0 + cur % bw, cy = b.y0 + cur / bw;
+        int h  = abs(cx - gx) + abs(cy - gy);
+        for (int d = 0; d < 4; d++) {
+            int nx = cx + DIR_X[d], ny = cy + DIR_Y[d];
+            if (nx < b.x0 || nx >= b.x1 || ny < b.y0 || ny >= b.y1) continue;
+            int next = (ny - b.y0) * bw + (nx - b.x0);
+            if ((dir[next] & CLOSED) || g[next] <= g[cur] + 1) continue;
+            if (!map_is_walkable(m, nx, ny)) continue;
+            g[next]   = (uint16_t)(g[cur] + 1);
+            dir[next] = (uint8_t)d;
+            if (abs(nx - gx) + abs(ny - gy) < h) now[n_now++]     = (uint16_t)next;
+            else                                 later[n_later++] = (uint16_t)next;
+        }
+    }
+    if (!found) return 0;
+
+    int steps = g[goal];
+    if (out->len + steps > PATH_MAX_LEN) return 0;
+    int at = goal;
+    for (int i = steps - 1; i >= 0; i--) {
+        int x = b.x0 + at % bw, y = b.y0 + at / bw;
+        out->cells[out->len + i] = (uint16_t)(y * MAP_W + x);
+        int d = dir[at] & 3;
+        at = (y - DIR_Y[d] - b.y0) * bw + (x - DIR_X[d] - b.x0);
+    }
+    out->len += steps;
+    return 1;
+}
+
+// Node 2i is link i's end in room a, node 2i + 1 its end in room b
+static void node_at(const Map *m, int n, int *x, int *y, int *room) {
+    const MapLink *l = &m->links[n / 2];
+    *x    = n & 1 ? l->bx : l->ax;
+    *y    = n & 1 ? l->by : l->ay;
+    *room = n & 1 ? l->b  : l->a;
+}
+
+static int links_valid(const Map *m) {
+    for (int i = 0; i < m->link_count; i++)
+        if (m->links[i].a < 0 || m->links[i].a >= m->room_count ||
+            m->links[i].b < 0 || m->links[i].b >= m->room_count) return 0;
+    return 1;
+}
+
+// A* over link ends. Rooms are open rectangles, so crossing one costs the
+// Manhattan distance between the ends in it; taking a link costs its
+// length. Writes the ends in walking order to `route` and returns how
+// many there are, or -1 if the goal cannot be reached this way.
+static int route_links(const Map *m, int sx, int sy, int room,
+                       int gx, int gy, int last, int *route) {
+    int nodes = m->link_count * 2;
+    int dist[MAX_LINKS * 2], prev[MAX_LINKS * 2], done[MAX_LINKS * 2];
+    int nx[MAX_LINKS * 2], ny[MAX_LINKS * 2], nroom[MAX_LINKS * 2];
+
+    for (int n = 0; n < nodes; n++) {
+        node_at(m, n, &nx[n], &ny[n], &nroom[n]);
+        dist[n] = nroom[n] == room ? abs(nx[n] - sx) + abs(ny[n] - sy) : -1;
+        prev[n] = -1;
+        done[n] = 0;
+    }
+    int best = room == last ? abs(gx - sx) + abs(gy - sy) : -1, best_end = -1;
+
+    for (;;) {
+        int cur = -1, cur_f = 0;
+        for (int n = 0; n < nodes; n++) {
+            if (done[n] || dist[n] < 0) continue;
+            int f = dist[n] + abs(nx[n] - gx) + abs(ny[n] - gy);
+            if (cur < 0 || f < cur_f) {
+                cur   = n;
+                cur_f = f;
+            }
+        }
+        if (cur < 0 || (best >= 0 && cur_f >= best)) break;
+        done[cur] = 1;
+
+        if (nroom[cur] == last) {
+            int d = dist[cur] + abs(nx[cur] - gx) + abs(ny[cur] - gy);
+            if (best < 0 || d < best) {
+                best     = d;
+                best_end = cur;
+            }
+        }
+        int other = cur ^ 1;
+        int d     = dist[cur] + m->links[cur / 2].len;
+        if (!done[other] && (dist[other] < 0 || d < dist[other])) {
+            dist[other] = d;
+            prev[other] = cur;
+        }
+        for (int n = 0; n < nodes; n++) {
+            if (done[n] || nroom[n] != nroom[cur]) continue;
+            d = dist[cur] + abs(nx[n] - nx[cur]) + abs(ny[n] - ny[cur]);
+            if (dist[n] < 0 || d < dist[n]) {
+                dist[n] = d;
+                prev[n] = cur;
+            }
+        }
+    }
+    if (best < 0) return -1;
+
+    int count = 0;
+    for (int n = best_end; n >= 0; n = prev[n]) count++;
+    int k = count;
+    for (int n = best_end; n >= 0; n = prev[n]) route[--k] = n;
+    return count;
+}
+
+static int find_by_rooms(const Map *m, int sx, int sy, int gx, int gy,
+                         Path *out) {
+    int room = map_room_at(m, sx, sy), last = map_room_at(m, gx, gy);
+    if (room < 0 || last < 0 || !links_valid(m)) return 0;
+
+    int route[MAX_LINKS * 2];
+    int ends = route_links(m, sx, sy, room, gx, gy, last, route);
+    if (ends < 0) return 0;
+
+    // Refine hop by hop: across a room boxed to the room, along a link
+    // boxed to the link
+    int x = sx, y = sy;
+    for (int i = 0; i <= ends; i++) {
+        int tx = gx, ty = gy, troom = last;
+        if (i < ends) node_at(m, route[i], &tx, &ty, &troom);
+
+        Box b = { x, y, x + 1, y + 1 };
+        box_add(&b, tx, ty);
+        if (i > 0 && route[i] == (route[i - 1] ^ 1)) {
+            const MapLink *l = &m->links[route[i] / 2];
+            box_add(&b, l->x0, l->y0);
+            box_add(&b, l->x1 - 1, l->y1 - 1);
+        } else {
+            box_add_room(&b, &m->rooms[troom]);
+        }
+        if ((x != tx || y != ty) && !search_box(m, b, x, y, tx, ty, out)) return 0;
+        x = tx;
+        y = ty;
+    }
+    return 1;
+}
+
+int path_find_flat(const Map *m, int sx, int sy, int gx, int gy, Path *out) {
+    out->len = 0;
+    if (!map_is_walkable(m, sx, sy) || !map_is_walkable(m, gx, gy)) return -1;
+    Box b = { 0, 0, m->w, m->h };
+    return search_box(m, b, sx, sy, gx, gy, out) ? out->len : -1;
+}
+
+int path_find(const Map *m, int sx, int sy, int gx, int gy, Path *out) {
+    out->len = 0;
+    if (!map_is_walkable(m, sx, sy) || !map_is_walkable(m, gx, gy)) return -1;
+    if (sx == gx && sy == gy) return 0;
+    if (find_by_rooms(m, sx, sy, gx, gy, out)) return out->len;
+    return path_find_flat(m, sx, sy, gx, gy, out);
+}
+
+int path_next_step(const Map *m, int sx, int sy, int gx, int gy,
+                   int *nx, int *ny) {
+    Path p;
+    if (path_find(m, sx, sy, gx, gy, &p) <= 0) return 0;
+    *nx = p.cells[0] % MAP_W;
+    *ny = p.cells[0] / MAP_W;
+    return 1;
+}
@@ -0,0 +1,30 @@
+#ifndef PATH_HEADER_H
+#define PATH_HEADER_H
+
+#include <stdint.h>
+#include "map.h"
+
+// 4-connected shortest paths over walkable tiles. path_find routes over
+// the map's room graph first (rooms joined by their recorded corridors),
+// then refines each leg with A* boxed to the two rooms and the corridor
+// between them, so a query only touches the tiles along the route. Maps
+// without a room graph (town, caves, old saves), or legs the boxed search
+// cannot finish, fall back to A* over the whole level. The search keeps
+// its scratch in static storage, so paths are found from one thread.
+
+#define PATH_MAX_LEN (MAP_W * MAP_H)
+
+typedef struct {
+    int      len;
+    uint16_t cells[PATH_MAX_LEN]; // y * MAP_W + x; start left out, goal last
+} Path;
+
+// Returns the number of steps, or -1 if the goal cannot be reached
+int path_find(const Map *m, int sx, int sy, int gx, int gy, Path *out);
+// Plain A* over the whole level; always shortest
+int path_find_flat(const Map *m, int sx, int sy, int gx, int gy, Path *out);
+// First step toward the goal. Returns 0 if there is none.
+int path_next_step(const Map *m, int sx, int sy, int gx, int gy,
+                   int *nx, int *ny);
+
+#endif
@@ -0,0 +1,65 @@
+#include "pregen.h"
+#include "game.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+#define PREGEN_STACK_SIZE (4 * 1024 * 1024)
+
+// Only the main thread touches `level` and `running`. The worker reads
+// its inputs after pthread_create and the main thread reads the results
+// after pthread_join, so no further locking is needed.
+static struct {
+    pthread_t thread;
+    int       running;
+    int       level;        // level in flight or ready, 0 if none
+    Rng       rng;
+    Map       map;
+    EnemyPool enemies;
+} job;
+
+static void *pregen_worker(void *arg) {
+    (void)arg;
+    map_generate_rng(&job.map, job.level, &job.rng);
+    enemies_spawn_level(&job.map, job.level, &job.enemies, &job.rng);
+    return NULL;
+}
+
+static void pregen_join(void) {
+    if (!job.running) return;
+    pthread_join(job.thread, NULL);
+    job.running = 0;
+}
+
+void pregen_request(int level) {
+    if (job.level == level) return;
+    pregen_join();
+
+    // Seed from the main sequence so srand() still reproduces a run
+    job.level = level;
+    rng_seed(&job.rng, (uint64_t)rand());
+    // Generation keeps scratch grids on the stack; some platforms give
+    // new threads as little as 512 KB
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, PREGEN_STACK_SIZE);
+    if (pthread_create(&job.thread, &attr, pregen_worker, NULL) == 0)
+        job.running = 1;
+    else
+        job.level = 0; // descending falls back to generating in place
+    pthread_attr_destroy(&attr);
+}
+
+int pregen_take(int level, Map *m, EnemyPool *enemies) {
+    if (level <= 0 || job.level != level) return 0;
+    pregen_join();
+
+    map_copy(m, &job.map);
+    *enemies = job.enemies;
+    job.level = 0;
+    return 1;
+}
+
+void pregen_shutdown(void) {
+    pregen_join();
+    job.level = 0;
+}
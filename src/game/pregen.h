@@ -0,0 +1,21 @@
+#ifndef PREGEN_HEADER_H
+#define PREGEN_HEADER_H
+
+#include "map.h"
+#include "enemy.h"
+
+// Background generation of the next dungeon level. A single worker
+// thread builds the level into its own buffers with its own RNG stream;
+// the game adopts the result when the player actually arrives.
+
+// Start generating `level` unless it is already in flight or ready.
+void pregen_request(int level);
+
+// Copy a finished `level` into the caller's buffers. Waits only if the
+// worker has not finished yet. Returns 0 if `level` was never requested.
+int  pregen_take(int level, Map *m, EnemyPool *enemies);
+
+// Wait for any in-flight job and drop its result. Call before exit.
+void pregen_shutdown(void);
+
+#endif
@@ -0,0 +1,118 @@
+#include "regions.h"
+#include "bitgrid.h"
+#include <string.h>
+
+// A row can hold at most one run per two tiles
+#define MAX_RUNS (MAP_H * (MAP_W / 2 + 1))
+
+typedef struct {
+    int16_t x0, x1; // tiles [x0, x1) of one row
+    int32_t id;
+} Run;
+
+// Store four ids per write instead of one
+static void fill_ids(uint16_t *dst, uint16_t id, int n) {
+    uint64_t pattern = id * 0x0001000100010001ULL;
+    for (; n >= 4; n -= 4, dst += 4) memcpy(dst, &pattern, 8);
+    while (n-- > 0) *dst++ = id;
+}
+
+static int find_root(int *parent, int i) {
+    while (parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+// The lower index always wins, so a root precedes every run it owns
+static void unite(int *parent, int a, int b) {
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a < b)      parent[b] = a;
+    else if (b < a) parent[a] = b;
+}
+
+int regions_build(Regions *r, const Map *m) {
+    BitGrid walk;
+    Run runs[MAX_RUNS];
+    int parent[MAX_RUNS];
+    int size[MAX_RUNS + 1];
+    int row_start[MAP_H + 1];
+    int n = 0;
+
+    bitgrid_from_map(&walk, m);
+
+    // Pass 1: cut each row into runs and join them to the row above.
+    // Run starts are open tiles after a closed one, ends closed tiles after
+    // an open one; they alternate, so each run costs two bit scans.
+    for (int y = 0; y < m->h; y++) {
+        row_start[y] = n;
+        uint64_t carry = 0; // last tile of the previous word was open
+        for (int i = 0; i < BITGRID_WORDS; i++) {
+            uint64_t w      = walk.rows[y][i];
+            uint64_t events = w ^ ((w << 1) | carry); // tile differs from the one before
+            carry = w >> 63;
+            while (events) {
+                int x = i * 64 + bitgrid_ctz64(events);
+                events &= events - 1;
+                if (n > row_start[y] && runs[n - 1].x1 < 0) {
+                    runs[n - 1].x1 = (int16_t)x;
+                } else {
+                    runs[n].x0 = (int16_t)x;
+                    runs[n].x1 = -1;
+                    parent[n]  = n;
+                    n++;
+                }
+            }
+        }
+        if (n > row_start[y] && runs[n - 1].x1 < 0)
+            runs[n - 1].x1 = (int16_t)(BITGRID_WORDS * 64);
+
+        if (y == 0) continue;
+        int a = row_start[y - 1], a_end = row_start[y];
+        for (int b = row_start[y]; b < n; b++) {
+            while (a < a_end && runs[a].x1 <= runs[b].x0) a++;
+            for (int k = a; k < a_end && runs[k].x0 < runs[b].x1; k++)
+                unite(parent, k, b);
+        }
+    }
+    row_start[m->h] = n;
+
+    // Pass 2: number the roots in order and paint every run
+    r->w = m->w;
+    r->h = m->h;
+    r->count        = 0;
+    r->largest      = REGION_NONE;
+    r->largest_size = 0;
+    for (int i = 0; i < n; i++) {
+        int root = find_root(parent, i);
+        if (root == i) {
+            runs[i].id = ++r->count;
+            size[r->count] = 0;
+        } else {
+            runs[i].id = runs[root].id;
+        }
+        size[runs[i].id] += runs[i].x1 - runs[i].x0;
+    }
+    for (int y = 0; y < m->h; y++) {
+        uint16_t *row = r->id[y];
+        memset(row, 0, m->w * sizeof(row[0])); // REGION_NONE
+        for (int i = row_start[y]; i < row_start[y + 1]; i++)
+            fill_ids(row + runs[i].x0, (uint16_t)runs[i].id, runs[i].x1 - runs[i].x0);
+    }
+    for (int id = 1; id <= r->count; id++) {
+        if (size[id] > r->largest_size) {
+            r->largest      = id;
+            r->largest_size = size[id];
+        }
+    }
+    return r->count;
+}
+
+int regions_id(const Regions *r, int x, int y) {
+    if (x < 0 || x >= r->w || y < 0 || y >= r->h) return REGION_NONE;
+    return r->id[y][x];
+}
+
+int regions_same(const Regions *r, int x1, int y1, int x2, int y2) {
+    int a = regions_id(r, x1, y1);
+    return a != REGION_NONE && a == regions_id(r, x2, y2);
+}
@@ -0,0 +1,31 @@
+#ifndef REGIONS_HEADER_H
+#define REGIONS_HEADER_H
+
+#include <stdint.h>
+#include "map.h"
+
+// Connected regions of walkable tiles (4-connected, the way the player
+// moves). Rebuilt whenever a level is entered; walls and anything
+// outside the level bounds have id REGION_NONE.
+
+#define REGION_NONE 0
+
+typedef struct {
+    uint16_t id[MAP_H][MAP_W];
+    int      w, h;         // bounds of the map it was built from
+    int      count;        // ids run 1..count
+    int      largest;      // id of the biggest region
+    int      largest_size;
+} Regions;
+
+// Label every walkable tile of `m`. Two passes over row runs: runs found
+// a word at a time from the walkable bit grid are unioned with the runs
+// they touch in the row above, then painted with their resolved id.
+// Returns the region count.
+int regions_build(Regions *r, const Map *m);
+
+int regions_id(const Regions *r, int x, int y);
+// 1 if both tiles are walkable and in the same region
+int regions_same(const Regions *r, int x1, int y1, int x2, int y2);
+
+#endif
@@ -0,0 +1,28 @@
+#include "rng.h"
+
+void rng_seed(Rng *r, uint64_t seed) {
+    // splitmix64 step so nearby seeds give unrelated streams and the
+    // state is never zero
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    r->state = z ? z : 0x2545f4914f6cdd1dULL;
+}
+
+uint32_t rng_next(Rng *r) {
+    uint64_t x = r->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    r->state = x;
+    return (uint32_t)((x * 0x2545f4914f6cdd1dULL) >> 32);
+}
+
+int rng_below(Rng *r, int n) {
+    return (int)(rng_next(r) % (uint32_t)n);
+}
+
+int rng_range(Rng *r, int min, int max) {
+    return min + rng_below(r, max - min + 1);
+}
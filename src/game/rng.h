@@ -0,0 +1,18 @@
+#ifndef RNG_HEADER_H
+#define RNG_HEADER_H
+
+#include <stdint.h>
+
+// Small self-contained random stream (xorshift64*). Each generator owns
+// its state, so level generation can run off the main thread without
+// touching the shared rand() sequence.
+typedef struct {
+    uint64_t state;
+} Rng;
+
+void     rng_seed(Rng *r, uint64_t seed);
+uint32_t rng_next(Rng *r);
+int      rng_below(Rng *r, int n);          // [0, n)
+int      rng_range(Rng *r, int min, int max); // [min, max]
+
+#endif
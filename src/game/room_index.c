@@ -0,0 +1,94 @@
+#include "room_index.h"
+#include <string.h>
+
+void room_index_build(RoomIndex *ri, const Map *m) {
+    int n = 0;
+
+    ri->w = m->w;
+    ri->h = m->h;
+    for (int y = 0; y < m->h; y++)
+        memset(ri->room_of[y], ROOM_NONE, m->w);
+
+    if (m->room_count == 0) {
+        ri->room_count = 1;
+        ri->start[0]   = 0;
+        for (int y = 0; y < m->h; y++) {
+            for (int x = 0; x < m->w; x++) {
+                if (!TILE_HAS(m->tiles[y][x], TRAIT_WALKABLE)) continue;
+                ri->room_of[y][x] = 0;
+                if (m->tiles[y][x] == TILE_FLOOR)
+                    ri->cells[n++] = (uint16_t)(y * MAP_W + x);
+            }
+        }
+        ri->free[0] = n;
+        return;
+    }
+
+    ri->room_count = m->room_count;
+    for (int i = 0; i < m->room_count; i++) {
+        const Room *r = &m->rooms[i];
+        ri->start[i] = n;
+        for (int y = r->y; y < r->y + r->h; y++) {
+            for (int x = r->x; x < r->x + r->w; x++) {
+                ri->room_of[y][x] = (signed char)i;
+                int edge = x == r->x || y == r->y ||
+                           x == r->x + r->w - 1 || y == r->y + r->h - 1;
+                if (!edge && m->tiles[y][x] == TILE_FLOOR)
+                    ri->cells[n++] = (uint16_t)(y * MAP_W + x);
+            }
+        }
+        ri->free[i] = n - ri->start[i];
+    }
+}
+
+int room_index_room_of(const RoomIndex *ri, int x, int y) {
+    if (x < 0 || x >= ri->w || y < 0 || y >= ri->h) return ROOM_NONE;
+    return ri->room_of[y][x];
+}
+
+int room_index_take(RoomIndex *ri, int room, Rng *rng, int *x, int *y) {
+    if (room < 0 || room >= ri->room_count || ri->free[room] == 0) return 0;
+
+    uint16_t *cells = &ri->cells[ri->start[room]];
+    int k = rng_below(rng, ri->free[room]);
+    int cell = cells[k];
+    cells[k] = cells[--ri->free[room]];
+    *x = cell % MAP_W;
+    *y = cell / MAP_W;
+    return 1;
+}
+
+int room_index_claim(RoomIndex *ri, int x, int y) {
+    int room = room_index_room_of(ri, x, y);
+    if (room < 0) return 0;
+
+    uint16_t *cells = &ri->cells[ri->start[room]];
+    for (int k = 0; k < ri->free[room]; k++) {
+        if (cells[k] != y * MAP_W + x) continue;
+        cells[k] = cells[--ri->free[room]];
+        return 1;
+    }
+    return 0;
+}
+
+// Pick uniformly among the non-full rooms in [lo, hi)
+static int pick_room(const RoomIndex *ri, int lo, int hi, Rng *rng) {
+    int open = 0;
+    for (int i = lo; i < hi; i++)
+        if (ri->free[i] > 0) open++;
+    if (open == 0) return -1;
+
+    int k = rng_below(rng, open);
+    for (int i = lo; i < hi; i++)
+        if (ri->free[i] > 0 && k-- == 0) return i;
+    return -1;
+}
+
+int room_index_take_any(RoomIndex *ri, int first_room, Rng *rng,
+                        int *x, int *y) {
+    if (first_room > ri->room_count) first_room = ri->room_count;
+    int room = pick_room(ri, first_room, ri->room_count, rng);
+    if (room < 0) room = pick_room(ri, 0, first_room, rng);
+    if (room < 0) return 0;
+    return room_index_take(ri, room, rng, x, y);
+}
@@ -0,0 +1,44 @@
+#ifndef ROOM_INDEX_HEADER_H
+#define ROOM_INDEX_HEADER_H
+
+#include <stdint.h>
+#include "map.h"
+#include "rng.h"
+
+// Which room each tile belongs to, plus a list of free floor cells per
+// room for spawn placement. Taking a cell is a swap-remove from its
+// room's list, so placement never retries and never lands two things on
+// one tile. A map without rooms (caves) is indexed as one pseudo-room
+// holding every floor tile.
+
+#define ROOM_NONE -1
+
+typedef struct {
+    signed char room_of[MAP_H][MAP_W]; // ROOM_NONE outside rooms
+    uint16_t    cells[MAP_W * MAP_H];  // y * MAP_W + x, grouped by room
+    int         start[MAX_ROOMS];      // first cell of each room
+    int         free[MAX_ROOMS];       // cells still free in each room
+    int         room_count;
+    int         w, h;                  // bounds of the indexed map
+} RoomIndex;
+
+// Free cells are plain TILE_FLOOR tiles inside a room, off its edge row
+// and column; stairs and traps already on the map are left out.
+void room_index_build(RoomIndex *ri, const Map *m);
+
+int  room_index_room_of(const RoomIndex *ri, int x, int y);
+
+// Take a random free cell of `room`. Returns 0 if the room is full.
+int  room_index_take(RoomIndex *ri, int room, Rng *rng, int *x, int *y);
+
+// Take the cell (x, y) itself, e.g. a spot marked by a vault. Returns 0
+// if it is not a free cell.
+int  room_index_claim(RoomIndex *ri, int x, int y);
+
+// Take a free cell from a random room numbered `first_room` or above,
+// or from the lower rooms once those are full. Returns 0 only when every
+// room is full.
+int  room_index_take_any(RoomIndex *ri, int first_room, Rng *rng,
+                         int *x, int *y);
+
+#endif
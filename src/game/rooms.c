@@ -0,0 +1,118 @@
+#include "rooms.h"
+
+static int rooms_overlap(const Room *a, const Room *b) {
+    return !(a->x + a->w + 1 < b->x ||
+             b->x + b->w + 1 < a->x ||
+             a->y + a->h + 1 < b->y ||
+             b->y + b->h + 1 < a->y);
+}
+
+int rooms_place_scatter(Room *rooms, int target, int area_w, int area_h,
+                        int attempts, RoomLink *links, int *link_count,
+                        Rng *rng) {
+    int count = 0;
+
+    for (int tries = 0; tries < attempts && count < target; tries++) {
+        Room r;
+        r.w = rng_range(rng, MIN_ROOM_W, MAX_ROOM_W);
+        r.h = rng_range(rng, MIN_ROOM_H, MAX_ROOM_H);
+        if (r.w > area_w - 2 || r.h > area_h - 2) continue;
+        r.x = rng_range(rng, 1, area_w - r.w - 1);
+        r.y = rng_range(rng, 1, area_h - r.h - 1);
+
+        // Check overlap with existing rooms
+        int overlaps = 0;
+        for (int i = 0; i < count; i++) {
+            if (rooms_overlap(&r, &rooms[i])) {
+                overlaps = 1;
+                break;
+            }
+        }
+        if (overlaps) continue;
+
+        // Connect to previous room
+        if (count > 0) {
+            links[count - 1].a = count - 1;
+            links[count - 1].b = count;
+        }
+        rooms[count++] = r;
+    }
+
+    *link_count = count > 0 ? count - 1 : 0;
+    return count;
+}
+
+// ── BSP ─────────────────────────────────────────────────────────────────
+
+typedef struct {
+    Room     *rooms;
+    RoomLink *links;
+    int       link_count;
+    Rng      *rng;
+} Bsp;
+
+static int room_size(Rng *rng, int min, int max, int cell) {
+    int s = rng_range(rng, min, max);
+    if (s > cell - 2) s = cell - 2;
+    return s < 1 ? 1 : s;
+}
+
+// Room in [lo, hi) nearest the cut: the one reaching furthest toward it
+// from before (`before_cut`), or starting closest to it from after
+static int room_at_cut(const Room *rooms, int lo, int hi, int vertical,
+                       int before_cut) {
+    int best = lo, best_v = 0;
+    for (int i = lo; i < hi; i++) {
+        const Room *r = &rooms[i];
+        int v = vertical ? r->x : r->y;
+        if (before_cut) v += vertical ? r->w : r->h;
+        else            v = -v;
+        if (i == lo || v > best_v) {
+            best   = i;
+            best_v = v;
+        }
+    }
+    return best;
+}
+
+// Fill the cell with `n` rooms stored at rooms[first .. first + n)
+static void bsp_split(Bsp *b, int x, int y, int w, int h, int first, int n) {
+    if (n == 1) {
+        Room *r = &b->rooms[first];
+        r->w = room_size(b->rng, MIN_ROOM_W, MAX_ROOM_W, w);
+        r->h = room_size(b->rng, MIN_ROOM_H, MAX_ROOM_H, h);
+        r->x = x + 1 + rng_below(b->rng, w - r->w - 1 > 0 ? w - r->w - 1 : 1);
+        r->y = y + 1 + rng_below(b->rng, h - r->h - 1 > 0 ? h - r->h - 1 : 1);
+        return;
+    }
+
+    // Cut across the longer side, in proportion to each half's share of
+    // the rooms, with a little jitter so the grid does not look regular
+    int n1 = n / 2, n2 = n - n1;
+    int vertical = w >= h;
+    int len = vertical ? w : h;
+    int cut = len * n1 / n;
+    int jitter = len / n / 4;
+    if (jitter > 0) cut += rng_range(b->rng, -jitter, jitter);
+    if (cut < n1)       cut = n1;
+    if (cut > len - n2) cut = len - n2;
+
+    if (vertical) {
+        bsp_split(b, x,       y, cut,     h, first,      n1);
+        bsp_split(b, x + cut, y, w - cut, h, first + n1, n2);
+    } else {
+        bsp_split(b, x, y,       w, cut,     first,      n1);
+        bsp_split(b, x, y + cut, w, h - cut, first + n1, n2);
+    }
+
+    RoomLink *l = &b->links[b->link_count++];
+    l->a = room_at_cut(b->rooms, first, first + n1, vertical, 1);
+    l->b = room_at_cut(b->rooms, first + n1, first + n, vertical, 0);
+}
+
+void rooms_place_bsp(Room *rooms, int count, int area_w, int area_h,
+                     RoomLink *links, Rng *rng) {
+    if (count <= 0) return;
+    Bsp b = { rooms, links, 0, rng };
+    bsp_split(&b, 0, 0, area_w, area_h, 0, count);
+}
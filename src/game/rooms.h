@@ -0,0 +1,30 @@
+#ifndef ROOMS_HEADER_H
+#define ROOMS_HEADER_H
+
+#include "map.h"
+
+// Room placement on an area_w x area_h rectangle, independent of Map so
+// it can run on buffers bigger than MAX_ROOMS. Rooms keep at least one
+// wall tile from the area edge. Links name pairs of rooms to connect
+// with corridors.
+
+typedef struct {
+    int a, b; // room indices
+} RoomLink;
+
+// Random rectangles, rejecting any that overlap an earlier room, until
+// `target` rooms fit or `attempts` run out. Rooms are linked in a chain.
+// Returns the number of rooms placed; *link_count gets placed - 1.
+int  rooms_place_scatter(Room *rooms, int target, int area_w, int area_h,
+                         int attempts, RoomLink *links, int *link_count,
+                         Rng *rng);
+
+// Binary space partition: every split divides the room budget between
+// its halves, so exactly `count` rooms come out in one pass with no
+// rejection. Links follow the split tree (count - 1 of them), joining
+// the two rooms facing each other across every cut. Rooms shrink to fit
+// cells smaller than MIN_ROOM_W/H + 2.
+void rooms_place_bsp(Room *rooms, int count, int area_w, int area_h,
+                     RoomLink *links, Rng *rng);
+
+#endif
@@ -0,0 +1,76 @@
+#include "schedule.h"
+#include <stddef.h>
+
+static int before(const ScheduleEntry *a, const ScheduleEntry *b) {
+    return a->time < b->time || (a->time == b->time && a->id < b->id);
+}
+
+static void place(Schedule *s, int at, ScheduleEntry e) {
+    s->heap[at]  = e;
+    s->pos[e.id] = at;
+}
+
+static void sift_up(Schedule *s, int at) {
+    ScheduleEntry e = s->heap[at];
+    while (at > 0) {
+        int parent = (at - 1) / 2;
+        if (!before(&e, &s->heap[parent])) break;
+        place(s, at, s->heap[parent]);
+        at = parent;
+    }
+    place(s, at, e);
+}
+
+static void sift_down(Schedule *s, int at) {
+    ScheduleEntry e = s->heap[at];
+    for (;;) {
+        int child = 2 * at + 1;
+        if (child >= s->count) break;
+        if (child + 1 < s->count && before(&s->heap[child + 1], &s->heap[child]))
+            child++;
+        if (!before(&s->heap[child], &e)) break;
+        place(s, at, s->heap[child]);
+        at = child;
+    }
+    place(s, at, e);
+}
+
+void schedule_init(Schedule *s) {
+    s->count = 0;
+    for (int i = 0; i < SCHEDULE_MAX; i++) s->pos[i] = SCHEDULE_NONE;
+}
+
+int schedule_has(const Schedule *s, int id) {
+    return id >= 0 && id < SCHEDULE_MAX && s->pos[id] != SCHEDULE_NONE;
+}
+
+void schedule_add(Schedule *s, int id, int time) {
+    if (id < 0 || id >= SCHEDULE_MAX) return;
+    if (schedule_has(s, id)) schedule_remove(s, id);
+    place(s, s->count, (ScheduleEntry){ time, id });
+    sift_up(s, s->count++);
+}
+
+void schedule_remove(Schedule *s, int id) {
+    if (!schedule_has(s, id)) return;
+    int at = s->pos[id];
+    s->pos[id] = SCHEDULE_NONE;
+    if (at == --s->count) return;
+    // The last entry fills the hole and moves whichever way it belongs
+    int moved = s->heap[s->count].id;
+    place(s, at, s->heap[s->count]);
+    sift_up(s, at);
+    sift_down(s, s->pos[moved]);
+}
+
+int schedule_peek(const Schedule *s, int *time) {
+    if (s->count == 0) return SCHEDULE_NONE;
+    if (time) *time = s->heap[0].time;
+    return s->heap[0].id;
+}
+
+int schedule_pop(Schedule *s) {
+    int id = schedule_peek(s, NULL);
+    if (id != SCHEDULE_NONE) schedule_remove(s, id);
+    return id;
+}
@@ -0,0 +1,34 @@
+#ifndef SCHEDULE_HEADER_H
+#define SCHEDULE_HEADER_H
+
+#include "enemy.h"
+
+// Who acts next: a binary min-heap of actors keyed on the tick each next
+// acts, ties going to the lower id so actors due together act in list
+// order. Popping the k actors due this turn costs O(k log n); the rest
+// are never looked at. `pos` finds an actor's entry so one that dies or
+// falls asleep is taken out directly.
+
+#define SCHEDULE_MAX  MAX_ENEMIES
+#define SCHEDULE_NONE -1
+
+typedef struct {
+    int time, id;
+} ScheduleEntry;
+
+typedef struct {
+    ScheduleEntry heap[SCHEDULE_MAX];
+    int           count;
+    int           pos[SCHEDULE_MAX]; // index in `heap`, SCHEDULE_NONE if absent
+} Schedule;
+
+void schedule_init(Schedule *s);
+int  schedule_has(const Schedule *s, int id);
+// Add `id` to act at `time`, or move it there if already scheduled
+void schedule_add(Schedule *s, int id, int time);
+void schedule_remove(Schedule *s, int id);
+// The actor due first and when, without taking it out, or SCHEDULE_NONE
+int  schedule_peek(const Schedule *s, int *time);
+int  schedule_pop(Schedule *s);
+
+#endif
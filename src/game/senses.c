@@ -0,0 +1,157 @@
+#include "senses.h"
+#include <string.h>
+
+void senses_init(Senses *s) {
+    memset(s, 0, sizeof(*s));
+    s->region = REGION_NONE;
+}
+
+static void clear_box(Senses *s) {
+    for (int y = s->y0; y < s->y1; y++) {
+        memset(&s->scent[y][s->x0], 0, (size_t)(s->x1 - s->x0) * sizeof(s->scent[0][0]));
+        memset(&s->noise[y][s->x0], 0, (size_t)(s->x1 - s->x0));
+    }
+    s->loud = 0;
+}
+
+// Cover region `id`: the box around its tiles
+static void cover(Senses *s, const Regions *r, int id) {
+    clear_box(s);
+    s->region = id;
+    s->x0 = MAP_W; s->y0 = MAP_H; s->x1 = s->y1 = 0;
+    for (int y = 0; y < r->h; y++)
+        for (int x = 0; x < r->w; x++) {
+            if (r->id[y][x] != id) continue;
+            if (x < s->x0) s->x0 = x;
+            if (y < s->y0) s->y0 = y;
+            if (x >= s->x1) s->x1 = x + 1;
+            if (y >= s->y1) s->y1 = y + 1;
+        }
+    if (s->x1 == 0) s->x0 = s->y0 = 0; // no tiles: an empty box
+}
+
+// Row y of `open` as one byte per tile, 1 if walkable, with a closed
+// tile either side of the box: out[x + 1] for tile x
+static void unpack_row(const BitGrid *open, int y, int x0, int x1, uint8_t *out) {
+    out[x0] = out[x1 + 1] = 0;
+    if (y < 0 || y >= MAP_H) {
+        memset(&out[x0 + 1], 0, (size_t)(x1 - x0));
+        return;
+    }
+    for (int x = x0; x < x1; x++)
+        out[x + 1] = (uint8_t)((open->rows[y][x / 64] >> (x % 64)) & 1);
+}
+
+// Each tile moves an eighth of the way toward each open neighbour, so
+// scent flows along corridors without leaking into walls, then fades
+static void spread_scent(Senses *s, const BitGrid *open) {
+    uint16_t rows[2][MAP_W + 2], zero[MAP_W + 2] = {0};
+    uint8_t  masks[3][MAP_W + 2];
+    int x0 = s->x0, x1 = s->x1;
+    uint16_t *up = zero, *here = rows[0], *spare = rows[1];
+    uint8_t *mu = masks[0], *m = masks[1], *md = masks[2];
+    unpack_row(open, -1, x0, x1, mu); // nothing above the box
+    unpack_row(open, s->y0, x0, x1, m);
+    for (int y = s->y0; y < s->y1; y++) {
+        // The copies are padded: tile x of a copy is at x + 1
+        uint16_t *row = s->scent[y];
+        const uint16_t *down = y + 1 < s->y1 ? &s->scent[y + 1][0] : NULL;
+        unpack_row(open, y + 1 < s->y1 ? y + 1 : -1, x0, x1, md);
+        memcpy(&here[x0 + 1], &row[x0], (size_t)(x1 - x0) * sizeof(uint16_t));
+        here[x0] = here[x1 + 1] = 0;
+        for (int x = x0; x < x1; x++) {
+            uint32_t c    = here[x + 1];
+            uint32_t open_n = (uint32_t)mu[x + 1] + md[x + 1] + m[x] + m[x + 2];
+            uint32_t sum  = (uint32_t)up[x + 1] + here[x] + here[x + 2] + (down ? down[x] : 0);
+            uint32_t v    = ((8 - open_n) * c + sum) >> 3;
+            row[x] = (uint16_t)(m[x + 1] * ((v * SCENT_KEEP) >> 8));
+        }
+        // The untouched copy of this row is the next one's row above
+        up = here;
+        here = spare;
+        spare = up;
+        uint8_t *t = mu; mu = m; m = md; md = t;
+    }
+}
+
+// One tile of travel: each tile hears the loudest neighbour, one quieter
+static int carry_noise(Senses *s, const BitGrid *open) {
+    uint8_t rows[2][MAP_W + 2], zero[MAP_W + 2] = {0}, mask[MAP_W + 2];
+    int x0 = s->x0, x1 = s->x1, changed = 0;
+    uint8_t *up = zero, *here = rows[0], *spare = rows[1];
+    for (int y = s->y0; y < s->y1; y++) {
+        uint8_t *row = s->noise[y];
+        const uint8_t *down = y + 1 < s->y1 ? s->noise[y + 1] : NULL;
+        unpack_row(open, y, x0, x1, mask);
+        memcpy(&here[x0 + 1], &row[x0], (size_t)(x1 - x0));
+        here[x0] = here[x1 + 1] = 0;
+        for (int x = x0; x < x1; x++) {
+            int n = up[x + 1];
+            if (here[x] > n) n = here[x];
+            if (here[x + 2] > n) n = here[x + 2];
+            if (down && down[x] > n) n = down[x];
+            n = n > 0 ? n - 1 : 0;
+            int v = here[x + 1] > n ? here[x + 1] : n;
+            v *= mask[x + 1];
+            changed |= v != here[x + 1];
+            row[x] = (uint8_t)v;
+        }
+        up = here;
+        here = spare;
+        spare = up;
+    }
+    return changed;
+}
+
+static void fade_noise(Senses *s) {
+    int loud = 0;
+    for (int y = s->y0; y < s->y1; y++)
+        for (int x = s->x0; x < s->x1; x++) {
+            int v = s->noise[y][x];
+            v = v > NOISE_FADE ? v - NOISE_FADE : 0;
+            s->noise[y][x] = (uint8_t)v;
+            loud |= v;
+        }
+    s->loud = loud != 0;
+}
+
+void senses_update(Senses *s, const Regions *r, const BitGrid *open, int px, int py) {
+    int id = regions_id(r, px, py);
+    if (id == REGION_NONE) return;
+    if (id != s->region) cover(s, r, id);
+
+    spread_scent(s, open);
+    s->scent[py][px] = SCENT_FRESH;
+
+    if (s->loud) fade_noise(s);
+    s->fresh = 0;
+    for (int i = 0; i < s->sound_count; i++) {
+        int x = s->sounds[i].x, y = s->sounds[i].y;
+        if (x < s->x0 || x >= s->x1 || y < s->y0 || y >= s->y1 || !bitgrid_get(open, x, y))
+            continue;
+        if (s->noise[y][x] < s->sounds[i].loudness) s->noise[y][x] = s->sounds[i].loudness;
+        s->loud  = 1;
+        s->fresh = 1;
+    }
+    s->sound_count = 0;
+    if (s->loud)
+        for (int step = 0; step < NOISE_STEPS && carry_noise(s, open); step++) {}
+}
+
+void senses_noise(Senses *s, int x, int y, int loudness) {
+    if (s->sound_count >= MAX_SOUNDS || loudness <= 0) return;
+    s->sounds[s->sound_count].x = (int16_t)x;
+    s->sounds[s->sound_count].y = (int16_t)y;
+    s->sounds[s->sound_count].loudness = (uint8_t)(loudness > 255 ? 255 : loudness);
+    s->sound_count++;
+}
+
+int senses_scent(const Senses *s, int x, int y) {
+    if (x < 0 || x >= MAP_W || y < 0 || y >= MAP_H) return 0;
+    return s->scent[y][x];
+}
+
+int senses_heard(const Senses *s, int x, int y) {
+    if (x < 0 || x >= MAP_W || y < 0 || y >= MAP_H) return 0;
+    return s->noise[y][x];
+}
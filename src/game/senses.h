@@ -0,0 +1,57 @@
+#ifndef SENSES_HEADER_H
+#define SENSES_HEADER_H
+
+#include <stdint.h>
+#include "bitgrid.h"
+#include "regions.h"
+
+// What enemies can smell and hear: two fields over the player's region,
+// stepped once a turn by 4-neighbour stencils over the walkable bit grid.
+//
+// Scent is laid where the player stands and spreads out and fades: each
+// tile moves an eighth of the way toward each open neighbour, then keeps
+// SCENT_KEEP/256 of what it has. A trail goes cold over a few dozen turns.
+//
+// Noise is made by fighting and carries NOISE_STEPS tiles a turn, losing
+// one unit per tile (a sound of loudness n is heard n tiles away), then
+// fades by NOISE_FADE a turn. Walls stop both.
+//
+// Only the box around the player's region is stepped, a fixed cost per
+// turn however the rest of the level looks; noise is skipped while
+// everything is quiet.
+
+#define SCENT_FRESH 0xFFFF
+#define SCENT_KEEP  248
+#define NOISE_STEPS 16
+#define NOISE_FADE  4
+#define MAX_SOUNDS  16 // made between two updates; more are dropped
+
+// How loud things are, in tiles
+#define NOISE_FIGHT 10
+#define NOISE_TRAP  10
+#define NOISE_BLAST 16
+
+typedef struct {
+    uint16_t scent[MAP_H][MAP_W];
+    uint8_t  noise[MAP_H][MAP_W];
+    int      region;         // the fields cover this region, REGION_NONE if none yet
+    int      x0, y0, x1, y1; // its box, [x0, x1) x [y0, y1)
+    int      loud;           // some tile has noise
+    int      fresh;          // the last update spread new sounds
+    struct { int16_t x, y; uint8_t loudness; } sounds[MAX_SOUNDS]; // not yet spread
+    int      sound_count;
+} Senses;
+
+void senses_init(Senses *s);
+
+// One turn: lay scent at the player's (px, py), then spread and fade both
+// fields through `open`. Moving to another region starts the fields over.
+void senses_update(Senses *s, const Regions *r, const BitGrid *open, int px, int py);
+
+// A sound of `loudness` at (x, y), spread by the next update
+void senses_noise(Senses *s, int x, int y, int loudness);
+
+int  senses_scent(const Senses *s, int x, int y); // 0 off the map
+int  senses_heard(const Senses *s, int x, int y); // 0 off the map
+
+#endif
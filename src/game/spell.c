@@ -1,4 +1,5 @@
 #include "spell.h"
+#include "aoe.h"
 #include <string.h>
 
 Spell spell_make_magic_arrow(void) {
@@ -23,6 +24,7 @@ Spell spell_make_fireball(void) {
     s.damage  = 25;
     s.range   = 4;
     s.radius  = 2;
+    s.shape   = AOE_DIAMOND;
     s.heal_hp = 0;
     return s;
 }
@@ -24,6 +24,7 @@ typedef struct {
     int       heal_hp;
     int       range;
     int       radius;
+    int       shape;   // AoeShape of a SPELL_TYPE_DAMAGE_AREA blast
 } Spell;
 
 Spell spell_make_magic_arrow(void);
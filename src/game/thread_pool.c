@@ -0,0 +1,82 @@
+#include "thread_pool.h"
+#include <unistd.h>
+
+// Same reasoning as pregen: generation keeps scratch grids on the stack
+#define POOL_STACK_SIZE (4 * 1024 * 1024)
+
+// Called and returns with the lock held
+static void work(ThreadPool *p) {
+    while (p->next < p->count) {
+        int i = p->next++;
+        p->busy++;
+        pthread_mutex_unlock(&p->lock);
+        p->task(p->ctx, i);
+        pthread_mutex_lock(&p->lock);
+        p->busy--;
+    }
+    if (p->busy == 0) pthread_cond_broadcast(&p->idle);
+}
+
+static void *worker_main(void *arg) {
+    ThreadPool *p = arg;
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        while (!p->quit && p->next >= p->count)
+            pthread_cond_wait(&p->wake, &p->lock);
+        if (p->quit) break;
+        work(p);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+int pool_init(ThreadPool *p, int threads) {
+    p->worker_count = 0;
+    p->next = p->count = p->busy = 0;
+    p->quit = 0;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->wake, NULL);
+    pthread_cond_init(&p->idle, NULL);
+
+    if (threads > POOL_MAX_THREADS + 1) threads = POOL_MAX_THREADS + 1;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, POOL_STACK_SIZE);
+    for (int i = 0; i < threads - 1; i++) {
+        if (pthread_create(&p->workers[p->worker_count], &attr, worker_main, p) != 0)
+            break;
+        p->worker_count++;
+    }
+    pthread_attr_destroy(&attr);
+    return p->worker_count + 1;
+}
+
+void pool_run(ThreadPool *p, int count, PoolTask task, void *ctx) {
+    pthread_mutex_lock(&p->lock);
+    p->task  = task;
+    p->ctx   = ctx;
+    p->next  = 0;
+    p->count = count;
+    pthread_cond_broadcast(&p->wake);
+    work(p);
+    while (p->busy > 0)
+        pthread_cond_wait(&p->idle, &p->lock);
+    pthread_mutex_unlock(&p->lock);
+}
+
+void pool_free(ThreadPool *p) {
+    pthread_mutex_lock(&p->lock);
+    p->quit = 1;
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+    for (int i = 0; i < p->worker_count; i++)
+        pthread_join(p->workers[i], NULL);
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->wake);
+    pthread_cond_destroy(&p->idle);
+}
+
+int pool_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n < 1 ? 1 : (int)n;
+}
@@ -0,0 +1,34 @@
+#ifndef THREAD_POOL_HEADER_H
+#define THREAD_POOL_HEADER_H
+
+#include <pthread.h>
+
+#define POOL_MAX_THREADS 64
+
+// Runs `fn(ctx, i)` for every i in [0, count) across a fixed set of
+// threads. The thread calling pool_run works through the indices too,
+// so a pool of one thread spawns nothing and runs everything in place.
+typedef void (*PoolTask)(void *ctx, int index);
+
+typedef struct {
+    pthread_t       workers[POOL_MAX_THREADS];
+    int             worker_count;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake; // new indices to hand out, or quitting
+    pthread_cond_t  idle; // the last index of a run finished
+    PoolTask        task;
+    void           *ctx;
+    int             next, count, busy;
+    int             quit;
+} ThreadPool;
+
+// `threads` counts the caller. Returns the number of threads the pool
+// ended up with, which is lower if some could not be started.
+int  pool_init(ThreadPool *p, int threads);
+// Blocks until every index has run
+void pool_run(ThreadPool *p, int count, PoolTask task, void *ctx);
+void pool_free(ThreadPool *p);
+// Online CPUs, at least 1
+int  pool_cpu_count(void);
+
+#endif
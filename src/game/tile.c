@@ -0,0 +1,25 @@
+#include "tile.h"
+
+#define MINIMAP_FLOOR  0x464664
+#define MINIMAP_STAIRS 0xDCB43C
+
+const TileTraits TILE_TRAITS[256] = {
+    [TILE_FLOOR]           = { TRAIT_WALKABLE,                 SPRITE_FLOOR,           1, 0, MINIMAP_FLOOR },
+    [TILE_WALL]            = { TRAIT_OPAQUE,                   SPRITE_WALL,            0, 0, 0 },
+    [TILE_STAIRS_UP]       = { TRAIT_WALKABLE | TRAIT_INTERACT, SPRITE_STAIRS_UP,       2, 0, MINIMAP_STAIRS },
+    [TILE_STAIRS_DOWN]     = { TRAIT_WALKABLE | TRAIT_INTERACT, SPRITE_STAIRS_DOWN,     2, 0, MINIMAP_STAIRS },
+    [TILE_TOWN_FLOOR]      = { TRAIT_WALKABLE,                 SPRITE_TOWN_FLOOR,      1, 0, MINIMAP_FLOOR },
+    [TILE_TOWN_PATH]       = { TRAIT_WALKABLE,                 SPRITE_TOWN_PATH,       1, 0, MINIMAP_FLOOR },
+    [TILE_TOWN_EXIT]       = { TRAIT_WALKABLE | TRAIT_INTERACT, SPRITE_TOWN_EXIT,       1, 0, MINIMAP_FLOOR },
+    [TILE_SHOP_BLACKSMITH] = { TRAIT_WALKABLE | TRAIT_INTERACT | TRAIT_SHOP,
+                               SPRITE_SHOP_BLACKSMITH, 1, SHOP_TYPE_BLACKSMITH, MINIMAP_FLOOR },
+    [TILE_SHOP_ALCHEMIST]  = { TRAIT_WALKABLE | TRAIT_INTERACT | TRAIT_SHOP,
+                               SPRITE_SHOP_ALCHEMIST,  1, SHOP_TYPE_ALCHEMIST,  MINIMAP_FLOOR },
+    [TILE_ITEM]            = { TRAIT_WALKABLE | TRAIT_INTERACT, SPRITE_ITEM,            1, 0, MINIMAP_FLOOR },
+    [TILE_GOLD]            = { TRAIT_WALKABLE | TRAIT_INTERACT, SPRITE_GOLD,            1, 0, MINIMAP_FLOOR },
+    // Hidden traps pass for floor until stepped on
+    [TILE_TRAP_HIDDEN]     = { TRAIT_WALKABLE | TRAIT_TRAP,     SPRITE_FLOOR,           1, 0, MINIMAP_FLOOR },
+    [TILE_TRAP_SPIKE]      = { TRAIT_WALKABLE | TRAIT_TRAP,     SPRITE_TRAP_SPIKE,      1, 0, MINIMAP_FLOOR },
+    [TILE_TRAP_FIRE]       = { TRAIT_WALKABLE | TRAIT_TRAP,     SPRITE_TRAP_FIRE,       1, 0, MINIMAP_FLOOR },
+    [TILE_TRAP_POISON]     = { TRAIT_WALKABLE | TRAIT_TRAP,     SPRITE_TRAP_POISON,     1, 0, MINIMAP_FLOOR },
+};
@@ -0,0 +1,76 @@
+#ifndef TILE_HEADER_H
+#define TILE_HEADER_H
+
+#include <stdint.h>
+
+typedef enum {
+    TILE_FLOOR = 0,
+    TILE_WALL,
+    TILE_STAIRS_UP,
+    TILE_STAIRS_DOWN,
+    TILE_TOWN_FLOOR,
+    TILE_TOWN_PATH,
+    TILE_TOWN_EXIT,
+    TILE_SHOP_BLACKSMITH,
+    TILE_SHOP_ALCHEMIST,
+    TILE_ITEM,
+    TILE_GOLD,
+    TILE_TRAP_HIDDEN,
+    TILE_TRAP_SPIKE,
+    TILE_TRAP_FIRE,
+    TILE_TRAP_POISON,
+    TILE_COUNT
+} TileType;
+
+// What each kind of tile is, in one place. Adding a tile kind means a
+// TileType value and a row in TILE_TRAITS (tile.c); movement, the map
+// view and the minimap all read from there.
+
+enum {
+    TRAIT_WALKABLE = 1 << 0,
+    TRAIT_OPAQUE   = 1 << 1, // blocks sight
+    TRAIT_INTERACT = 1 << 2, // stepping on or next to it does something
+    TRAIT_TRAP     = 1 << 3,
+    TRAIT_SHOP     = 1 << 4  // `shop` says which
+};
+
+// What the renderer draws for a tile. Wall is 0 so that any byte
+// without a row in the table draws, and blocks, like a wall.
+typedef enum {
+    SPRITE_WALL = 0,
+    SPRITE_FLOOR,
+    SPRITE_STAIRS_UP,
+    SPRITE_STAIRS_DOWN,
+    SPRITE_TOWN_FLOOR,
+    SPRITE_TOWN_PATH,
+    SPRITE_TOWN_EXIT,
+    SPRITE_SHOP_BLACKSMITH,
+    SPRITE_SHOP_ALCHEMIST,
+    SPRITE_ITEM,
+    SPRITE_GOLD,
+    SPRITE_TRAP_SPIKE,
+    SPRITE_TRAP_FIRE,
+    SPRITE_TRAP_POISON,
+    SPRITE_COUNT
+} TileSprite;
+
+// The shop a TRAIT_SHOP tile opens
+typedef enum {
+    SHOP_TYPE_ALCHEMIST,
+    SHOP_TYPE_BLACKSMITH
+} ShopType;
+
+typedef struct {
+    uint8_t  flags;        // TRAIT_*
+    uint8_t  sprite;       // TileSprite
+    uint8_t  minimap_rank; // 0 leaves it off the minimap; higher wins a shared dot
+    uint8_t  shop;         // ShopType of TRAIT_SHOP tiles
+    uint32_t minimap_rgb;  // 0xRRGGBB
+} TileTraits;
+
+// One row per byte value so tiles index it without a range check
+extern const TileTraits TILE_TRAITS[256];
+
+#define TILE_HAS(tile, trait) ((TILE_TRAITS[(uint8_t)(tile)].flags & (trait)) != 0)
+
+#endif
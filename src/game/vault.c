@@ -0,0 +1,209 @@
+#include "vault.h"
+#include "pregen.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ORIENTATIONS     8  // bit 0 mirrors x, bit 1 mirrors y, bit 2 transposes
+#define VAULT_ROLLS      2  // treasure / gauntlet chances per level
+#define VAULT_CHANCE     40 // percent per roll
+
+typedef struct {
+    int            kind, min_level, max_level;
+    int            w[ORIENTATIONS], h[ORIENTATIONS];
+    int            mark_x[ORIENTATIONS], mark_y[ORIENTATIONS];
+    const uint8_t *tiles[ORIENTATIONS]; // row-major, w * h
+} Prefab;
+
+static struct {
+    void    *data;   // the mapped file; orientation 0 points into it
+    size_t   size;
+    uint8_t *turned; // orientations 1-7 of every prefab
+    Prefab   prefabs[VAULT_MAX_PREFABS];
+    int      count;
+} lib;
+
+static int tile_allowed(uint8_t t) {
+    return t == TILE_FLOOR || t == TILE_WALL || t == TILE_TRAP_HIDDEN ||
+           t == TILE_GOLD;
+}
+
+static void orient(Prefab *p, int o, uint8_t *out) {
+    int w = p->w[0], h = p->h[0];
+    int ow = o & 4 ? h : w, oh = o & 4 ? w : h;
+    p->w[o] = ow;
+    p->h[o] = oh;
+    p->mark_x[o] = p->mark_y[o] = VAULT_NO_MARK;
+    for (int y = 0; y < oh; y++) {
+        for (int x = 0; x < ow; x++) {
+            int ux = o & 1 ? ow - 1 - x : x;
+            int uy = o & 2 ? oh - 1 - y : y;
+            int sx = o & 4 ? uy : ux, sy = o & 4 ? ux : uy;
+            out[y * ow + x] = p->tiles[0][sy * w + sx];
+            if (sx == p->mark_x[0] && sy == p->mark_y[0]) {
+                p->mark_x[o] = x;
+                p->mark_y[o] = y;
+            }
+        }
+    }
+    p->tiles[o] = out;
+}
+
+// Check the mapped file and fill in lib.prefabs. Returns 0 if malformed.
+static int index_library(void) {
+    const uint8_t *b = lib.data;
+    if (memcmp(b, VAULT_MAGIC, 4) != 0) return 0;
+    if ((b[4] | b[5] << 8) != VAULT_VERSION) return 0;
+    int count = b[6] | b[7] << 8;
+    if (count > VAULT_MAX_PREFABS) return 0;
+
+    size_t at = VAULT_FILE_HEADER, turned = 0;
+    for (int i = 0; i < count; i++) {
+        if (at + VAULT_HEADER > lib.size) return 0;
+        const uint8_t *h = b + at;
+        Prefab *p = &lib.prefabs[i];
+        p->kind      = h[0];
+        p->min_level = h[1];
+        p->max_level = h[2];
+        p->w[0]      = h[3];
+        p->h[0]      = h[4];
+        p->mark_x[0] = h[5];
+        p->mark_y[0] = h[6];
+        p->tiles[0]  = h + VAULT_HEADER;
+        int area = p->w[0] * p->h[0];
+
+        if (p->kind >= VAULT_KINDS || p->min_level > p->max_level) return 0;
+        if (p->w[0] < 1 || p->w[0] > VAULT_MAX_SIDE ||
+            p->h[0] < 1 || p->h[0] > VAULT_MAX_SIDE) return 0;
+        if (at + VAULT_HEADER + area > lib.size) return 0;
+        for (int t = 0; t < area; t++)
+            if (!tile_allowed(p->tiles[0][t])) return 0;
+        if (p->mark_x[0] != VAULT_NO_MARK) {
+            if (p->mark_x[0] >= p->w[0] || p->mark_y[0] >= p->h[0]) return 0;
+            if (p->tiles[0][p->mark_y[0] * p->w[0] + p->mark_x[0]] != TILE_FLOOR)
+                return 0;
+        } else if (p->kind == VAULT_LAIR) {
+            return 0;
+        }
+        at     += VAULT_HEADER + area;
+        turned += (ORIENTATIONS - 1) * area;
+    }
+
+    lib.turned = malloc(turned ? turned : 1);
+    if (!lib.turned) return 0;
+    uint8_t *out = lib.turned;
+    for (int i = 0; i < count; i++) {
+        Prefab *p = &lib.prefabs[i];
+        for (int o = 1; o < ORIENTATIONS; o++) {
+            orient(p, o, out);
+            out += p->w[0] * p->h[0];
+        }
+    }
+    lib.count = count;
+    return 1;
+}
+
+int vault_library_load(const char *path) {
+    vault_library_free();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= VAULT_FILE_HEADER)
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return -1;
+
+    lib.data = data;
+    lib.size = (size_t)st.st_size;
+    if (!index_library()) {
+        vault_library_free();
+        return -1;
+    }
+    return lib.count;
+}
+
+void vault_library_free(void) {
+    pregen_shutdown(); // its level may be mid-stamp from this library
+    if (lib.data) munmap(lib.data, lib.size);
+    free(lib.turned);
+    memset(&lib, 0, sizeof(lib));
+}
+
+int vault_library_count(void) {
+    return lib.count;
+}
+
+// A random prefab of `kind` for `level`, or -1
+static int pick(int kind, int level, Rng *rng) {
+    int chosen = -1, seen = 0;
+    for (int i = 0; i < lib.count; i++) {
+        const Prefab *p = &lib.prefabs[i];
+        if (p->kind != kind || level < p->min_level || level > p->max_level) continue;
+        if (rng_below(rng, ++seen) == 0) chosen = i;
+    }
+    return chosen;
+}
+
+// Stamp `p` into the first free room it fits, trying rooms and
+// orientations from a random start. Returns the room, or -1.
+static int place(Map *m, const Prefab *p, unsigned *used, Rng *rng) {
+    int rooms = m->room_count - 2; // first and last hold the stairs
+    if (rooms <= 0) return -1;
+
+    int first = rng_below(rng, rooms), turn = rng_below(rng, ORIENTATIONS);
+    for (int i = 0; i < rooms; i++) {
+        int room = 1 + (first + i) % rooms;
+        if (*used & 1u << room) continue;
+        const Room *r = &m->rooms[room];
+        int cx, cy;
+        map_room_center(r, &cx, &cy);
+
+        for (int k = 0; k < ORIENTATIONS; k++) {
+            int o = (turn + k) % ORIENTATIONS;
+            int w = p->w[o], h = p->h[o];
+            int slack_x = r->w - 2 - w, slack_y = r->h - 2 - h;
+            if (slack_x < 0 || slack_y < 0) continue;
+            int x0 = r->x + 1 + rng_range(rng, 0, slack_x);
+            int y0 = r->y + 1 + rng_range(rng, 0, slack_y);
+
+            // Corridors and the connectivity check aim at the room center
+            if (cx >= x0 && cx < x0 + w && cy >= y0 && cy < y0 + h) {
+                uint8_t t = p->tiles[o][(cy - y0) * w + (cx - x0)];
+                if (!TILE_HAS(t, TRAIT_WALKABLE)) continue;
+            }
+
+            for (int y = 0; y < h; y++)
+                memcpy(&m->tiles[y0 + y][x0], p->tiles[o] + y * w, w);
+            if (p->kind == VAULT_LAIR) {
+                m->lair_x = x0 + p->mark_x[o];
+                m->lair_y = y0 + p->mark_y[o];
+            }
+            *used |= 1u << room;
+            return room;
+        }
+    }
+    return -1;
+}
+
+int vault_stamp_level(Map *m, int level, Rng *rng) {
+    m->lair_x = m->lair_y = -1;
+    if (lib.count == 0) return 0;
+
+    unsigned used = 0;
+    int stamped = 0;
+    int lair = pick(VAULT_LAIR, level, rng);
+    if (lair >= 0 && place(m, &lib.prefabs[lair], &used, rng) >= 0) stamped++;
+
+    for (int roll = 0; roll < VAULT_ROLLS; roll++) {
+        if (rng_below(rng, 100) >= VAULT_CHANCE) continue;
+        int kind = rng_below(rng, 2) ? VAULT_TREASURE : VAULT_GAUNTLET;
+        int i = pick(kind, level, rng);
+        if (i >= 0 && place(m, &lib.prefabs[i], &used, rng) >= 0) stamped++;
+    }
+    return stamped;
+}
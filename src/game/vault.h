@@ -0,0 +1,53 @@
+#ifndef VAULT_HEADER_H
+#define VAULT_HEADER_H
+
+#include <stdint.h>
+#include "map.h"
+#include "rng.h"
+
+// Hand-authored room prefabs (boss lairs, treasure vaults, trap
+// gauntlets) stamped into rooms as levels are laid out. They live in a
+// packed binary file built from assets/vaults.txt by tools/vault_pack.c:
+//
+//   header  "CVLT", u16 version, u16 count (little endian)
+//   prefab  u8 kind, min level, max level, w, h, mark x, mark y
+//           (0xFF if unmarked), then w * h TileType bytes row by row
+//
+// The file is mapped, not read. Loading checks every prefab and lays
+// out all eight rotations and mirrorings of it once, so stamping is one
+// memcpy per row. The library is read-only once loaded, so the pregen
+// thread and batch tools can share it. It may only be loaded or freed
+// while no level is being generated: both wait out (and drop) any pregen
+// job first, and batch tools must finish their own runs.
+
+#define VAULT_PATH        "assets/vaults.bin"
+#define VAULT_MAGIC       "CVLT"
+#define VAULT_VERSION     1
+#define VAULT_FILE_HEADER 8
+#define VAULT_HEADER      7
+#define VAULT_NO_MARK     0xFF
+#define VAULT_MAX_PREFABS 64
+#define VAULT_MAX_SIDE    18 // fits the interior of the largest room
+
+typedef enum {
+    VAULT_LAIR,     // boss level centrepiece, the mark is where the boss waits
+    VAULT_TREASURE,
+    VAULT_GAUNTLET,
+    VAULT_KINDS
+} VaultKind;
+
+// Map the library at `path`, replacing any loaded one. Returns the
+// number of prefabs, or -1 if the file is missing or malformed, in which
+// case levels are generated without vaults.
+int  vault_library_load(const char *path);
+void vault_library_free(void);
+int  vault_library_count(void);
+
+// Stamp vaults for `level` into the rooms of a freshly laid out map:
+// the level's lair if it has one, then a chance of a treasure vault or
+// gauntlet. The first and last rooms (stairs) are left alone, and every
+// vault keeps a one tile floor ring inside its room so corridors still
+// meet. Sets m->lair_x/y. Returns the number of vaults stamped.
+int  vault_stamp_level(Map *m, int level, Rng *rng);
+
+#endif
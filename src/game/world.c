@@ -0,0 +1,268 @@
+#include "world.h"
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned int hash2(unsigned int seed, int x, int y) {
+    unsigned int h = seed ^ ((unsigned int)x * 0x27d4eb2dU)
+                          ^ ((unsigned int)y * 0x165667b1U);
+    h ^= h >> 15; h *= 0x85ebca6bU;
+    h ^= h >> 13; h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+// Smooth 0..255 value noise on a lattice with `cell` tile spacing
+static int value_noise(unsigned int seed, int x, int y, int cell) {
+    int gx = x / cell, gy = y / cell;
+    int fx = x % cell, fy = y % cell;
+    int v00 = hash2(seed, gx,     gy)     & 0xff;
+    int v10 = hash2(seed, gx + 1, gy)     & 0xff;
+    int v01 = hash2(seed, gx,     gy + 1) & 0xff;
+    int v11 = hash2(seed, gx + 1, gy + 1) & 0xff;
+    int top = v00 * (cell - fx) + v10 * fx;
+    int bot = v01 * (cell - fx) + v11 * fx;
+    return (top * (cell - fy) + bot * fy) / (cell * cell);
+}
+
+// Outdoor terrain until dedicated outdoor tiles exist: mountains and
+// dense forest block like walls, open ground is grass.
+static TileType terrain_at(const World *w, int x, int y) {
+    if (x == 0 || y == 0 || x == w->w - 1 || y == w->h - 1) return TILE_WALL;
+    int elevation = (2 * value_noise(w->seed, x, y, 64) +
+                     value_noise(w->seed + 1, x, y, 16)) / 3;
+    if (elevation > 165) return TILE_WALL;
+    int moisture = value_noise(w->seed + 2, x, y, 48);
+    if (moisture > 150 && (hash2(w->seed + 3, x, y) & 7) == 0) return TILE_WALL;
+    if (moisture > 190) return TILE_FLOOR;
+    return TILE_TOWN_FLOOR;
+}
+
+static void chunk_generate(const World *w, int cx, int cy, unsigned char *tiles) {
+    for (int ty = 0; ty < CHUNK_SIZE; ty++) {
+        for (int tx = 0; tx < CHUNK_SIZE; tx++) {
+            int x = cx * CHUNK_SIZE + tx;
+            int y = cy * CHUNK_SIZE + ty;
+            tiles[ty * CHUNK_SIZE + tx] = (x < w->w && y < w->h)
+                ? terrain_at(w, x, y) : TILE_WALL;
+        }
+    }
+}
+
+// Run-length encode as (count, value) byte pairs
+static int rle_pack(const unsigned char *src, unsigned char *dst) {
+    int n = 0;
+    for (int i = 0; i < CHUNK_TILES; ) {
+        int run = 1;
+        while (i + run < CHUNK_TILES && run < 255 && src[i + run] == src[i])
+            run++;
+        dst[n++] = (unsigned char)run;
+        dst[n++] = src[i];
+        i += run;
+    }
+    return n;
+}
+
+static void rle_unpack(const unsigned char *src, int len, unsigned char *dst) {
+    int j = 0;
+    for (int i = 0; i + 1 < len && j < CHUNK_TILES; i += 2)
+        for (int k = 0; k < src[i] && j < CHUNK_TILES; k++)
+            dst[j++] = src[i + 1];
+}
+
+// ── Chunk hash table (linear probing, backward-shift deletion) ──────────
+
+static int chunk_hash(const World *w, int cx, int cy) {
+    return (int)(hash2(0x9e3779b9U, cx, cy) & (unsigned int)(w->table_size - 1));
+}
+
+static int table_find(const World *w, int cx, int cy) {
+    int i = chunk_hash(w, cx, cy);
+    while (w->table[i].state != CHUNK_UNUSED) {
+        if (w->table[i].cx == cx && w->table[i].cy == cy) return i;
+        i = (i + 1) & (w->table_size - 1);
+    }
+    return -1;
+}
+
+static void table_place(World *w, const Chunk *c) {
+    int i = chunk_hash(w, c->cx, c->cy);
+    while (w->table[i].state != CHUNK_UNUSED)
+        i = (i + 1) & (w->table_size - 1);
+    w->table[i] = *c;
+    if (c->slot >= 0) w->slot_chunk[c->slot] = i;
+}
+
+static void table_grow(World *w) {
+    Chunk *old = w->table;
+    int old_size = w->table_size;
+    w->table_size *= 2;
+    w->table = calloc(w->table_size, sizeof(Chunk));
+    for (int i = 0; i < old_size; i++)
+        if (old[i].state != CHUNK_UNUSED) table_place(w, &old[i]);
+    free(old);
+}
+
+static int table_insert(World *w, int cx, int cy) {
+    if ((w->table_used + 1) * 2 > w->table_size) table_grow(w);
+    Chunk c = {0};
+    c.cx   = cx;
+    c.cy   = cy;
+    c.slot = -1;
+    c.state = CHUNK_RESIDENT;
+    table_place(w, &c);
+    w->table_used++;
+    return table_find(w, cx, cy);
+}
+
+static void table_remove(World *w, int i) {
+    int mask = w->table_size - 1;
+    w->table[i].state = CHUNK_UNUSED;
+    w->table_used--;
+    // Shift later entries of the probe run back into the hole
+    int j = (i + 1) & mask;
+    while (w->table[j].state != CHUNK_UNUSED) {
+        int home = chunk_hash(w, w->table[j].cx, w->table[j].cy);
+        int dist_hole = (i - home) & mask;
+        int dist_here = (j - home) & mask;
+        if (dist_hole < dist_here) {
+            w->table[i] = w->table[j];
+            if (w->table[i].slot >= 0) w->slot_chunk[w->table[i].slot] = i;
+            w->table[j].state = CHUNK_UNUSED;
+            i = j;
+        }
+        j = (j + 1) & mask;
+    }
+}
+
+// ── Residency ───────────────────────────────────────────────────────────
+
+static void evict_slot(World *w, int slot) {
+    int i = w->slot_chunk[slot];
+    Chunk *c = &w->table[i];
+    if (c->dirty) {
+        unsigned char buf[CHUNK_TILES * 2];
+        int len = rle_pack(w->pool[slot], buf);
+        c->packed = malloc(len);
+        memcpy(c->packed, buf, len);
+        c->packed_len = len;
+        c->state = CHUNK_PACKED;
+        c->slot  = -1;
+    } else {
+        // Untouched chunks regenerate identically from the seed
+        table_remove(w, i);
+    }
+    w->slot_chunk[slot] = -1;
+    w->resident_count--;
+    if (w->last_slot == slot) w->last_slot = -1;
+}
+
+static int alloc_slot(World *w) {
+    int lru = -1;
+    for (int s = 0; s < WORLD_MAX_RESIDENT; s++) {
+        if (w->slot_chunk[s] < 0) return s;
+        if (lru < 0 || w->table[w->slot_chunk[s]].last_used <
+                       w->table[w->slot_chunk[lru]].last_used)
+            lru = s;
+    }
+    evict_slot(w, lru);
+    return lru;
+}
+
+static int chunk_load(World *w, int cx, int cy) {
+    int i = table_find(w, cx, cy);
+    if (i >= 0 && w->table[i].state == CHUNK_RESIDENT) {
+        w->table[i].last_used = ++w->clock;
+        return w->table[i].slot;
+    }
+
+    // Evicting can shift table entries, so look the chunk up again after
+    int slot = alloc_slot(w);
+    i = table_find(w, cx, cy);
+    if (i >= 0) {
+        Chunk *c = &w->table[i];
+        rle_unpack(c->packed, c->packed_len, w->pool[slot]);
+        free(c->packed);
+        c->packed = NULL;
+        c->packed_len = 0;
+        c->state = CHUNK_RESIDENT;
+    } else {
+        i = table_insert(w, cx, cy);
+        chunk_generate(w, cx, cy, w->pool[slot]);
+    }
+    w->table[i].slot      = slot;
+    w->table[i].last_used = ++w->clock;
+    w->slot_chunk[slot]   = i;
+    w->resident_count++;
+    return slot;
+}
+
+static unsigned char *tile_ptr(World *w, int x, int y) {
+    int cx = x / CHUNK_SIZE;
+    int cy = y / CHUNK_SIZE;
+    if (w->last_slot < 0 || w->last_cx != cx || w->last_cy != cy) {
+        w->last_slot = chunk_load(w, cx, cy);
+        w->last_cx   = cx;
+        w->last_cy   = cy;
+    }
+    return &w->pool[w->last_slot][(y % CHUNK_SIZE) * CHUNK_SIZE + x % CHUNK_SIZE];
+}
+
+void world_init(World *w, unsigned int seed, int width, int height) {
+    w->seed           = seed;
+    w->w              = width;
+    w->h              = height;
+    w->table_size     = 256;
+    w->table_used     = 0;
+    w->table          = calloc(w->table_size, sizeof(Chunk));
+    w->resident_count = 0;
+    w->clock          = 0;
+    w->last_slot      = -1;
+    for (int s = 0; s < WORLD_MAX_RESIDENT; s++)
+        w->slot_chunk[s] = -1;
+}
+
+void world_free(World *w) {
+    for (int i = 0; i < w->table_size; i++)
+        free(w->table[i].packed);
+    free(w->table);
+    w->table = NULL;
+    w->table_size = 0;
+    w->table_used = 0;
+}
+
+TileType world_get_tile(World *w, int x, int y) {
+    if (x < 0 || x >= w->w || y < 0 || y >= w->h) return TILE_WALL;
+    return *tile_ptr(w, x, y);
+}
+
+void world_set_tile(World *w, int x, int y, TileType t) {
+    if (x < 0 || x >= w->w || y < 0 || y >= w->h) return;
+    *tile_ptr(w, x, y) = t;
+    w->table[w->slot_chunk[w->last_slot]].dirty = 1;
+}
+
+int world_is_walkable(World *w, int x, int y) {
+    return TILE_HAS(world_get_tile(w, x, y), TRAIT_WALKABLE);
+}
+
+void world_update(World *w, int player_x, int player_y) {
+    int pcx = player_x / CHUNK_SIZE;
+    int pcy = player_y / CHUNK_SIZE;
+
+    // Drop chunks that fell behind; one chunk of slack avoids thrashing
+    // when the player walks back and forth over a chunk border
+    for (int s = 0; s < WORLD_MAX_RESIDENT; s++) {
+        if (w->slot_chunk[s] < 0) continue;
+        const Chunk *c = &w->table[w->slot_chunk[s]];
+        if (abs(c->cx - pcx) > WORLD_KEEP_RADIUS + 1 ||
+            abs(c->cy - pcy) > WORLD_KEEP_RADIUS + 1)
+            evict_slot(w, s);
+    }
+
+    int max_cx = (w->w - 1) / CHUNK_SIZE;
+    int max_cy = (w->h - 1) / CHUNK_SIZE;
+    for (int cy = pcy - WORLD_KEEP_RADIUS; cy <= pcy + WORLD_KEEP_RADIUS; cy++)
+        for (int cx = pcx - WORLD_KEEP_RADIUS; cx <= pcx + WORLD_KEEP_RADIUS; cx++)
+            if (cx >= 0 && cy >= 0 && cx <= max_cx && cy <= max_cy)
+                chunk_load(w, cx, cy);
+}
@@ -0,0 +1,56 @@
+#ifndef WORLD_HEADER_H
+#define WORLD_HEADER_H
+
+#include "map.h"
+
+// Chunked tile storage for large outdoor areas. Only chunks near the
+// player are resident; far chunks are dropped (untouched, regenerated on
+// demand from the seed) or kept run-length compressed (edited).
+
+#define WORLD_W 2000
+#define WORLD_H 2000
+
+#define CHUNK_SIZE   32
+#define CHUNK_TILES  (CHUNK_SIZE * CHUNK_SIZE)
+
+#define WORLD_KEEP_RADIUS  2  // chunks kept around the player by world_update
+#define WORLD_MAX_RESIDENT 48 // hard cap on decompressed chunks
+
+typedef enum {
+    CHUNK_UNUSED = 0,
+    CHUNK_RESIDENT,
+    CHUNK_PACKED
+} ChunkState;
+
+typedef struct {
+    int           cx, cy;
+    ChunkState    state;
+    int           dirty;       // edited since it was generated
+    int           slot;        // resident pool slot, -1 if not resident
+    unsigned char *packed;     // RLE data while CHUNK_PACKED
+    int           packed_len;
+    unsigned int  last_used;
+} Chunk;
+
+typedef struct {
+    unsigned int  seed;
+    int           w, h;
+    Chunk        *table;       // open-addressed hash of known chunks
+    int           table_size;  // power of two
+    int           table_used;
+    int           resident_count;
+    int           slot_chunk[WORLD_MAX_RESIDENT]; // table index per slot, -1 if free
+    unsigned char pool[WORLD_MAX_RESIDENT][CHUNK_TILES];
+    unsigned int  clock;
+    int           last_slot;   // fast path for runs of lookups in one chunk
+    int           last_cx, last_cy;
+} World;
+
+void     world_init(World *w, unsigned int seed, int width, int height);
+void     world_free(World *w);
+TileType world_get_tile(World *w, int x, int y);
+void     world_set_tile(World *w, int x, int y, TileType t);
+int      world_is_walkable(World *w, int x, int y);
+void     world_update(World *w, int player_x, int player_y);
+
+#endif
@@ -9,12 +9,16 @@
 #include "screens/landing.h"
 #include "screens/name_entry.h"
 #include "systems/save_load.h"
+#include "systems/snapshot.h"
 #include "game/enemy.h"
 #include "screens/slot_select.h"
 #include "renderer/slot_renderer.h"
 #include "screens/inventory.h"
 #include "renderer/inventory_renderer.h"
 #include "game/actions.h"
+#include "game/intent.h"
+#include "game/pregen.h"
+#include "game/vault.h"
 #include "screens/spellbook.h"
 #include "renderer/spellbook_renderer.h"
 #include "screens/shop.h"
@@ -34,12 +38,46 @@
 #define WINDOW_W     1280
 #define WINDOW_H     720
 
+#define TRAVEL_STEP_MS 40 // delay between steps of a walk
+
 static void enter_playing(Renderer *renderer, Viewport *viewport, GameState *game) {
     int vp_tiles_x = (renderer->screen_w - INFO_PANEL_W) / TILE_SIZE;
-    viewport_init(viewport, vp_tiles_x, renderer->tiles_y, MAP_W, MAP_H);
+    viewport_init(viewport, vp_tiles_x, renderer->tiles_y,
+        game->map.w, game->map.h);
+    viewport_center_on(viewport, game->player.x, game->player.y);
+}
+
+// One player action followed by the enemies' replies
+static void play_turn(GameState *game, Viewport *viewport, GameScreen *screen,
+    Action a) {
+    action_resolve_player(game, a);
+    action_resolve_enemies(game);
+    if (game->player.hp <= 0)
+        *screen = SCREEN_GAME_OVER;
+    // Level bounds change on stairs and town trips
+    viewport_set_map_size(viewport, game->map.w, game->map.h);
     viewport_center_on(viewport, game->player.x, game->player.y);
 }
 
+// Screen to come back to after quitting now, or -1 if no run is going
+static int resume_screen(GameScreen screen, const LandingScreen *landing) {
+    switch (screen) {
+        case SCREEN_PLAYING:
+        case SCREEN_INVENTORY:
+        case SCREEN_SPELLBOOK:
+        case SCREEN_HELP:
+            return screen;
+        case SCREEN_SHOP: // the stock is not part of the game state
+            return SCREEN_PLAYING;
+        case SCREEN_LANDING:
+        case SCREEN_SAVE_SLOT:
+        case SCREEN_LOAD_SLOT:
+            return landing->has_active_game ? SCREEN_LANDING : -1;
+        default:
+            return -1;
+    }
+}
+
 static void handle_landing_result(LandingResult result, LandingScreen *landing,
     GameScreen *screen, GameState *game, Renderer *renderer, Viewport *viewport,
     NameEntry *name_entry, SlotSelect *slot_select, int *slot_is_save, int *running) {
@@ -144,12 +182,21 @@ int main(void) {
     renderer_init(&renderer, sdl_renderer, WINDOW_W, WINDOW_H);
     music_init();
     sfx_init();
+    // Missing or broken vaults only mean plainer levels
+    if (vault_library_load(VAULT_PATH) < 0)
+        fprintf(stderr, "No vault prefabs loaded from %s\n", VAULT_PATH);
+
+    // Big enemy waves plan their moves across every core
+    ThreadPool intent_threads;
+    pool_init(&intent_threads, pool_cpu_count());
+    action_set_intent_pool(&intent_threads);
 
     GameState game;
     game_init(&game);
 
     Viewport viewport;
-    viewport_init(&viewport, renderer.tiles_x, renderer.tiles_y, MAP_W, MAP_H);
+    viewport_init(&viewport, renderer.tiles_x, renderer.tiles_y,
+        game.map.w, game.map.h);
     viewport_center_on(&viewport, game.player.x, game.player.y);
 
     LandingScreen landing;
@@ -171,7 +218,25 @@ int main(void) {
     int slot_is_save = 0;
     GameScreen screen = SCREEN_LANDING;
 
+    // Pick up where the last session quit: from the snapshot, or from its
+    // JSON copy if the snapshot is missing or this build cannot read it
+    int resumed_screen = SCREEN_LANDING;
+    int resumed = snapshot_load(&game, &resumed_screen);
+    if (resumed <= 0 && save_exists(RESUME_SLOT) && load_game(&game, RESUME_SLOT)) {
+        resumed_screen = SCREEN_PLAYING;
+        resumed = 1;
+    }
+    snapshot_discard();
+    save_delete(RESUME_SLOT);
+    if (resumed > 0) {
+        enter_playing(&renderer, &viewport, &game);
+        landing.has_active_game = 1;
+        landing.selected = 1;
+        screen = (GameScreen)resumed_screen;
+    }
+
     int running = 1;
+    Uint32 last_travel_ms = 0;
     SDL_Event event;
 
     while (running) {
@@ -252,6 +317,7 @@ int main(void) {
                             &class_select_screen, sc);
                         if (result == CLASS_SELECT_CONFIRMED) {
                             game.player.player_class = class_select_screen.selected;
+                            game_free(&game);
                             game_init(&game);
                             SDL_strlcpy(game.player.name, name_entry.name,
                                 sizeof(game.player.name));
@@ -327,16 +393,13 @@ int main(void) {
                         } else if (result == SHOP_BUY) {
                             Item *item = &shop_screen.items[shop_screen.selected];
                             if (game.gold < item->value) {
-                                push_message(&game, "Not enough gold!");
+                                game_note(&game, NOTE_NO_GOLD);
                             } else if (game.inventory_count >= MAX_INVENTORY) {
-                                push_message(&game, "Inventory full!");
+                                game_note(&game, NOTE_INVENTORY_FULL);
                             } else {
                                 game.gold -= item->value;
                                 game.inventory[game.inventory_count++] = *item;
-                                char msg[32];
-                                SDL_snprintf(msg, sizeof(msg), "Bought %s",
-                                    item->name);
-                                push_message(&game, msg);
+                                event_set_name(game_log(&game, EVENT_BUY), item->name);
                             }
                         } else if (result == SHOP_SELL) {
                             if (game.inventory_count == 0) break;
@@ -356,9 +419,9 @@ int main(void) {
                             if (game.equipped_armor  > idx) game.equipped_armor--;
 
                             int sell_price = item->value / 2;
-                            char msg[32];
-                            SDL_snprintf(msg, sizeof(msg), "Sold %s for %d gold",
-                                item->name, sell_price);
+                            GameEvent *ev = game_log(&game, EVENT_SELL);
+                            event_set_name(ev, item->name);
+                            ev->a = sell_price;
                             game.gold += sell_price;
 
                             for (int i = idx; i < game.inventory_count - 1; i++)
@@ -368,7 +431,6 @@ int main(void) {
                                 shop_screen.selected = game.inventory_count - 1;
                             if (shop_screen.selected < 0)
                                 shop_screen.selected = 0;
-                            push_message(&game, msg);
                         }
                         break;
                     }
@@ -385,6 +447,7 @@ int main(void) {
                     // Playing screen
                     if (screen == SCREEN_PLAYING) {
                         Action a = {ACTION_NONE, 0, 0};
+                        game_travel_cancel(&game); // any key interrupts a walk
                         switch (sc) {
                             case SDL_SCANCODE_ESCAPE:
                                 landing.has_active_game = 1;
@@ -439,6 +502,14 @@ int main(void) {
                             case SDL_SCANCODE_H:
                                 screen = SCREEN_HELP;
                                 break;
+                            case SDL_SCANCODE_G:
+                                // Walk to the stairs down, or the town exit
+                                if (game.location == LOCATION_DUNGEON)
+                                    game_travel_to(&game, game.map.stairs_down_x,
+                                        game.map.stairs_down_y);
+                                else
+                                    game_travel_to(&game, TOWN_W / 2, 0);
+                                break;
                             case SDL_SCANCODE_E: {
                                 // Check adjacent tiles for shops
                                 int px = game.player.x;
@@ -446,35 +517,23 @@ int main(void) {
                                 int found = 0;
                                 for (int dy = -1; dy <= 1 && !found; dy++) {
                                     for (int dx = -1; dx <= 1 && !found; dx++) {
-                                        TileType t = game.map.tiles[py+dy][px+dx];
-                                        if (t == TILE_SHOP_ALCHEMIST) {
-                                            shop_init(&shop_screen,
-                                                SHOP_TYPE_ALCHEMIST);
-                                            screen = SCREEN_SHOP;
-                                            found = 1;
-                                        }
-                                        if (t == TILE_SHOP_BLACKSMITH) {
-                                            shop_init(&shop_screen,
-                                                SHOP_TYPE_BLACKSMITH);
+                                        const TileTraits *t =
+                                            &TILE_TRAITS[game.map.tiles[py+dy][px+dx]];
+                                        if (t->flags & TRAIT_SHOP) {
+                                            shop_init(&shop_screen, t->shop);
                                             screen = SCREEN_SHOP;
                                             found = 1;
                                         }
                                     }
                                 }
                                 if (!found)
-                                    push_message(&game, "No shop nearby");
+                                    game_note(&game, NOTE_NO_SHOP);
                                 break;
                             }
                             default: break;
                         }
-                        if (a.type != ACTION_NONE) {
-                            action_resolve_player(&game, a);
-                            action_resolve_enemies(&game);
-                            if (game.player.hp <= 0)
-                                screen = SCREEN_GAME_OVER;
-                            viewport_center_on(&viewport,
-                                game.player.x, game.player.y);
-                        }
+                        if (a.type != ACTION_NONE)
+                            play_turn(&game, &viewport, &screen, a);
                     }
                     break;
                 }
@@ -483,6 +542,15 @@ int main(void) {
                 case SDL_MOUSEBUTTONDOWN: {
                     if (event.button.button != SDL_BUTTON_LEFT) break;
 
+                    // Click a map tile to walk there
+                    if (screen == SCREEN_PLAYING) {
+                        int tx = event.button.x / TILE_SIZE;
+                        int ty = event.button.y / TILE_SIZE;
+                        if (tx < viewport.tiles_x && ty < viewport.tiles_y)
+                            game_travel_to(&game, viewport.cam_x + tx,
+                                viewport.cam_y + ty);
+                    }
+
                     // Landing screen clicks
                     if (screen == SCREEN_LANDING) {
                         LandingResult result = landing_handle_click(
@@ -605,13 +673,11 @@ int main(void) {
                                             game.inventory_count < MAX_INVENTORY) {
                                             game.gold -= item->value;
                                             game.inventory[game.inventory_count++] = *item;
-                                            char msg[32];
-                                            SDL_snprintf(msg, sizeof(msg), "Bought %s", item->name);
-                                            push_message(&game, msg);
+                                            event_set_name(game_log(&game, EVENT_BUY), item->name);
                                         } else if (game.gold < item->value) {
-                                            push_message(&game, "Not enough gold!");
+                                            game_note(&game, NOTE_NO_GOLD);
                                         } else {
-                                            push_message(&game, "Inventory full!");
+                                            game_note(&game, NOTE_INVENTORY_FULL);
                                         }
                                     } else {
                                         if (game.inventory_count == 0) { break; }
@@ -626,8 +692,9 @@ int main(void) {
                                         if (game.equipped_weapon > i) { game.equipped_weapon--; }
                                         if (game.equipped_armor > i) { game.equipped_armor--; }
                                         int sell_price = item->value / 2;
-                                        char msg[32];
-                                        SDL_snprintf(msg, sizeof(msg), "Sold %s for %d gold", item->name, sell_price);
+                                        GameEvent *ev = game_log(&game, EVENT_SELL);
+                                        event_set_name(ev, item->name);
+                                        ev->a = sell_price;
                                         game.gold += sell_price;
                                         for (int j = i; j < game.inventory_count - 1; j++) {
                                             game.inventory[j] = game.inventory[j + 1];
@@ -639,7 +706,6 @@ int main(void) {
                                         if (shop_screen.selected < 0) {
                                             shop_screen.selected = 0;
                                         }
-                                        push_message(&game, msg);
                                     }
                                 } else {
                                     // First click — just select
@@ -670,6 +736,14 @@ int main(void) {
         // ── Per-frame updates ─────────────────────────────────────────────
         if (screen == SCREEN_NAME_ENTRY)
             name_entry_update(&name_entry);
+        if (screen == SCREEN_PLAYING &&
+            SDL_GetTicks() - last_travel_ms >= TRAVEL_STEP_MS) {
+            Action a = game_travel_step(&game);
+            if (a.type != ACTION_NONE) {
+                play_turn(&game, &viewport, &screen, a);
+                last_travel_ms = SDL_GetTicks();
+            }
+        }
 
         // ── Rendering ─────────────────────────────────────────────────────
         renderer_begin_frame(&renderer);
@@ -705,6 +779,17 @@ int main(void) {
     }
 
     // ── Cleanup ───────────────────────────────────────────────────────────
+    // Quitting mid-run leaves a snapshot to resume from on the next launch
+    int resume = resume_screen(screen, &landing);
+    if (resume >= 0) {
+        snapshot_save(&game, resume);
+        save_game(&game, RESUME_SLOT); // the fallback, whether or not the snapshot was written
+    }
+    pregen_shutdown();
+    action_set_intent_pool(NULL);
+    pool_free(&intent_threads);
+    game_free(&game);
+    vault_library_free();
     sfx_free();
     music_free();
     renderer_free(&renderer);
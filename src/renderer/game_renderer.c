@@ -5,47 +5,50 @@
 #include "minimap_renderer.h"
 #include "renderer.h"
 
+// One drawer per TileSprite; TILE_TRAITS says which sprite a tile uses
+static void (*const TILE_DRAWERS[SPRITE_COUNT])(Renderer *r, int tile_x, int tile_y) = {
+    [SPRITE_WALL]            = draw_wall,
+    [SPRITE_FLOOR]           = draw_floor,
+    [SPRITE_STAIRS_UP]       = draw_stairs_up,
+    [SPRITE_STAIRS_DOWN]     = draw_stairs_down,
+    [SPRITE_TOWN_FLOOR]      = draw_town_floor,
+    [SPRITE_TOWN_PATH]       = draw_town_path,
+    [SPRITE_TOWN_EXIT]       = draw_town_exit,
+    [SPRITE_SHOP_BLACKSMITH] = draw_shop_blacksmith,
+    [SPRITE_SHOP_ALCHEMIST]  = draw_shop_alchemist,
+    [SPRITE_ITEM]            = draw_floor_item,
+    [SPRITE_GOLD]            = draw_floor_gold,
+    [SPRITE_TRAP_SPIKE]      = draw_trap_spike,
+    [SPRITE_TRAP_FIRE]       = draw_trap_fire,
+    [SPRITE_TRAP_POISON]     = draw_trap_poison,
+};
+
 void game_draw(Renderer *r, GameState *g, Viewport *v) {
-    // Draw map tiles
-    for (int y = 0; y < MAP_H; y++) {
-        for (int x = 0; x < MAP_W; x++) {
-            if (!viewport_is_visible(v, x, y)) continue;
-            int sx = viewport_to_screen_x(v, x);
-            int sy = viewport_to_screen_y(v, y);
-            switch (g->map.tiles[y][x]) {
-                case TILE_WALL: draw_wall(r, sx, sy); break;
-                case TILE_STAIRS_UP: draw_stairs_up(r, sx, sy); break;
-                case TILE_STAIRS_DOWN: draw_stairs_down(r, sx, sy); break;
-                case TILE_TOWN_FLOOR: draw_town_floor(r, sx, sy); break;
-                case TILE_TOWN_PATH: draw_town_path(r, sx, sy); break;
-                case TILE_TOWN_EXIT: draw_town_exit(r, sx, sy); break;
-                case TILE_SHOP_BLACKSMITH: draw_shop_blacksmith(r, sx, sy); break;
-                case TILE_SHOP_ALCHEMIST:  draw_shop_alchemist(r, sx, sy);  break;
-                case TILE_ITEM: draw_floor_item(r, sx, sy); break;
-                case TILE_TRAP_HIDDEN: draw_floor(r, sx, sy); break;
-                case TILE_TRAP_SPIKE: draw_trap_spike(r, sx, sy); break;
-                case TILE_TRAP_FIRE: draw_trap_fire(r, sx, sy); break;
-                case TILE_TRAP_POISON: draw_trap_poison(r, sx, sy); break;
-                default: draw_floor(r, sx, sy); break;
-            }
+    // Draw map tiles — only the cells under the camera are visited.
+    // Cells past the level bounds read back as wall.
+    for (int sy = 0; sy < v->tiles_y; sy++) {
+        for (int sx = 0; sx < v->tiles_x; sx++) {
+            int x = v->cam_x + sx;
+            int y = v->cam_y + sy;
+            TILE_DRAWERS[TILE_TRAITS[map_get_tile(&g->map, x, y)].sprite](r, sx, sy);
         }
     }
 
     // Draw enemies
     if (g->location == LOCATION_DUNGEON) {
-        for (int i = 0; i < g->enemy_count; i++) {
-            Enemy *e = &g->enemies[i];
-            if (!e->active) continue;
-            if (!viewport_is_visible(v, e->x, e->y)) continue;
-            int sx = viewport_to_screen_x(v, e->x);
-            int sy = viewport_to_screen_y(v, e->y);
-            draw_enemy(r, sx, sy, e->type);
+        const EnemyPool *p = &g->enemies;
+        for (int i = 0; i < p->count; i++) {
+            if (!p->active[i]) continue;
+            if (!viewport_is_visible(v, p->x[i], p->y[i])) continue;
+            int sx = viewport_to_screen_x(v, p->x[i]);
+            int sy = viewport_to_screen_y(v, p->y[i]);
+            draw_enemy(r, sx, sy, (EnemyType)p->type[i]);
             // Draw health bar above enemy
             int bar_w = TILE_SIZE - 4;
             int bar_h = 3;
             int bar_x = sx * TILE_SIZE + 2;
             int bar_y = sy * TILE_SIZE - 5;
-            int fill_w = (bar_w * e->hp) / e->max_hp;
+            int fill_w = (bar_w * p->hp[i]) / p->max_hp[i];
             SDL_Rect bg = {bar_x, bar_y, bar_w, bar_h};
             SDL_Rect fill = {bar_x, bar_y, fill_w, bar_h};
             SDL_SetRenderDrawColor(r->sdl, 60, 20, 20, 255);
@@ -44,6 +44,9 @@ void help_draw(Renderer *r) {
     renderer_draw_text(r, "F              Fire ranged",   col2, y, white, r->font_tiny);
     y += lh;
     renderer_draw_text(r, "T              Return to town", col1, y, white, r->font_tiny);
+    renderer_draw_text(r, "G              Walk to stairs", col2, y, white, r->font_tiny);
+    y += lh;
+    renderer_draw_text(r, "Click          Walk to tile",   col1, y, white, r->font_tiny);
     y += lh + 10;
 
     renderer_draw_text(r, "INVENTORY",      col1, y, gold,  r->font_small);
@@ -12,15 +12,20 @@ void message_bar_draw(Renderer *r, const GameState *g) {
     SDL_SetRenderDrawColor(r->sdl, 58, 58, 106, 255);
     SDL_RenderDrawLine(r->sdl, 0, bar_top, r->screen_w, bar_top);
 
-    if (g->message_count == 0) return;
+    int shown = events_count(&g->events);
+    if (shown > MAX_MESSAGES) shown = MAX_MESSAGES;
+    if (shown == 0) return;
 
     SDL_Color color = {180, 160, 120, 255};
     int x = 10;
     int y = r->screen_h - MESSAGE_BAR_H + 8;
 
-    // Show messages separated by spaces
-    for (int i = 0; i < g->message_count; i++) {
-        renderer_draw_text(r, g->messages[i], x, y, color, r->font_tiny);
-        x += (int)SDL_strlen(g->messages[i]) * 8 + 20;
+    // Show the latest events, oldest first, separated by spaces. This is
+    // the only place their text is made.
+    for (int i = shown - 1; i >= 0; i--) {
+        char text[MAX_MESSAGE_LEN];
+        event_format(events_recent(&g->events, i), text, sizeof(text));
+        renderer_draw_text(r, text, x, y, color, r->font_tiny);
+        x += (int)SDL_strlen(text) * 8 + 20;
     }
 }
\ No newline at end of file
@@ -259,6 +259,7 @@ void draw_enemy(Renderer *r, int tile_x, int tile_y, EnemyType type) {
         case ENEMY_DEMON_LORD:  draw_demon_lord(r, tile_x, tile_y);  break;
         case ENEMY_RED_DRAGON:  draw_red_dragon(r, tile_x, tile_y);  break;
         case ENEMY_TARRASQUE:   draw_tarrasque(r, tile_x, tile_y);   break;
+        case ENEMY_TYPE_COUNT:  break;
     }
 }
 
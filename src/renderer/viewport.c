@@ -13,10 +13,12 @@ void viewport_center_on(Viewport *v, int player_x, int player_y) {
     v->cam_x = player_x - v->tiles_x / 2;
     v->cam_y = player_y - v->tiles_y / 2;
 
-    if (v->cam_x < 0) v->cam_x = 0;
-    if (v->cam_y < 0) v->cam_y = 0;
+    // Clamp to the far edge first so maps smaller than the viewport
+    // stay pinned to the top-left corner
     if (v->cam_x + v->tiles_x > v->map_w) v->cam_x = v->map_w - v->tiles_x;
     if (v->cam_y + v->tiles_y > v->map_h) v->cam_y = v->map_h - v->tiles_y;
+    if (v->cam_x < 0) v->cam_x = 0;
+    if (v->cam_y < 0) v->cam_y = 0;
 }
 
 void viewport_on_resize(Viewport *v, int tiles_x, int tiles_y) {
@@ -24,6 +26,11 @@ void viewport_on_resize(Viewport *v, int tiles_x, int tiles_y) {
     v->tiles_y = tiles_y;
 }
 
+void viewport_set_map_size(Viewport *v, int map_w, int map_h) {
+    v->map_w = map_w;
+    v->map_h = map_h;
+}
+
 int viewport_to_screen_x(const Viewport *v, int world_x) {
     return world_x - v->cam_x;
 }
@@ -2,6 +2,7 @@
 #define SHOP_HEADER_H
 
 #include "../game/item.h"
+#include "../game/tile.h"
 
 #define MAX_SHOP_ITEMS 8
 
@@ -12,11 +13,6 @@ typedef enum {
     SHOP_SELL
 } ShopResult;
 
-typedef enum {
-    SHOP_TYPE_ALCHEMIST,
-    SHOP_TYPE_BLACKSMITH
-} ShopType;
-
 typedef struct {
     int      selected;
     ShopType type;
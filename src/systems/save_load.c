@@ -9,12 +9,10 @@
 static const char b64[] =
     "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-static char *tiles_to_base64(const TileType tiles[MAP_H][MAP_W]) {
-    int src_len = MAP_H * MAP_W * sizeof(TileType);
+static char *bytes_to_base64(const unsigned char *src, int src_len) {
     int dst_len = ((src_len + 2) / 3) * 4 + 1;
     char *out = malloc(dst_len);
     if (!out) return NULL;
-    const unsigned char *src = (const unsigned char *)tiles;
     int i = 0, j = 0;
     while (i < src_len) {
         unsigned int a = i < src_len ? src[i++] : 0;
@@ -33,7 +31,8 @@ static char *tiles_to_base64(const TileType tiles[MAP_H][MAP_W]) {
     return out;
 }
 
-static void base64_to_tiles(const char *src, TileType tiles[MAP_H][MAP_W]) {
+// Decodes at most dst_len bytes, returns the number written
+static int base64_to_bytes(const char *src, unsigned char *dst, int dst_len) {
     static const unsigned char dec[256] = {
         0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
         0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
@@ -44,19 +43,53 @@ static void base64_to_tiles(const char *src, TileType tiles[MAP_H][MAP_W]) {
         0,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,
         41,42,43,44,45,46,47,48,49,50,51,0,0,0,0,0
     };
-    unsigned char *dst = (unsigned char *)tiles;
     int len = strlen(src);
     int j = 0;
-    for (int i = 0; i < len; i += 4) {
+    for (int i = 0; i + 3 < len; i += 4) {
         unsigned int a = dec[(unsigned char)src[i]];
         unsigned int b = dec[(unsigned char)src[i+1]];
         unsigned int c = src[i+2] == '=' ? 0 : dec[(unsigned char)src[i+2]];
         unsigned int d = src[i+3] == '=' ? 0 : dec[(unsigned char)src[i+3]];
         unsigned int t = (a << 18) | (b << 12) | (c << 6) | d;
-        dst[j++] = (t >> 16) & 0xff;
-        if (src[i+2] != '=') dst[j++] = (t >> 8) & 0xff;
-        if (src[i+3] != '=') dst[j++] = t & 0xff;
+        if (j < dst_len) dst[j++] = (t >> 16) & 0xff;
+        if (src[i+2] != '=' && j < dst_len) dst[j++] = (t >> 8) & 0xff;
+        if (src[i+3] != '=' && j < dst_len) dst[j++] = t & 0xff;
     }
+    return j;
+}
+
+// Tiles are saved row-packed, w x h bytes, clamped to the level bounds
+static char *tiles_to_base64(const Map *m) {
+    unsigned char *packed = malloc(m->w * m->h + 1);
+    if (!packed) return NULL;
+    for (int y = 0; y < m->h; y++)
+        memcpy(packed + y * m->w, m->tiles[y], m->w);
+    char *out = bytes_to_base64(packed, m->w * m->h);
+    free(packed);
+    return out;
+}
+
+static void base64_to_tiles(const char *src, Map *m) {
+    unsigned char *packed = malloc(m->w * m->h + 1);
+    if (!packed) return;
+    base64_to_bytes(src, packed, m->w * m->h);
+    for (int y = 0; y < m->h; y++)
+        memcpy(m->tiles[y], packed + y * m->w, m->w);
+    free(packed);
+}
+
+// Older saves hold the full MAP_W x MAP_H grid as 4-byte TileType values
+static void base64_to_legacy_tiles(const char *src, Map *m) {
+    int count = MAP_W * MAP_H;
+    int *wide = malloc(count * sizeof(int));
+    if (!wide) return;
+    base64_to_bytes(src, (unsigned char *)wide, count * (int)sizeof(int));
+    for (int y = 0; y < MAP_H; y++)
+        for (int x = 0; x < MAP_W; x++)
+            m->tiles[y][x] = (unsigned char)wide[y * MAP_W + x];
+    free(wide);
+    m->w = MAP_W;
+    m->h = MAP_H;
 }
 
 static const char *slot_path(int slot) {
@@ -65,14 +98,28 @@ static const char *slot_path(int slot) {
     return path;
 }
 
+// Levels the player has left are saved beside the JSON, see level_store_save
+static const char *levels_path(int slot) {
+    static char path[64];
+    snprintf(path, sizeof(path), "saves/savegame_%d.levels", slot);
+    return path;
+}
+
 int save_exists(int slot) {
     FILE *f = fopen(slot_path(slot), "r");
     if (f) { fclose(f); return 1; }
     return 0;
 }
 
+void save_delete(int slot) {
+    remove(slot_path(slot));
+    remove(levels_path(slot));
+}
+
 static cJSON *serialize_map(const Map *m) {
     cJSON *obj = cJSON_CreateObject();
+    cJSON_AddNumberToObject(obj, "w",             m->w);
+    cJSON_AddNumberToObject(obj, "h",             m->h);
     cJSON_AddNumberToObject(obj, "room_count",    m->room_count);
     cJSON_AddNumberToObject(obj, "stairs_up_x",   m->stairs_up_x);
     cJSON_AddNumberToObject(obj, "stairs_up_y",   m->stairs_up_y);
@@ -91,8 +138,21 @@ static cJSON *serialize_map(const Map *m) {
     }
     cJSON_AddItemToObject(obj, "rooms", rooms);
 
+    // Corridors; the room graph is rebuilt from them on load
+    cJSON *corridors = cJSON_CreateArray();
+    for (int i = 0; i < m->corridor_count; i++) {
+        const Corridor *c = &m->corridors[i];
+        cJSON *co = cJSON_CreateObject();
+        cJSON_AddNumberToObject(co, "x1", c->x1);
+        cJSON_AddNumberToObject(co, "y1", c->y1);
+        cJSON_AddNumberToObject(co, "x2", c->x2);
+        cJSON_AddNumberToObject(co, "y2", c->y2);
+        cJSON_AddItemToArray(corridors, co);
+    }
+    cJSON_AddItemToObject(obj, "corridors", corridors);
+
     // Tiles as base64 string
-    char *b64tiles = tiles_to_base64(m->tiles);
+    char *b64tiles = tiles_to_base64(m);
     cJSON_AddStringToObject(obj, "tiles_b64", b64tiles);
     free(b64tiles);
 
@@ -105,6 +165,7 @@ static void deserialize_map(const cJSON *obj, Map *m) {
     m->stairs_up_y   = cJSON_GetObjectItem(obj, "stairs_up_y")->valueint;
     m->stairs_down_x = cJSON_GetObjectItem(obj, "stairs_down_x")->valueint;
     m->stairs_down_y = cJSON_GetObjectItem(obj, "stairs_down_y")->valueint;
+    m->lair_x = m->lair_y = -1; // only used while spawning
 
     cJSON *rooms = cJSON_GetObjectItem(obj, "rooms");
     for (int i = 0; i < m->room_count; i++) {
@@ -115,46 +176,73 @@ static void deserialize_map(const cJSON *obj, Map *m) {
         m->rooms[i].h = cJSON_GetObjectItem(r, "h")->valueint;
     }
 
-    base64_to_tiles(cJSON_GetObjectItem(obj, "tiles_b64")->valuestring, m->tiles);
+    // Saves from before corridors were kept have none; paths on those
+    // levels fall back to a search over the whole level
+    cJSON *corridors = cJSON_GetObjectItem(obj, "corridors");
+    int corridor_count = corridors ? cJSON_GetArraySize(corridors) : 0;
+    m->corridor_count = corridor_count > MAX_CORRIDORS ? MAX_CORRIDORS : corridor_count;
+    for (int i = 0; i < m->corridor_count; i++) {
+        cJSON *co = cJSON_GetArrayItem(corridors, i);
+        Corridor *c = &m->corridors[i];
+        c->x1 = (short)cJSON_GetObjectItem(co, "x1")->valueint;
+        c->y1 = (short)cJSON_GetObjectItem(co, "y1")->valueint;
+        c->x2 = (short)cJSON_GetObjectItem(co, "x2")->valueint;
+        c->y2 = (short)cJSON_GetObjectItem(co, "y2")->valueint;
+    }
+
+    const char *b64tiles = cJSON_GetObjectItem(obj, "tiles_b64")->valuestring;
+    cJSON *w = cJSON_GetObjectItem(obj, "w");
+    cJSON *h = cJSON_GetObjectItem(obj, "h");
+    if (w && h) {
+        m->w = w->valueint > MAP_W ? MAP_W : w->valueint;
+        m->h = h->valueint > MAP_H ? MAP_H : h->valueint;
+        base64_to_tiles(b64tiles, m);
+    } else {
+        base64_to_legacy_tiles(b64tiles, m);
+    }
+    map_build_room_graph(m);
 }
 
-static cJSON *serialize_enemies(const Enemy *enemies, int count) {
+// One object per enemy, as saves have always had them
+static cJSON *serialize_enemies(const EnemyPool *p) {
     cJSON *arr = cJSON_CreateArray();
-    for (int i = 0; i < count; i++) {
-        const Enemy *e = &enemies[i];
+    for (int i = 0; i < p->count; i++) {
         cJSON *obj = cJSON_CreateObject();
-        cJSON_AddNumberToObject(obj, "x",          e->x);
-        cJSON_AddNumberToObject(obj, "y",          e->y);
-        cJSON_AddNumberToObject(obj, "active",     e->active);
-        cJSON_AddNumberToObject(obj, "type",       e->type);
-        cJSON_AddStringToObject(obj, "name",       e->name);
-        cJSON_AddNumberToObject(obj, "hp",         e->hp);
-        cJSON_AddNumberToObject(obj, "max_hp",     e->max_hp);
-        cJSON_AddNumberToObject(obj, "attack",     e->attack);
-        cJSON_AddNumberToObject(obj, "defense",    e->defense);
-        cJSON_AddNumberToObject(obj, "experience", e->experience);
-        cJSON_AddNumberToObject(obj, "move_timer", e->move_timer);
+        cJSON_AddNumberToObject(obj, "x",          p->x[i]);
+        cJSON_AddNumberToObject(obj, "y",          p->y[i]);
+        cJSON_AddNumberToObject(obj, "active",     p->active[i]);
+        cJSON_AddNumberToObject(obj, "type",       p->type[i]);
+        cJSON_AddNumberToObject(obj, "hp",         p->hp[i]);
+        cJSON_AddNumberToObject(obj, "max_hp",     p->max_hp[i]);
+        cJSON_AddNumberToObject(obj, "next_act",   p->next_act[i]);
+        cJSON_AddNumberToObject(obj, "awake",      p->awake[i]);
         cJSON_AddItemToArray(arr, obj);
     }
     return arr;
 }
 
-static void deserialize_enemies(const cJSON *arr, Enemy *enemies, int *count) {
-    *count = cJSON_GetArraySize(arr);
-    for (int i = 0; i < *count; i++) {
+static void deserialize_enemies(const cJSON *arr, EnemyPool *p) {
+    p->count = cJSON_GetArraySize(arr);
+    if (p->count > MAX_ENEMIES) p->count = MAX_ENEMIES;
+    for (int i = 0; i < p->count; i++) {
         cJSON *obj = cJSON_GetArrayItem(arr, i);
-        Enemy *e = &enemies[i];
-        e->x          = cJSON_GetObjectItem(obj, "x")->valueint;
-        e->y          = cJSON_GetObjectItem(obj, "y")->valueint;
-        e->active     = cJSON_GetObjectItem(obj, "active")->valueint;
-        e->type       = cJSON_GetObjectItem(obj, "type")->valueint;
-        strncpy(e->name, cJSON_GetObjectItem(obj, "name")->valuestring, 15);
-        e->hp         = cJSON_GetObjectItem(obj, "hp")->valueint;
-        e->max_hp     = cJSON_GetObjectItem(obj, "max_hp")->valueint;
-        e->attack     = cJSON_GetObjectItem(obj, "attack")->valueint;
-        e->defense    = cJSON_GetObjectItem(obj, "defense")->valueint;
-        e->experience = cJSON_GetObjectItem(obj, "experience")->valueint;
-        e->move_timer = cJSON_GetObjectItem(obj, "move_timer")->valueint;
+        int type      = cJSON_GetObjectItem(obj, "type")->valueint;
+        p->x[i]       = cJSON_GetObjectItem(obj, "x")->valueint;
+        p->y[i]       = cJSON_GetObjectItem(obj, "y")->valueint;
+        p->active[i]  = (uint8_t)cJSON_GetObjectItem(obj, "active")->valueint;
+        p->hp[i]      = cJSON_GetObjectItem(obj, "hp")->valueint;
+        p->max_hp[i]  = cJSON_GetObjectItem(obj, "max_hp")->valueint;
+        // Older saves have neither; such enemies sleep until woken again
+        cJSON *next   = cJSON_GetObjectItem(obj, "next_act");
+        cJSON *awake  = cJSON_GetObjectItem(obj, "awake");
+        p->next_act[i] = next ? next->valueint : 0;
+        p->awake[i]    = awake ? (uint8_t)awake->valueint : 0;
+        // Name and stats come from the type; older saves' copies are ignored
+        if ((unsigned)type >= ENEMY_TYPE_COUNT) {
+            type         = ENEMY_SKELETON;
+            p->active[i] = 0;
+        }
+        p->type[i] = (uint8_t)type;
     }
 }
 
@@ -195,6 +283,7 @@ int save_game(const GameState *g, int slot) {
         cJSON_AddNumberToObject(s, "heal_hp",  sp->heal_hp);
         cJSON_AddNumberToObject(s, "range",    sp->range);
         cJSON_AddNumberToObject(s, "radius",   sp->radius);
+        cJSON_AddNumberToObject(s, "shape",    sp->shape);
         cJSON_AddItemToArray(spells, s);
     }
     cJSON_AddItemToObject(player, "spells", spells);
@@ -204,18 +293,42 @@ int save_game(const GameState *g, int slot) {
     cJSON_AddNumberToObject(root, "level",             g->level);
     cJSON_AddNumberToObject(root, "level_cleared",     g->level_cleared);
     cJSON_AddNumberToObject(root, "max_level_reached", g->max_level_reached);
-    cJSON_AddNumberToObject(root, "message_count",     g->message_count);
     cJSON_AddNumberToObject(root, "gold",              g->gold);
     cJSON_AddNumberToObject(root, "score",             g->score);
     cJSON_AddNumberToObject(root, "equipped_weapon",   g->equipped_weapon);
     cJSON_AddNumberToObject(root, "equipped_armor",    g->equipped_armor);
     cJSON_AddNumberToObject(root, "location",          g->location);
-
-    // Messages
-    cJSON *messages = cJSON_CreateArray();
-    for (int i = 0; i < g->message_count; i++)
-        cJSON_AddItemToArray(messages, cJSON_CreateString(g->messages[i]));
-    cJSON_AddItemToObject(root, "messages", messages);
+    cJSON_AddNumberToObject(root, "turn",              g->turn);
+    cJSON_AddNumberToObject(root, "clock",             g->clock);
+
+    // Effects on the player; those on enemies end with the level anyway
+    cJSON *effects = cJSON_CreateArray();
+    for (int i = 0; i < MAX_EFFECTS; i++) {
+        const Effect *e = &g->effects.pool[i];
+        if (!e->used || e->target != EFFECT_PLAYER) continue;
+        cJSON *fx = cJSON_CreateObject();
+        cJSON_AddNumberToObject(fx, "kind",  e->kind);
+        cJSON_AddNumberToObject(fx, "turns", e->expires - g->effects.now);
+        cJSON_AddItemToArray(effects, fx);
+    }
+    cJSON_AddItemToObject(root, "effects", effects);
+
+    // The events still on the message bar, oldest first
+    cJSON *events = cJSON_CreateArray();
+    int shown = events_count(&g->events);
+    if (shown > MAX_MESSAGES) shown = MAX_MESSAGES;
+    for (int i = shown - 1; i >= 0; i--) {
+        const GameEvent *ev = events_recent(&g->events, i);
+        cJSON *e = cJSON_CreateObject();
+        cJSON_AddNumberToObject(e, "kind",    ev->kind);
+        cJSON_AddNumberToObject(e, "subject", ev->subject);
+        cJSON_AddNumberToObject(e, "a",       ev->a);
+        cJSON_AddNumberToObject(e, "b",       ev->b);
+        cJSON_AddNumberToObject(e, "turn",    ev->turn);
+        cJSON_AddStringToObject(e, "name",    ev->name);
+        cJSON_AddItemToArray(events, e);
+    }
+    cJSON_AddItemToObject(root, "events", events);
 
     // Inventory
     cJSON *inventory = cJSON_CreateArray();
@@ -271,27 +384,15 @@ int save_game(const GameState *g, int slot) {
 
     // Current enemies
     cJSON_AddItemToObject(root, "enemies",
-        serialize_enemies(g->enemies, g->enemy_count));
-    cJSON_AddNumberToObject(root, "enemy_count", g->enemy_count);
-
-    // Level cache
-    cJSON *cache = cJSON_CreateArray();
-    for (int i = 0; i < MAX_DEPTH; i++) {
-        cJSON *entry = cJSON_CreateObject();
-        cJSON_AddNumberToObject(entry, "valid",         g->level_cache[i].valid);
-        cJSON_AddNumberToObject(entry, "level_cleared", g->level_cache[i].level_cleared);
-        if (g->level_cache[i].valid) {
-            cJSON_AddItemToObject(entry, "map",
-                serialize_map(&g->level_cache[i].map));
-            cJSON_AddItemToObject(entry, "enemies",
-                serialize_enemies(g->level_cache[i].enemies,
-                                  g->level_cache[i].enemy_count));
-            cJSON_AddNumberToObject(entry, "enemy_count",
-                g->level_cache[i].enemy_count);
-        }
-        cJSON_AddItemToArray(cache, entry);
+        serialize_enemies(&g->enemies));
+    cJSON_AddNumberToObject(root, "enemy_count", g->enemies.count);
+
+    // Levels the player has left go in their own file, unchanged ones
+    // are not rewritten
+    if (level_store_save(&g->levels, levels_path(slot)) < 0) {
+        cJSON_Delete(root);
+        return 0;
     }
-    cJSON_AddItemToObject(root, "level_cache", cache);
 
     char *json = cJSON_Print(root);
     cJSON_Delete(root);
@@ -354,25 +455,53 @@ int load_game(GameState *g, int slot) {
         sp->heal_hp = cJSON_GetObjectItem(s, "heal_hp")->valueint;
         sp->range   = cJSON_GetObjectItem(s, "range")->valueint;
         sp->radius  = cJSON_GetObjectItem(s, "radius")->valueint;
+        // Older saves have no shape; every area spell was a diamond
+        cJSON *shape = cJSON_GetObjectItem(s, "shape");
+        sp->shape   = shape && shape->valueint >= 0 && shape->valueint < AOE_SHAPE_COUNT
+                    ? shape->valueint : AOE_DIAMOND;
     }
 
     // Game state
     g->level             = cJSON_GetObjectItem(root, "level")->valueint;
     g->level_cleared     = cJSON_GetObjectItem(root, "level_cleared")->valueint;
     g->max_level_reached = cJSON_GetObjectItem(root, "max_level_reached")->valueint;
-    g->message_count     = cJSON_GetObjectItem(root, "message_count")->valueint;
     g->gold              = cJSON_GetObjectItem(root, "gold")->valueint;
     g->score             = cJSON_GetObjectItem(root, "score")->valueint;
     g->equipped_weapon   = cJSON_GetObjectItem(root, "equipped_weapon")->valueint;
     g->equipped_armor    = cJSON_GetObjectItem(root, "equipped_armor")->valueint;
     g->location          = cJSON_GetObjectItem(root, "location")->valueint;
+    // Older saves have no turn, clock or effects
+    cJSON *turn  = cJSON_GetObjectItem(root, "turn");
+    cJSON *clock = cJSON_GetObjectItem(root, "clock");
+    g->turn              = turn ? turn->valueint : 0;
+    g->clock             = clock ? clock->valueint : g->turn * TURN_TICKS;
+
+    // The saved stats already include any buffs, so effects go straight
+    // back on the wheel rather than through game_apply_effect
+    effects_init(&g->effects, g->turn);
+    cJSON *effects = cJSON_GetObjectItem(root, "effects");
+    for (int i = 0; i < cJSON_GetArraySize(effects); i++) {
+        cJSON *fx = cJSON_GetArrayItem(effects, i);
+        int kind  = cJSON_GetObjectItem(fx, "kind")->valueint;
+        if (kind >= 0 && kind < EFFECT_KIND_COUNT)
+            effects_add(&g->effects, EFFECT_PLAYER, (EffectKind)kind,
+                        cJSON_GetObjectItem(fx, "turns")->valueint);
+    }
 
-    // Messages
-    cJSON *messages = cJSON_GetObjectItem(root, "messages");
-    for (int i = 0; i < g->message_count && i < MAX_MESSAGES; i++)
-        strncpy(g->messages[i],
-            cJSON_GetArrayItem(messages, i)->valuestring,
-            MAX_MESSAGE_LEN - 1);
+    // Events; older saves kept the text instead, which is dropped
+    events_clear(&g->events);
+    cJSON *events = cJSON_GetObjectItem(root, "events");
+    for (int i = 0; i < cJSON_GetArraySize(events); i++) {
+        cJSON *e = cJSON_GetArrayItem(events, i);
+        int kind = cJSON_GetObjectItem(e, "kind")->valueint;
+        if (kind < 0 || kind >= EVENT_KIND_COUNT) continue;
+        GameEvent *ev = events_push(&g->events, (EventKind)kind,
+                                    cJSON_GetObjectItem(e, "turn")->valueint);
+        ev->subject = (unsigned char)cJSON_GetObjectItem(e, "subject")->valueint;
+        ev->a       = cJSON_GetObjectItem(e, "a")->valueint;
+        ev->b       = cJSON_GetObjectItem(e, "b")->valueint;
+        event_set_name(ev, cJSON_GetObjectItem(e, "name")->valuestring);
+    }
 
     // Inventory
     g->inventory_count = cJSON_GetObjectItem(root, "inventory_count")->valueint;
@@ -422,24 +551,29 @@ int load_game(GameState *g, int slot) {
 
     // Current map
     deserialize_map(cJSON_GetObjectItem(root, "map"), &g->map);
+    game_refresh_regions(g);
 
     // Current enemies
-    deserialize_enemies(cJSON_GetObjectItem(root, "enemies"),
-                        g->enemies, &g->enemy_count);
+    deserialize_enemies(cJSON_GetObjectItem(root, "enemies"), &g->enemies);
+    game_refresh_occupancy(g);
 
-    // Level cache
+    // Levels the player has left: saves from before the level store
+    // kept them in the JSON
     cJSON *cache = cJSON_GetObjectItem(root, "level_cache");
-    for (int i = 0; i < MAX_DEPTH; i++) {
-        cJSON *entry = cJSON_GetArrayItem(cache, i);
-        g->level_cache[i].valid         = cJSON_GetObjectItem(entry, "valid")->valueint;
-        g->level_cache[i].level_cleared = cJSON_GetObjectItem(entry, "level_cleared")->valueint;
-        if (g->level_cache[i].valid) {
-            deserialize_map(cJSON_GetObjectItem(entry, "map"),
-                            &g->level_cache[i].map);
-            deserialize_enemies(cJSON_GetObjectItem(entry, "enemies"),
-                                g->level_cache[i].enemies,
-                                &g->level_cache[i].enemy_count);
+    if (cache) {
+        level_store_clear(&g->levels);
+        for (int i = 0; i < MAX_DEPTH; i++) {
+            cJSON *entry = cJSON_GetArrayItem(cache, i);
+            if (!cJSON_GetObjectItem(entry, "valid")->valueint) continue;
+            LevelCache *c = level_store_put(&g->levels, i + 1);
+            c->level_cleared = cJSON_GetObjectItem(entry, "level_cleared")->valueint;
+            cJSON *left = cJSON_GetObjectItem(entry, "left_turn");
+            c->left_turn     = left ? left->valueint : g->turn;
+            deserialize_map(cJSON_GetObjectItem(entry, "map"), &c->map);
+            deserialize_enemies(cJSON_GetObjectItem(entry, "enemies"), &c->enemies);
         }
+    } else if (!level_store_load(&g->levels, levels_path(slot))) {
+        level_store_clear(&g->levels); // left levels are generated afresh
     }
 
     cJSON_Delete(root);
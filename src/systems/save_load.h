@@ -3,11 +3,13 @@
 
 #include "../game/game.h"
 
-#define SAVE_SLOTS 3
+#define SAVE_SLOTS  3
+#define RESUME_SLOT 0 // not shown; written on quit beside the snapshot (see snapshot.h)
 
 int save_game(const GameState *g, int slot);
 int load_game(GameState *g, int slot);
 int save_exists(int slot);
+void save_delete(int slot);
 int get_save_preview(int slot, char *name_out, int *level_out);
 
 #endif
\ No newline at end of file
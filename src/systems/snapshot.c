@@ -0,0 +1,112 @@
+#include "snapshot.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct {
+    char     magic[4];
+    uint32_t version;
+    uint32_t state_size;
+    uint32_t record_size;
+    uint32_t screen;
+    uint32_t records;
+    uint64_t checksum;
+} SnapshotHeader;
+
+typedef struct {
+    int32_t  level;
+    uint32_t zero; // keeps the record 8-byte aligned
+} RecordHeader;
+
+#define RECORD_BYTES (sizeof(RecordHeader) + sizeof(LevelCache))
+
+static uint64_t fnv1a(uint64_t h, const void *data, size_t n) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+#define FNV_BASIS 0xCBF29CE484222325ull
+
+int snapshot_save(const GameState *g, int screen) {
+    mkdir("saves", 0755);
+    FILE *f = fopen(SNAPSHOT_PATH, "wb");
+    if (!f) return 0;
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "CSNP", 4);
+    h.version     = SNAPSHOT_VERSION;
+    h.state_size  = (uint32_t)sizeof(GameState);
+    h.record_size = (uint32_t)sizeof(LevelCache);
+    h.screen      = (uint32_t)screen;
+    h.checksum    = fnv1a(FNV_BASIS, g, sizeof(*g));
+
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1 && fwrite(g, sizeof(*g), 1, f) == 1;
+    for (int level = 1; ok && level <= MAX_DEPTH; level++) {
+        const LevelCache *c = level_store_paged_out(&g->levels, level);
+        if (!c) continue;
+        RecordHeader r = { level, 0 };
+        h.checksum = fnv1a(h.checksum, &r, sizeof(r));
+        h.checksum = fnv1a(h.checksum, c, sizeof(*c));
+        h.records++;
+        ok = fwrite(&r, sizeof(r), 1, f) == 1 && fwrite(c, sizeof(*c), 1, f) == 1;
+    }
+    if (ok) ok = fseek(f, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, f) == 1;
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) remove(SNAPSHOT_PATH);
+    return ok;
+}
+
+static int usable(const SnapshotHeader *h, size_t size) {
+    if (memcmp(h->magic, "CSNP", 4) != 0 || h->version != SNAPSHOT_VERSION ||
+        h->state_size != sizeof(GameState) || h->record_size != sizeof(LevelCache) ||
+        h->records > MAX_DEPTH)
+        return 0;
+    if (size != sizeof(*h) + sizeof(GameState) + h->records * RECORD_BYTES) return 0;
+    return fnv1a(FNV_BASIS, h + 1, size - sizeof(*h)) == h->checksum;
+}
+
+int snapshot_load(GameState *g, int *screen) {
+    int fd = open(SNAPSHOT_PATH, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(SnapshotHeader))
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return -1;
+
+    const SnapshotHeader *h = data;
+    int ok = usable(h, (size_t)st.st_size);
+    if (ok) {
+        const unsigned char *p = (const unsigned char *)(h + 1);
+        game_free(g);
+        memcpy(g, p, sizeof(GameState));
+        p += sizeof(GameState);
+
+        // The store's file was the quitting session's: adopt its records
+        // into a new one
+        level_store_detach(&g->levels);
+        for (uint32_t i = 0; i < h->records; i++, p += RECORD_BYTES) {
+            RecordHeader r;
+            memcpy(&r, p, sizeof(r));
+            level_store_adopt(&g->levels, r.level,
+                              (const LevelCache *)(p + sizeof(r)));
+        }
+        *screen = (int)h->screen;
+    }
+    munmap(data, (size_t)st.st_size);
+    return ok ? 1 : -1;
+}
+
+void snapshot_discard(void) {
+    remove(SNAPSHOT_PATH);
+}
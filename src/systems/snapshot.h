@@ -0,0 +1,35 @@
+#ifndef SNAPSHOT_HEADER_H
+#define SNAPSHOT_HEADER_H
+
+#include "../game/game.h"
+
+// Quitting mid-run writes the live game as a raw binary snapshot, which
+// the next launch maps and copies straight back:
+//
+//   header   "CSNP", u32 version, u32 sizeof(GameState),
+//            u32 sizeof(LevelCache), u32 screen, u32 record count,
+//            u64 FNV-1a checksum of everything after the header
+//   state    the GameState bytes
+//   records  i32 level, u32 zero, then the LevelCache bytes, for each
+//            level the level store had paged out to its file
+//
+// The only pointers in GameState are the level store's backing file,
+// fixed up on load by re-adopting the records. A snapshot from another
+// build (version or layout changed) or a damaged one is refused, and the
+// JSON copy in RESUME_SLOT is loaded instead, as it is when no snapshot
+// could be written at all.
+
+#define SNAPSHOT_PATH    "saves/resume.snap"
+#define SNAPSHOT_VERSION 1
+
+// Returns 1 on success
+int  snapshot_save(const GameState *g, int screen);
+
+// Returns 1 and fills in the game and the screen it was on, 0 if there
+// is no snapshot, or -1 if there is one this build cannot use
+int  snapshot_load(GameState *g, int *screen);
+
+// Remove the snapshot once it has been resumed from
+void snapshot_discard(void);
+
+#endif
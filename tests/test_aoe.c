@@ -0,0 +1,75 @@
+#include "test_utils.h"
+#include "test_fixtures.h"
+#include "../src/game/aoe.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+static int cells_ordered(const AoeTemplate *t) {
+    for (int i = 0; i < t->count; i++)
+        if (t->cells[i].parent != AOE_ORIGIN && t->cells[i].parent >= i) return 0;
+    return 1;
+}
+
+static int has_cell(const AoeTemplate *t, int dx, int dy) {
+    for (int i = 0; i < t->count; i++)
+        if (t->cells[i].dx == dx && t->cells[i].dy == dy) return 1;
+    return 0;
+}
+
+void test_aoe(void) {
+    printf("Area of effect tests:\n");
+
+    aoe_init();
+    const AoeTemplate *diamond = aoe_template(AOE_DIAMOND, 2, 0, 0);
+    const AoeTemplate *disk    = aoe_template(AOE_DISK, 1, 0, 0);
+    const AoeTemplate *cross   = aoe_template(AOE_CROSS, 2, 0, 0);
+    const AoeTemplate *line    = aoe_template(AOE_LINE, 3, -1, 0);
+    const AoeTemplate *cone    = aoe_template(AOE_CONE, 2, 0, 1);
+    ASSERT("shapes hold the tiles they should",
+           diamond->count == 13 && disk->count == 9 && cross->count == 9 &&
+           line->count == 3 && cone->count == 8);
+    ASSERT("centred shapes hold their origin, aimed ones do not",
+           has_cell(diamond, 0, 0) && !has_cell(line, 0, 0) && !has_cell(cone, 0, 0));
+    ASSERT("aimed shapes point where they are aimed",
+           has_cell(line, -3, 0) && has_cell(cone, 0, 2) && !has_cell(cone, 0, -1));
+    ASSERT("row masks match the cells",
+           diamond->rows[0] == 0x04 && diamond->rows[2] == 0x1F && cross->rows[1] == 0x04);
+    ASSERT("every cell follows the one before it on its line",
+           cells_ordered(diamond) && cells_ordered(disk) && cells_ordered(cone) &&
+           cells_ordered(aoe_template(AOE_DISK, AOE_MAX_RADIUS, 0, 0)));
+    ASSERT("radius is clamped",
+           aoe_template(AOE_DISK, 99, 0, 0)->radius == AOE_MAX_RADIUS);
+
+    static Map m;
+    static BitGrid open;
+    memset(&m, 0, sizeof(m));
+    m.w = MAP_W;
+    m.h = MAP_H;
+    m.tiles[5][11] = TILE_WALL;
+    bitgrid_from_map(&open, &m);
+    AoeTile tiles[AOE_MAX_CELLS];
+    ASSERT("an open floor gets the whole shape", aoe_cast(diamond, &open, 64, 20, tiles) == 13);
+    int n = aoe_cast(diamond, &open, 10, 5, tiles);
+    int behind = 0;
+    for (int i = 0; i < n; i++)
+        if ((tiles[i].x == 11 || tiles[i].x == 12) && tiles[i].y == 5) behind = 1;
+    ASSERT("a wall stops the blast behind it", n == 11 && !behind);
+    ASSERT("tiles off the map are never hit", aoe_cast(diamond, &open, 0, 0, tiles) == 6);
+
+    // A fireball thrown at a wall bursts in front of it
+    static GameState g;
+    game_init(&g);
+    fixture_open_floor(&g, 40, 20, 20, 10);
+    for (int y = 8; y <= 12; y++) g.map.tiles[y][24] = TILE_WALL;
+    game_refresh_regions(&g);
+    int near = game_spawn_enemy(&g, ENEMY_SKELETON, 23, 12);
+    int far  = game_spawn_enemy(&g, ENEMY_SKELETON, 25, 10);
+    g.player.known_spells[0]   = spell_make_fireball();
+    g.player.known_spell_count = 1;
+    g.player.equipped_spell    = 0;
+    g.player.mp = g.player.max_mp = 100;
+    g.player.last_dx = 1;
+    g.player.last_dy = 0;
+    action_resolve_player(&g, (Action){ACTION_CAST_SPELL, 0, 0});
+    ASSERT("fireball hits in front of a wall but not behind it", !g.enemies.active[near] && g.enemies.active[far]);
+}
@@ -0,0 +1,122 @@
+#include "test_utils.h"
+#include <stdlib.h>
+#include "../src/game/cave.h"
+#include "../src/game/bitgrid.h"
+
+// Walkable tiles reachable from (sx, sy) moving orthogonally
+static int count_reachable(const Map *m, int sx, int sy) {
+    static unsigned char seen[MAP_H][MAP_W];
+    static int queue[MAP_W * MAP_H];
+    int head = 0, tail = 0, n = 0;
+
+    for (int y = 0; y < MAP_H; y++)
+        for (int x = 0; x < MAP_W; x++)
+            seen[y][x] = 0;
+    seen[sy][sx] = 1;
+    queue[tail++] = sy * MAP_W + sx;
+    while (head < tail) {
+        int x = queue[head] % MAP_W, y = queue[head] / MAP_W;
+        head++;
+        n++;
+        static const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        for (int d = 0; d < 4; d++) {
+            int nx = x + dirs[d][0], ny = y + dirs[d][1];
+            if (!map_is_walkable(m, nx, ny) || seen[ny][nx]) continue;
+            seen[ny][nx] = 1;
+            queue[tail++] = ny * MAP_W + nx;
+        }
+    }
+    return n;
+}
+
+void test_bitgrid(void) {
+    printf("Bit grid tests:\n");
+
+    BitGrid open, reach;
+    bitgrid_clear(&open);
+
+    // A passage that doubles back: right along row 2, down, left along
+    // row 6 across a word boundary, then up a dead end
+    for (int x = 10; x <= 150; x++) bitgrid_set(&open, x, 2, 1);
+    for (int y = 2; y <= 6; y++)    bitgrid_set(&open, 150, y, 1);
+    for (int x = 5; x <= 150; x++)  bitgrid_set(&open, x, 6, 1);
+    for (int y = 3; y <= 5; y++)    bitgrid_set(&open, 5, y, 1);
+    // Disconnected pocket
+    bitgrid_set(&open, 190, 90, 1);
+
+    ASSERT("bitgrid counts set bits", bitgrid_count(&open) == 141 + 3 + 146 + 3 + 1);
+
+    int x = -1, y = -1;
+    ASSERT("bitgrid_nth finds the first bit",
+        bitgrid_nth(&open, 0, &x, &y) && x == 10 && y == 2);
+    ASSERT("bitgrid_nth finds the last bit",
+        bitgrid_nth(&open, bitgrid_count(&open) - 1, &x, &y) && x == 190 && y == 90);
+    ASSERT("bitgrid_nth past the end fails",
+        !bitgrid_nth(&open, bitgrid_count(&open), &x, &y));
+
+    bitgrid_clear(&reach);
+    bitgrid_set(&reach, 10, 2, 1);
+    int n = bitgrid_flood(&reach, &open);
+    ASSERT("flood follows the passage to its dead end", bitgrid_get(&reach, 5, 3));
+    ASSERT("flood stops at disconnected tiles",
+        !bitgrid_get(&reach, 190, 90) && n == bitgrid_count(&open) - 1);
+
+    BitGrid step;
+    bitgrid_clear(&reach);
+    bitgrid_set(&reach, 10, 2, 1);
+    bitgrid_step(&step, &reach, &open);
+    ASSERT("one step grows by one open tile", bitgrid_count(&step) == 2);
+}
+
+void test_cave(void) {
+    printf("Cave generation tests:\n");
+
+    static Map m;
+    Rng rng;
+    rng_seed(&rng, 7);
+    int open = cave_generate(&m, 3, &rng);
+
+    ASSERT("cave covers the full grid", m.w == MAP_W && m.h == MAP_H);
+    ASSERT("cave has no rooms", m.room_count == 0);
+
+    int border_ok = 1, walkable = 0;
+    for (int x = 0; x < MAP_W; x++)
+        if (m.tiles[0][x] != TILE_WALL || m.tiles[MAP_H - 1][x] != TILE_WALL)
+            border_ok = 0;
+    for (int y = 0; y < MAP_H; y++) {
+        if (m.tiles[y][0] != TILE_WALL || m.tiles[y][MAP_W - 1] != TILE_WALL)
+            border_ok = 0;
+        for (int x = 0; x < MAP_W; x++)
+            if (m.tiles[y][x] != TILE_WALL) walkable++;
+    }
+    ASSERT("cave border is solid wall", border_ok);
+    ASSERT("returned size matches walkable tiles", open == walkable);
+    ASSERT("cave is a sizeable part of the map", walkable >= MAP_W * MAP_H / 4);
+
+    ASSERT("stairs up placed",
+        m.tiles[m.stairs_up_y][m.stairs_up_x] == TILE_STAIRS_UP);
+    ASSERT("stairs down placed",
+        m.tiles[m.stairs_down_y][m.stairs_down_x] == TILE_STAIRS_DOWN);
+    int dist = abs(m.stairs_up_x - m.stairs_down_x) +
+               abs(m.stairs_up_y - m.stairs_down_y);
+    ASSERT("stairs are far apart", dist >= 40);
+    ASSERT("every walkable tile is reachable from the stairs",
+        count_reachable(&m, m.stairs_up_x, m.stairs_up_y) == walkable);
+
+    static Map again;
+    rng_seed(&rng, 7);
+    cave_generate(&again, 3, &rng);
+    int same = 1;
+    for (int y = 0; y < MAP_H; y++)
+        for (int x = 0; x < MAP_W; x++)
+            if (m.tiles[y][x] != again.tiles[y][x]) same = 0;
+    ASSERT("same seed gives the same cave", same);
+
+    // A stream stuck at zero rolls nothing but wall
+    Rng stuck = { 0 };
+    open = cave_generate(&m, 3, &stuck);
+    ASSERT("a cave that never opens up still gets a room and both stairs",
+        open > 1 && m.tiles[m.stairs_up_y][m.stairs_up_x] == TILE_STAIRS_UP &&
+        m.tiles[m.stairs_down_y][m.stairs_down_x] == TILE_STAIRS_DOWN &&
+        count_reachable(&m, m.stairs_up_x, m.stairs_up_y) == open);
+}
@@ -2,6 +2,8 @@
 #include "../src/game/map.h"
 #include "../src/game/game.h"
 #include "../src/game/actions.h"
+#include "../src/game/pregen.h"
+#include "../src/game/rooms.h"
 #include <stdlib.h>
 #include <time.h>
 
@@ -32,6 +34,108 @@ void test_dungeon(void) {
         ASSERT("stairs down within bounds",
             m.stairs_down_x >= 0 && m.stairs_down_x < MAP_W &&
             m.stairs_down_y >= 0 && m.stairs_down_y < MAP_H);
+
+        ASSERT("level bounds fit the tile grid",
+            m.w > 0 && m.w <= MAP_W && m.h > 0 && m.h <= MAP_H);
+        int rooms_inside = 1;
+        for (int i = 0; i < m.room_count; i++)
+            if (m.rooms[i].x + m.rooms[i].w >= m.w ||
+                m.rooms[i].y + m.rooms[i].h >= m.h)
+                rooms_inside = 0;
+        ASSERT("rooms lie inside level bounds", rooms_inside);
+        ASSERT("stairs lie inside level bounds",
+            m.stairs_up_x < m.w && m.stairs_up_y < m.h &&
+            m.stairs_down_x < m.w && m.stairs_down_y < m.h);
+    }
+}
+
+void test_map_copy(void) {
+    printf("Map copy tests:\n");
+
+    Map src;
+    map_generate(&src, 1);
+    Map dst;
+    int spawn_x, spawn_y;
+    map_generate_town(&dst, &spawn_x, &spawn_y);
+    map_copy(&dst, &src);
+
+    ASSERT("bounds copied",     dst.w == src.w && dst.h == src.h);
+    ASSERT("rooms copied",      dst.room_count == src.room_count);
+    ASSERT("stairs copied",
+        dst.stairs_down_x == src.stairs_down_x &&
+        dst.stairs_down_y == src.stairs_down_y);
+    int same = 1;
+    for (int y = 0; y < src.h; y++)
+        for (int x = 0; x < src.w; x++)
+            if (dst.tiles[y][x] != src.tiles[y][x]) same = 0;
+    ASSERT("tiles inside bounds copied", same);
+}
+
+static int link_root(int *parent, int i) {
+    while (parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+static int rooms_apart(const Room *a, const Room *b) {
+    return a->x + a->w < b->x || b->x + b->w < a->x ||
+           a->y + a->h < b->y || b->y + b->h < a->y;
+}
+
+void test_bsp_layout(void) {
+    printf("BSP layout tests:\n");
+
+    ASSERT("early levels scatter rooms",
+        map_layout_for_level(1) == LAYOUT_SCATTER);
+    ASSERT("deeper levels use BSP",
+        map_layout_for_level(BSP_FIRST_LEVEL) == LAYOUT_BSP);
+
+    // Many rooms on a big area: exact count, no overlaps, links span all
+    enum { N = 1000 };
+    static Room rooms[N];
+    static RoomLink links[N];
+    static int parent[N];
+    Rng rng;
+    rng_seed(&rng, 99);
+    rooms_place_bsp(rooms, N, 2000, 1000, links, &rng);
+
+    int inside = 1, apart = 1, full_size = 1;
+    for (int i = 0; i < N; i++) {
+        const Room *r = &rooms[i];
+        if (r->x < 1 || r->y < 1 || r->x + r->w > 1999 || r->y + r->h > 999)
+            inside = 0;
+        if (r->w < MIN_ROOM_W || r->h < MIN_ROOM_H) full_size = 0;
+    }
+    for (int i = 0; i < N && apart; i++)
+        for (int j = i + 1; j < N; j++)
+            if (!rooms_apart(&rooms[i], &rooms[j])) { apart = 0; break; }
+    ASSERT("bsp rooms stay inside the area", inside);
+    ASSERT("bsp rooms never overlap", apart);
+    ASSERT("bsp rooms are full size on a roomy area", full_size);
+
+    for (int i = 0; i < N; i++) parent[i] = i;
+    int joined = 0;
+    for (int i = 0; i < N - 1; i++) {
+        int a = link_root(parent, links[i].a), b = link_root(parent, links[i].b);
+        if (a != b) { parent[a] = b; joined++; }
+    }
+    ASSERT("bsp links connect every room", joined == N - 1);
+
+    // Whole levels
+    for (int run = 0; run < 5; run++) {
+        static Map m;
+        map_generate_layout(&m, BSP_FIRST_LEVEL, LAYOUT_BSP, &rng);
+        ASSERT("bsp level has the room count it drew",
+            m.room_count >= MIN_ROOMS && m.room_count <= MAX_ROOMS);
+        ASSERT("bsp level spreads past the scatter span", m.w > MAP_W / 2 + MAX_ROOM_W + 1);
+        ASSERT("bsp level bounds fit the tile grid", m.w <= MAP_W && m.h <= MAP_H);
+
+        int floors_ok = 1;
+        for (int i = 0; i < m.room_count; i++) {
+            int cx, cy;
+            map_room_center(&m.rooms[i], &cx, &cy);
+            if (!map_is_walkable(&m, cx, cy)) floors_ok = 0;
+        }
+        ASSERT("bsp room centers are walkable", floors_ok);
     }
 }
 
@@ -52,8 +156,8 @@ void test_stairs_locked(void) {
     action_resolve_player(&g, a);
     ASSERT("cannot descend when level not cleared", g.level == level_before);
 
-    for (int i = 0; i < g.enemy_count; i++)
-        g.enemies[i].active = 0;
+    for (int i = 0; i < g.enemies.count; i++)
+        g.enemies.active[i] = 0;
     g.level_cleared = 1;
 
     action_resolve_player(&g, a);
@@ -75,8 +179,8 @@ void test_level_cache_cleared(void) {
     g.player.y = g.map.stairs_up_y;
 
     // Kill all enemies to clear level
-    for (int i = 0; i < g.enemy_count; i++)
-        g.enemies[i].active = 0;
+    for (int i = 0; i < g.enemies.count; i++)
+        g.enemies.active[i] = 0;
     g.level_cleared = 1;
 
     // Descend to level 2 — level 1 should be cached as cleared
@@ -84,7 +188,7 @@ void test_level_cache_cleared(void) {
     g.player.y = g.map.stairs_down_y;
     game_descend(&g);
     ASSERT("level is now 2",                    g.level == 2);
-    ASSERT("level 1 cached as cleared",         g.level_cache[0].level_cleared == 1);
+    ASSERT("level 1 cached as cleared",         level_store_get(&g.levels, 1)->level_cleared == 1);
     ASSERT("level 2 not cleared",               g.level_cleared == 0);
 
     // Ascend back to level 1 — should restore cleared state
@@ -93,4 +197,142 @@ void test_level_cache_cleared(void) {
     game_ascend(&g);
     ASSERT("back on level 1",                   g.level == 1);
     ASSERT("level 1 restored as cleared",       g.level_cleared == 1);
-}
\ No newline at end of file
+}
+
+static int walk_length(const GameState *g, int x, int y) {
+    Path p;
+    return path_find(&g->map, x, y, g->player.x, g->player.y, &p);
+}
+
+// Leave the current level for `turns` turns and come back up to it
+static void away_from_level(GameState *g, int turns) {
+    game_descend(g);
+    g->turn += turns;
+    game_ascend(g);
+}
+
+void test_level_catch_up(void) {
+    printf("Level catch-up tests:\n");
+
+    static GameState g;
+    game_init(&g);
+    g.location = LOCATION_DUNGEON;
+    g.level    = 1;
+    map_generate(&g.map, g.level);
+    enemies_spawn(&g);
+    for (int i = 0; i < g.enemies.count; i++)
+        g.enemies.hp[i] = 1;
+
+    static EnemyPool before;
+    int count = g.enemies.count;
+    away_from_level(&g, 0);
+    before = g.enemies;
+    int same = g.enemies.count == count;
+    for (int i = 0; i < count; i++)
+        if (g.enemies.hp[i] != 1) same = 0;
+    ASSERT("no time away, no change", same);
+
+    away_from_level(&g, 55);
+    int healed = 1, moved = 0, placed = 1, closer = 1;
+    const EnemyPool *p = &g.enemies;
+    for (int i = 0; i < p->count; i++) {
+        int x = p->x[i], y = p->y[i];
+        if (p->hp[i] != 1 + 55 / 10 && p->hp[i] != p->max_hp[i]) healed = 0;
+        if (!map_is_walkable(&g.map, x, y)) placed = 0;
+        // A level may spawn an enemy beside the stairs; only those that
+        // wandered are held to stopping short of the player
+        int wandered = x != before.x[i] || y != before.y[i];
+        if (wandered && abs(x - g.player.x) <= 1 && abs(y - g.player.y) <= 1) placed = 0;
+        for (int j = 0; j < i; j++)
+            if (p->x[j] == x && p->y[j] == y) placed = 0;
+        moved += wandered;
+        if (walk_length(&g, x, y) > walk_length(&g, before.x[i], before.y[i])) closer = 0;
+    }
+    ASSERT("enemies heal once per ten turns away", healed);
+    ASSERT("enemies wander toward the stairs", moved > 0 && closer);
+    ASSERT("wanderers keep apart and off the stairs", placed);
+
+    away_from_level(&g, 100000);
+    int full = 1;
+    for (int i = 0; i < p->count; i++)
+        if (p->hp[i] != p->max_hp[i]) full = 0;
+    ASSERT("healing stops at max hp", full);
+
+    for (int i = 0; i < g.enemies.count; i++)
+        g.enemies.active[i] = 0;
+    g.level_cleared = 1;
+    away_from_level(&g, 299);
+    int alive = 0;
+    for (int i = 0; i < p->count; i++) alive += p->active[i];
+    ASSERT("cleared level stays empty for a while", alive == 0);
+
+    away_from_level(&g, 900);
+    alive = 0;
+    for (int i = 0; i < p->count; i++) alive += p->active[i];
+    ASSERT("cleared level restocks after long enough", alive == 3);
+    ASSERT("restocked level keeps its stairs open", g.level_cleared == 1);
+
+    away_from_level(&g, 1000000);
+    ASSERT("restocking is capped", g.enemies_alive == (10 + 1) / 2);
+
+    // Deep down the roster is clamped to MAX_ENEMIES, and so is its half
+    int deep[] = { 6, 20, MAX_DEPTH - 1 };
+    int capped = 1;
+    for (int k = 0; k < 3; k++) {
+        game_free(&g);
+        game_init(&g);
+        g.location = LOCATION_DUNGEON;
+        g.level    = deep[k];
+        map_generate(&g.map, g.level);
+        enemies_spawn(&g);
+        for (int i = 0; i < g.enemies.count; i++) g.enemies.active[i] = 0;
+        game_refresh_occupancy(&g);
+        g.level_cleared = 1;
+        away_from_level(&g, 1000000);
+        int boss = deep[k] == 20;
+        if (g.level != deep[k] || g.enemies_alive != (MAX_ENEMIES - boss) / 2) capped = 0;
+    }
+    ASSERT("deep levels restock to half the clamped roster", capped);
+    game_free(&g);
+}
+void test_pregen(void) {
+    printf("Level pre-generation tests:\n");
+
+    // Same seed, same level
+    Map a, b;
+    Rng ra, rb;
+    rng_seed(&ra, 42);
+    rng_seed(&rb, 42);
+    map_generate_rng(&a, 3, &ra);
+    map_generate_rng(&b, 3, &rb);
+    ASSERT("seeded generation is repeatable",
+        a.room_count == b.room_count &&
+        a.stairs_down_x == b.stairs_down_x &&
+        a.stairs_down_y == b.stairs_down_y);
+
+    // Background level is adopted once
+    Map m;
+    EnemyPool enemies;
+    pregen_request(7);
+    ASSERT("requested level is adopted",
+        pregen_take(7, &m, &enemies) == 1);
+    ASSERT("adopted level has stairs",
+        m.tiles[m.stairs_down_y][m.stairs_down_x] == TILE_STAIRS_DOWN);
+    ASSERT("adopted level has enemies", enemies.count > 0);
+    ASSERT("level is only adopted once",
+        pregen_take(7, &m, &enemies) == 0);
+    ASSERT("unrequested level is not adopted",
+        pregen_take(8, &m, &enemies) == 0);
+
+    // Descending picks up the level queued on entry
+    GameState g;
+    game_init(&g);
+    g.location = LOCATION_DUNGEON;
+    map_generate(&g.map, 1);
+    enemies_spawn(&g);
+    g.level_cleared = 1;
+    game_descend(&g);
+    ASSERT("descended level has stairs up under player",
+        g.map.tiles[g.player.y][g.player.x] == TILE_STAIRS_UP);
+    pregen_shutdown();
+}
@@ -0,0 +1,87 @@
+#include "test_utils.h"
+#include "test_fixtures.h"
+#include "../src/game/effects.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+void test_effects(void) {
+    printf("Effect tests:\n");
+
+    static Effects fx;
+    EffectFired fired[MAX_EFFECTS];
+    effects_init(&fx, 10);
+    effects_add(&fx, 0, EFFECT_POISON, 3);
+    int ticks = 0, hurt = 0, gone = 0;
+    for (int turn = 11; turn <= 20; turn++) {
+        int n = effects_advance(&fx, turn, fired, MAX_EFFECTS);
+        for (int k = 0; k < n; k++) {
+            ticks++;
+            hurt += fired[k].hp;
+            if (fired[k].turns_left == 0) gone = turn;
+        }
+    }
+    ASSERT("poison ticks once a turn while it lasts", ticks == 3 && hurt == -9);
+    ASSERT("and wears off on its last turn", gone == 13 && !effects_has(&fx, 0, EFFECT_POISON));
+
+    // Long effects wait a span out on the upper wheel
+    effects_init(&fx, 0);
+    effects_add(&fx, EFFECT_PLAYER, EFFECT_HASTE, 1000);
+    effects_add(&fx, 3, EFFECT_SLOW, 70);
+    int quiet = 1, slow_end = 0, haste_end = 0;
+    for (int turn = 1; turn <= 1100; turn++) {
+        int n = effects_advance(&fx, turn, fired, MAX_EFFECTS);
+        for (int k = 0; k < n; k++) {
+            if (fired[k].turns_left != 0) quiet = 0;
+            if (fired[k].kind == EFFECT_SLOW) slow_end = turn;
+            if (fired[k].kind == EFFECT_HASTE) haste_end = turn;
+        }
+    }
+    ASSERT("effects that never tick only fire when they end", quiet);
+    ASSERT("each ends on its turn", slow_end == 70 && haste_end == 1000);
+
+    effects_init(&fx, 0);
+    effects_add(&fx, 2, EFFECT_MIGHT, 5);
+    ASSERT("a renewed effect does not stack",
+           effects_add(&fx, 2, EFFECT_MIGHT, 50) == 0 && fx.mods[2].attack == EFFECT_TRAITS[EFFECT_MIGHT].attack);
+    effects_add(&fx, 2, EFFECT_SLOW, 5);
+    ASSERT("speed changes apply while they last", effects_speed(&fx, 2) == 50);
+    effects_advance(&fx, 6, fired, MAX_EFFECTS);
+    ASSERT("a renewed effect lasts the longer time",
+           effects_has(&fx, 2, EFFECT_MIGHT) && !effects_has(&fx, 2, EFFECT_SLOW) &&
+           effects_speed(&fx, 2) == 100);
+    effects_clear_target(&fx, 2);
+    ASSERT("clearing a target takes its changes back", fx.count == 0 && fx.mods[2].attack == 0);
+
+    // In the game: on open floor with the player standing still
+    static GameState g;
+    game_init(&g);
+    fixture_open_floor(&g, 20, 10, 10, 5);
+    g.player.max_hp = g.player.hp = 100;
+
+    game_apply_effect(&g, EFFECT_PLAYER, EFFECT_POISON, 3);
+    for (int turn = 0; turn < 5; turn++) action_resolve_enemies(&g);
+    ASSERT("poison ticks on turns the player does not walk", g.player.hp == 91);
+
+    int attack = g.player.attack;
+    game_apply_effect(&g, EFFECT_PLAYER, EFFECT_MIGHT, 2);
+    int buffed = g.player.attack;
+    for (int turn = 0; turn < 2; turn++) action_resolve_enemies(&g);
+    ASSERT("a buff lasts its turns and is then taken back",
+           buffed == attack + EFFECT_TRAITS[EFFECT_MIGHT].attack && g.player.attack == attack);
+
+    const EnemyPool *p = &g.enemies;
+    int e = game_spawn_enemy(&g, ENEMY_SKELETON, 3, 5);
+    game_apply_effect(&g, 0, EFFECT_BURN, 10);
+    int xp = g.player.experience;
+    for (int turn = 0; turn < 5; turn++) action_resolve_enemies(&g);
+    ASSERT("burning kills an enemy and ends with it",
+           !p->active[e] && g.player.experience > xp && !effects_has(&g.effects, 0, EFFECT_BURN));
+
+    // A hasted player gets two moves to each of the enemies'
+    e = game_spawn_enemy(&g, ENEMY_SKELETON, 2, 5);
+    game_wake_enemy(&g, e);
+    game_apply_effect(&g, EFFECT_PLAYER, EFFECT_HASTE, 100);
+    int x0 = p->x[e];
+    for (int turn = 0; turn < 4; turn++) action_resolve_enemies(&g);
+    ASSERT("haste halves what enemies do per player turn", p->x[e] - x0 == 2);
+}
@@ -0,0 +1,88 @@
+#include "test_utils.h"
+#include "test_fixtures.h"
+#include "../src/game/enemy.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+void test_enemy(void) {
+    printf("Enemy tests:\n");
+
+    int named = 1, bosses_pay_in_items = 1;
+    for (int t = 0; t < ENEMY_TYPE_COUNT; t++) {
+        const EnemyArchetype *a = &ENEMY_ARCHETYPES[t];
+        if (!a->name || !a->name[0] || a->max_hp <= 0)
+            named = 0;
+        if (a->is_boss && a->gold_span) bosses_pay_in_items = 0;
+    }
+    ASSERT("every enemy type has a row", named);
+    ASSERT("bosses drop items, not gold", bosses_pay_in_items);
+
+    static EnemyPool pool;
+    enemy_spawn(&pool, 2, ENEMY_TROLL, 3, 4);
+    ASSERT("spawned enemy is at full health",
+           pool.active[2] && pool.x[2] == 3 && pool.y[2] == 4 &&
+           pool.hp[2] == 40 && pool.max_hp[2] == 40 && !pool.awake[2] &&
+           strcmp(ENEMY_KIND(&pool, 2)->name, "Troll") == 0);
+
+    // An empty floor to fill and clear
+    static GameState g;
+    game_init(&g);
+    memset(&g.map, 0, sizeof(g.map));
+    g.map.w = 20;
+    g.map.h = 10;
+    g.player.x = 1;
+    g.player.y = 1;
+    g.enemies.count = 0;
+    g.level_cleared = 0;
+    game_refresh_occupancy(&g);
+    for (int i = 0; i < 3; i++) game_spawn_enemy(&g, ENEMY_SKELETON, 5 + i, 5);
+    ASSERT("spawns count as alive", g.enemies.count == 3 && g.enemies_alive == 3);
+    ASSERT("spawns are on the board", game_enemy_at(&g, 6, 5) == 1);
+
+    game_kill_enemy(&g, 1);
+    ASSERT("a kill leaves the board", game_enemy_at(&g, 6, 5) == ENEMY_NONE && g.enemies_alive == 2);
+    int back = game_spawn_enemy(&g, ENEMY_GOBLIN, 9, 9);
+    ASSERT("the next spawn takes the dead slot",
+           back == 1 && g.enemies.count == 3 && game_enemy_at(&g, 9, 9) == back);
+
+    game_kill_enemy(&g, 0);
+    game_kill_enemy(&g, 1);
+    ASSERT("level stays closed while any enemy lives", !g.level_cleared);
+    game_kill_enemy(&g, 2);
+    ASSERT("the last kill clears the level", g.level_cleared && g.enemies_alive == 0);
+
+    for (int i = 0; i < MAX_ENEMIES; i++) game_spawn_enemy(&g, ENEMY_ORC, i, 7);
+    ASSERT("a full level takes no more", game_spawn_enemy(&g, ENEMY_ORC, 0, 8) == ENEMY_NONE &&
+           g.enemies_alive == MAX_ENEMIES);
+    game_refresh_occupancy(&g);
+    ASSERT("a rebuild counts the same", g.enemies_alive == MAX_ENEMIES && g.enemy_free_count == 0);
+
+    // A long hall with a room at its far end
+    fixture_open_floor(&g, 60, 12, 2, 5);
+    g.map.rooms[0]    = (Room){ 40, 1, 19, 10 };
+    g.map.room_count  = 1;
+    g.player.hp = 10000;
+    game_spawn_enemy(&g, ENEMY_SKELETON, 20, 5); // in the hall
+    game_spawn_enemy(&g, ENEMY_SKELETON, 55, 2); // in the room
+    game_spawn_enemy(&g, ENEMY_SKELETON, 57, 9); // in the room
+    for (int turn = 0; turn < 10; turn++) action_resolve_enemies(&g);
+    ASSERT("far enemies sleep where they are",
+           g.schedule.count == 0 && g.enemies.x[0] == 20 && g.enemies.x[2] == 57);
+
+    g.player.x = 13;
+    action_resolve_enemies(&g);
+    ASSERT("coming close wakes an enemy",
+           g.enemies.awake[0] && !g.enemies.awake[1] && g.schedule.count == 1);
+    ASSERT("an awake enemy chases", g.enemies.x[0] < 20);
+
+    g.player.x = 40;
+    action_resolve_enemies(&g);
+    ASSERT("entering a room wakes everyone in it",
+           g.enemies.awake[1] && g.enemies.awake[2] && g.schedule.count == 3);
+
+    game_kill_enemy(&g, 1);
+    ASSERT("the dead leave the schedule",
+           g.schedule.count == 2 && !schedule_has(&g.schedule, 1));
+    game_refresh_occupancy(&g);
+    ASSERT("a rebuild keeps who was awake", g.schedule.count == 2);
+}
@@ -0,0 +1,67 @@
+#include "test_utils.h"
+#include "test_fixtures.h"
+#include "../src/game/events.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+static int says(const GameEvent *ev, const char *text) {
+    char buf[MAX_MESSAGE_LEN];
+    if (!ev) return 0;
+    event_format(ev, buf, sizeof(buf));
+    return strcmp(buf, text) == 0;
+}
+
+void test_events(void) {
+    printf("Event tests:\n");
+
+    static EventLog log;
+    events_clear(&log);
+    ASSERT("a new log is empty", events_count(&log) == 0 && events_recent(&log, 0) == NULL);
+
+    for (int i = 0; i < EVENT_LOG_SIZE + 6; i++)
+        events_push(&log, EVENT_GOLD, i)->a = i;
+    ASSERT("a full ring keeps the newest events",
+           events_count(&log) == EVENT_LOG_SIZE &&
+           events_recent(&log, 0)->a == EVENT_LOG_SIZE + 5 &&
+           events_recent(&log, EVENT_LOG_SIZE - 1)->a == 6 &&
+           events_recent(&log, EVENT_LOG_SIZE) == NULL);
+    ASSERT("events keep their turn", events_recent(&log, 0)->turn == EVENT_LOG_SIZE + 5);
+
+    GameEvent *ev = events_push(&log, EVENT_SELL, 0);
+    event_set_name(ev, "Bow");
+    ev->a = 10;
+    ASSERT("text is made from the record", says(events_recent(&log, 0), "Sold Bow for 10 gold"));
+    ev = events_push(&log, EVENT_HURT, 0);
+    ev->subject = ENEMY_SKELETON;
+    ev->a = 4;
+    char want[MAX_MESSAGE_LEN];
+    snprintf(want, sizeof(want), "%s: 4 dmg", ENEMY_ARCHETYPES[ENEMY_SKELETON].name);
+    ASSERT("enemies are named from their type", says(ev, want));
+    events_push(&log, EVENT_NOTE, 0)->subject = NOTE_NO_PATH;
+    ASSERT("notes are fixed lines", says(events_recent(&log, 0), "No path there"));
+    event_set_name(ev = events_push(&log, EVENT_LEARN, 0), "A name far longer than any item has");
+    ASSERT("long names are cut short", strlen(ev->name) == EVENT_NAME_LEN - 1);
+
+    ev = events_push(&log, EVENT_KILL, 0);
+    ev->subject = 250;
+    ASSERT("ids from a damaged save format safely", says(ev, "Killed ?!"));
+    ev->kind = 250;
+    ASSERT("as do kinds", says(ev, "?"));
+
+    // The game logs what it does and the bar shows the last of it
+    static GameState g;
+    game_init(&g);
+    fixture_open_floor(&g, 20, 10, 10, 5);
+    g.player.attack = 1000;
+    int e = game_spawn_enemy(&g, ENEMY_GOBLIN, 11, 5);
+    g.turn = 7;
+    action_resolve_player(&g, (Action){ACTION_MOVE, 11, 5});
+    const GameEvent *kill = NULL;
+    for (int i = 0; i < events_count(&g.events); i++)
+        if (events_recent(&g.events, i)->kind == EVENT_KILL) kill = events_recent(&g.events, i);
+    ASSERT("a kill is logged with who and when",
+           !g.enemies.active[e] && kill && kill->subject == ENEMY_GOBLIN && kill->turn == 7);
+    action_resolve_player(&g, (Action){ACTION_PICK_UP, 0, 0});
+    ASSERT("the newest event is what the bar shows last",
+           says(events_recent(&g.events, 0), "Nothing to pick up"));
+}
@@ -0,0 +1,26 @@
+#include "test_fixtures.h"
+#include <string.h>
+
+void fixture_open_floor(GameState *g, int w, int h, int px, int py) {
+    memset(&g->map, 0, sizeof(g->map));
+    g->map.w = w;
+    g->map.h = h;
+    for (int y = 0; y < h; y++)
+        memset(g->map.tiles[y], TILE_WALL, w);
+    for (int y = 1; y < h - 1; y++)
+        memset(&g->map.tiles[y][1], TILE_FLOOR, w - 2);
+    g->player.x = px;
+    g->player.y = py;
+    g->enemies.count = 0;
+    game_refresh_regions(g);
+    game_refresh_occupancy(g);
+}
+
+int fixture_add_enemy(GameState *g, int x, int y) {
+    EnemyPool *p = &g->enemies;
+    int i = p->count++;
+    enemy_spawn(p, i, ENEMY_SKELETON, x, y);
+    p->hp[i] = p->max_hp[i] = 1;
+    p->awake[i] = 1;
+    return i;
+}
@@ -0,0 +1,14 @@
+#ifndef TEST_FIXTURES_HEADER_H
+#define TEST_FIXTURES_HEADER_H
+
+#include "../src/game/game.h"
+
+// A w x h floor walled round its edge, with the player at (px, py) and
+// no enemies. Tests that add walls call game_refresh_regions again.
+void   fixture_open_floor(GameState *g, int w, int h, int px, int py);
+
+// An awake 1 hp skeleton at (x, y), put straight into the enemy pool;
+// call game_refresh_occupancy once every one is placed. Returns its index.
+int    fixture_add_enemy(GameState *g, int x, int y);
+
+#endif
@@ -0,0 +1,74 @@
+#include "test_utils.h"
+#include "test_fixtures.h"
+#include "../src/game/flow.h"
+#include "../src/game/game.h"
+#include <stdlib.h>
+#include <string.h>
+
+// A walled 60x30 room of floor
+static void open_room(Map *m) {
+    memset(m, 0, sizeof(*m));
+    m->w = 60;
+    m->h = 30;
+    for (int y = 0; y < m->h; y++)
+        memset(m->tiles[y], TILE_WALL, m->w);
+    for (int y = 1; y < m->h - 1; y++)
+        memset(&m->tiles[y][1], TILE_FLOOR, m->w - 2);
+}
+
+void test_flow(void) {
+    printf("Flow field tests:\n");
+
+    static Map m;
+    static FlowField f;
+    open_room(&m);
+    flow_init(&f);
+    ASSERT("a new field reaches nothing", flow_dist(&f, 10, 10) == FLOW_UNREACHED);
+    ASSERT("building the field reports a rebuild", flow_update(&f, &m, 10, 10) == 1);
+    ASSERT("the origin is zero steps away", flow_dist(&f, 10, 10) == 0);
+    ASSERT("diagonals cost one step",
+           flow_dist(&f, 13, 13) == 3 && flow_dist(&f, 15, 12) == 5);
+    ASSERT("walls and off-map tiles are unreached",
+           flow_dist(&f, 0, 10) == FLOW_UNREACHED && flow_dist(&f, -1, 10) == FLOW_UNREACHED &&
+           flow_dist(&f, 10, MAP_H) == FLOW_UNREACHED);
+    ASSERT("tiles past the radius are unreached",
+           flow_dist(&f, 10 + FLOW_RADIUS + 1, 10) == FLOW_UNREACHED &&
+           flow_dist(&f, 10 + FLOW_RADIUS, 10) == FLOW_RADIUS);
+    ASSERT("an unmoved origin is not rebuilt", flow_update(&f, &m, 10, 10) == 0);
+
+    // A wall across the room, open only at the bottom
+    for (int y = 1; y < 12; y++) m.tiles[y][20] = TILE_WALL;
+    flow_invalidate(&f);
+    ASSERT("an invalidated field reaches nothing", flow_dist(&f, 12, 10) == FLOW_UNREACHED);
+    flow_update(&f, &m, 15, 5);
+    ASSERT("distances go around walls",
+           flow_dist(&f, 25, 5) == 14 && flow_dist(&f, 19, 5) == 4);
+
+    flow_update(&f, &m, 58, 28);
+    ASSERT("a moved origin leaves nothing of the old field behind",
+           flow_dist(&f, 58, 28) == 0 && f.dist[5][2] == FLOW_UNREACHED);
+
+    // Several enemies behind a wall all come around it to the player
+    static GameState g;
+    game_init(&g);
+    open_room(&g.map);
+    for (int y = 1; y < 12; y++) g.map.tiles[y][20] = TILE_WALL;
+    game_refresh_regions(&g);
+    g.player.x  = 10;
+    g.player.y  = 5;
+    g.player.hp = 10000;
+    g.enemies.count = 0;
+    for (int i = 0; i < 4; i++) fixture_add_enemy(&g, 30 + i * 2, 3 + i);
+    game_refresh_occupancy(&g);
+    const EnemyPool *p = &g.enemies;
+    int turns = 0, arrived = 0;
+    while (turns < 80 && arrived < p->count) {
+        action_resolve_enemies(&g);
+        turns++;
+        arrived = 0;
+        for (int i = 0; i < p->count; i++)
+            if (abs(p->x[i] - g.player.x) <= 2 && abs(p->y[i] - g.player.y) <= 2)
+                arrived++;
+    }
+    ASSERT("a pack comes around the wall to the player", arrived == p->count);
+}
@@ -0,0 +1,107 @@
+#include "test_utils.h"
+#include "test_fixtures.h"
+#include "../src/game/intent.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+#define HORDE 300
+
+static int same_intent(EnemyIntent a, EnemyIntent b) {
+    return a.kind == b.kind && (a.kind != INTENT_MOVE || (a.x == b.x && a.y == b.y));
+}
+
+void test_intent(void) {
+    printf("Intent tests:\n");
+
+    static GameState g;
+    game_init(&g);
+    fixture_open_floor(&g, 60, 20, 30, 10);
+    g.player.hp = 10000;
+    for (int i = 0; i < MAX_ENEMIES; i++) fixture_add_enemy(&g, 4 + i * 3, 3);
+    game_refresh_occupancy(&g);
+    flow_update(&g.flow, &g.map, g.player.x, g.player.y);
+    senses_update(&g.senses, &g.regions, &g.open, g.player.x, g.player.y);
+
+    // A horde far bigger than a level holds, some of it next to the player
+    static int xs[HORDE], ys[HORDE], ids[HORDE];
+    static EnemyIntent serial[HORDE], pooled[HORDE];
+    for (int k = 0; k < HORDE; k++) {
+        xs[k]  = 1 + (k * 7) % 58;
+        ys[k]  = 1 + (k * 5) % 18;
+        ids[k] = HORDE - 1 - k;
+    }
+    xs[0] = 31;
+    ys[0] = 11;
+    intent_plan(&g, xs, ys, ids, HORDE, serial, NULL);
+
+    static ThreadPool pool;
+    pool_init(&pool, 4);
+    memset(pooled, 0xAB, sizeof(pooled));
+    intent_plan(&g, xs, ys, ids, HORDE, pooled, &pool);
+    int same = 1, moving = 0;
+    for (int k = 0; k < HORDE; k++) {
+        if (!same_intent(serial[k], pooled[k]) ||
+            !same_intent(serial[k], intent_decide(&g, xs[ids[k]], ys[ids[k]])))
+            same = 0;
+        moving += serial[k].kind == INTENT_MOVE;
+    }
+    ASSERT("planning on threads gives the same plans", same);
+    ASSERT("the horde closes in", moving > HORDE / 2);
+    ASSERT("an enemy beside the player attacks", serial[HORDE - 1].kind == INTENT_ATTACK);
+
+    int blocked = 1;
+    for (int k = 0; k < HORDE; k++)
+        if (serial[k].kind == INTENT_MOVE &&
+            (game_enemy_at(&g, serial[k].x, serial[k].y) != ENEMY_NONE ||
+             (serial[k].x == g.player.x && serial[k].y == g.player.y)))
+            blocked = 0;
+    ASSERT("no plan steps onto an enemy or the player", blocked);
+
+    // Two enemies after the same tile: the first takes it, the second
+    // plans again instead of stacking or standing still
+    fixture_open_floor(&g, 60, 20, 30, 10);
+    fixture_add_enemy(&g, 32, 9);
+    fixture_add_enemy(&g, 32, 11);
+    game_refresh_occupancy(&g);
+    flow_update(&g.flow, &g.map, g.player.x, g.player.y);
+    int both[2] = { 0, 1 };
+    EnemyIntent plans[2];
+    intent_plan(&g, g.enemies.x, g.enemies.y, both, 2, plans, NULL);
+    ASSERT("both plan the same step",
+           plans[0].kind == INTENT_MOVE && plans[1].kind == INTENT_MOVE &&
+           plans[0].x == plans[1].x && plans[0].y == plans[1].y);
+    action_resolve_enemies(&g);
+    const EnemyPool *p = &g.enemies;
+    ASSERT("the first enemy takes the tile", p->x[0] == plans[0].x && p->y[0] == plans[0].y);
+    ASSERT("the second steps elsewhere",
+           !(p->x[1] == p->x[0] && p->y[1] == p->y[0]) && !(p->x[1] == 32 && p->y[1] == 11) &&
+           game_enemy_at(&g, p->x[1], p->y[1]) == 1);
+
+    // A full level's crowd racing for the same tiles ends up on the same
+    // board with the game's pool installed as without; its waves are
+    // under INTENT_POOL_MIN, so the pool leaves them to be planned in place
+    static GameState threaded;
+    fixture_open_floor(&g, 60, 20, 10, 10);
+    g.player.hp = 10000;
+    for (int i = 0; i < MAX_ENEMIES; i++) fixture_add_enemy(&g, 50 + i % 2, 2 + i);
+    game_refresh_occupancy(&g);
+    memcpy(&threaded, &g, sizeof(g));
+    int board = 1, apart = 1;
+    for (int turn = 0; turn < 40; turn++) {
+        action_set_intent_pool(NULL);
+        action_resolve_enemies(&g);
+        action_set_intent_pool(&pool);
+        action_resolve_enemies(&threaded);
+        const EnemyPool *t = &threaded.enemies;
+        for (int i = 0; i < MAX_ENEMIES; i++) {
+            if (p->x[i] != t->x[i] || p->y[i] != t->y[i]) board = 0;
+            for (int j = 0; j < i; j++)
+                if (t->x[i] == t->x[j] && t->y[i] == t->y[j]) apart = 0;
+        }
+        if (g.player.hp != threaded.player.hp) board = 0;
+    }
+    action_set_intent_pool(NULL);
+    pool_free(&pool);
+    ASSERT("waves resolve to the same board with the pool installed", board);
+    ASSERT("and never stack enemies", apart);
+}
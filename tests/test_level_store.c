@@ -0,0 +1,142 @@
+#include "test_utils.h"
+#include "../src/game/level_store.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+#define TEST_LEVELS "test_levels.bin"
+#define STORED      10
+
+static void fill(LevelCache *c, int level, int mark) {
+    c->map.w           = level;
+    c->map.tiles[0][0] = (unsigned char)mark;
+    c->enemies.count   = level % MAX_ENEMIES;
+    c->left_turn       = level * 7;
+}
+
+static int holds(const LevelCache *c, int level, int mark) {
+    return c && c->map.w == level && c->map.tiles[0][0] == mark &&
+           c->enemies.count == level % MAX_ENEMIES && c->left_turn == level * 7;
+}
+
+static int resident(const LevelStore *s, int level) {
+    for (int i = 0; i < LEVEL_STORE_RESIDENT; i++)
+        if (s->slot_level[i] == level) return 1;
+    return 0;
+}
+
+void test_level_store(void) {
+    printf("Level store tests:\n");
+
+    static LevelStore s, loaded;
+    level_store_init(&s);
+    ASSERT("new store holds nothing",
+           !level_store_has(&s, 1) && level_store_get(&s, 1) == NULL);
+
+    for (int level = 1; level <= STORED; level++)
+        fill(level_store_put(&s, level), level, level);
+    int recent = 1;
+    for (int level = 1; level <= STORED; level++)
+        if (resident(&s, level) != (level > STORED - LEVEL_STORE_RESIDENT)) recent = 0;
+    ASSERT("only the most recent levels stay in memory", recent);
+    ASSERT("the rest went to the file", s.records == STORED - LEVEL_STORE_RESIDENT);
+
+    int back = 1;
+    for (int pass = 0; pass < 2; pass++)
+        for (int level = 1; level <= STORED; level++)
+            if (!holds(level_store_get(&s, level), level, level)) back = 0;
+    ASSERT("evicted levels page back in unchanged", back);
+    ASSERT("unchanged levels are not written again", s.records == STORED);
+
+    fill(level_store_put(&s, 2), 2, 99);
+    for (int level = 3; level <= STORED; level++) level_store_get(&s, level);
+    ASSERT("a changed level is written over its old record",
+           !resident(&s, 2) && holds(level_store_get(&s, 2), 2, 99) &&
+           s.records == STORED);
+
+    remove(TEST_LEVELS);
+    ASSERT("first save writes every level", level_store_save(&s, TEST_LEVELS) == STORED);
+    ASSERT("saving again writes nothing", level_store_save(&s, TEST_LEVELS) == 0);
+    fill(level_store_put(&s, 5), 5, 55);
+    ASSERT("then only what changed", level_store_save(&s, TEST_LEVELS) == 1);
+
+    level_store_init(&loaded);
+    int same = level_store_load(&loaded, TEST_LEVELS) && !level_store_has(&loaded, STORED + 1);
+    for (int level = 1; level <= STORED; level++) {
+        int mark = level == 2 ? 99 : level == 5 ? 55 : level;
+        if (!holds(level_store_get(&loaded, level), level, mark)) same = 0;
+    }
+    ASSERT("saved levels load back", same);
+    ASSERT("a loaded run saves over its file incrementally",
+           level_store_save(&loaded, TEST_LEVELS) == 0);
+    ASSERT("another run rewrites the file", level_store_save(&s, TEST_LEVELS) == STORED);
+
+    FILE *f = fopen(TEST_LEVELS, "r+b");
+    if (f) {
+        fputc('X', f);
+        fclose(f);
+    }
+    ASSERT("a file from another build is refused", !level_store_load(&loaded, TEST_LEVELS));
+    remove(TEST_LEVELS);
+
+    // A byte copy, as a snapshot makes, needs its paged out levels adopted
+    level_store_clear(&loaded);
+    memcpy(&loaded, &s, sizeof(s));
+    level_store_detach(&loaded);
+    ASSERT("a detached copy keeps only its resident levels",
+           level_store_has(&loaded, STORED) && !level_store_has(&loaded, 1));
+    for (int level = 1; level <= STORED; level++) {
+        const LevelCache *c = level_store_paged_out(&s, level);
+        if (c) level_store_adopt(&loaded, level, c);
+    }
+    int adopted = loaded.data != s.data;
+    for (int level = 1; level <= STORED; level++) {
+        int mark = level == 2 ? 99 : level == 5 ? 55 : level;
+        if (!holds(level_store_get(&loaded, level), level, mark)) adopted = 0;
+    }
+    ASSERT("adopted levels live in the copy's own file", adopted);
+
+    level_store_clear(&s);
+    level_store_clear(&loaded);
+    ASSERT("cleared store holds nothing", !level_store_has(&s, 1) && s.data == NULL);
+
+    // Deep enough that the first levels are paged out on the way down
+    static GameState g;
+    game_init(&g);
+    game_enter_dungeon(&g);
+    int ups[STORED + 1];
+    for (int level = 1; level < STORED; level++) {
+        ups[level] = g.map.stairs_up_y * MAP_W + g.map.stairs_up_x;
+        game_descend(&g);
+    }
+    int kept = 1;
+    for (int level = STORED - 1; level >= 1; level--) {
+        game_ascend(&g);
+        if (g.level != level || g.map.stairs_up_y * MAP_W + g.map.stairs_up_x != ups[level])
+            kept = 0;
+    }
+    ASSERT("a long trip down and back finds every level as left", kept);
+
+    // A copy that lost its paged out levels, as when a snapshot's records
+    // cannot be adopted, builds them again on the way up
+    static GameState lost;
+    for (int level = 1; level < STORED; level++) game_descend(&g);
+    memcpy(&lost, &g, sizeof(g));
+    level_store_detach(&lost.levels);
+    game_free(&g);
+    static Map below;
+    int fresh = 1;
+    for (int level = STORED - 1; level >= 1; level--) {
+        map_copy(&below, &lost.map);
+        game_ascend(&lost);
+        int tiles_same = 1;
+        for (int y = 0; y < below.h; y++)
+            if (memcmp(lost.map.tiles[y], below.tiles[y], below.w)) tiles_same = 0;
+        if (lost.level != level || tiles_same ||
+            lost.map.tiles[lost.player.y][lost.player.x] != TILE_STAIRS_DOWN)
+            fresh = 0;
+    }
+    ASSERT("a dropped level is generated again, not left as the one above", fresh);
+    ASSERT("the dropped level is peopled",
+           lost.enemies.count > 0 && game_enemy_at(&lost, lost.enemies.x[0], lost.enemies.y[0]) == 0);
+    game_free(&lost);
+}
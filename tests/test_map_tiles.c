@@ -1,5 +1,7 @@
 #include "test_utils.h"
 #include "../src/game/map.h"
+#include "../src/game/bitgrid.h"
+#include <string.h>
 #include <stdlib.h>
 #include <time.h>
 
@@ -11,11 +13,13 @@ void test_map_tiles(void) {
     Map m;
     map_generate(&m, 1);
 
-    // Border tiles are walls
-    ASSERT("top-left corner is wall",     m.tiles[0][0]             == TILE_WALL);
-    ASSERT("top-right corner is wall",    m.tiles[0][MAP_W-1]       == TILE_WALL);
-    ASSERT("bottom-left corner is wall",  m.tiles[MAP_H-1][0]       == TILE_WALL);
-    ASSERT("bottom-right corner is wall", m.tiles[MAP_H-1][MAP_W-1] == TILE_WALL);
+    // Border tiles of the level bounds are walls
+    ASSERT("top-left corner is wall",     m.tiles[0][0]         == TILE_WALL);
+    ASSERT("top-right corner is wall",    m.tiles[0][m.w-1]     == TILE_WALL);
+    ASSERT("bottom-left corner is wall",  m.tiles[m.h-1][0]     == TILE_WALL);
+    ASSERT("bottom-right corner is wall", m.tiles[m.h-1][m.w-1] == TILE_WALL);
+    ASSERT("outside bounds reads as wall",
+        map_get_tile(&m, MAP_W - 1, MAP_H - 1) == TILE_WALL);
 
     // Walkability
     ASSERT("border tile is not walkable",
@@ -30,4 +34,44 @@ void test_map_tiles(void) {
         map_is_walkable(&m, m.stairs_up_x, m.stairs_up_y) == 1);
     ASSERT("stairs down is walkable",
         map_is_walkable(&m, m.stairs_down_x, m.stairs_down_y) == 1);
-}
\ No newline at end of file
+}
+void test_tile_traits(void) {
+    printf("Tile trait tests:\n");
+
+    int all_drawn = 1;
+    for (int t = 0; t < TILE_COUNT; t++)
+        if (TILE_TRAITS[t].sprite >= SPRITE_COUNT) all_drawn = 0;
+    ASSERT("every tile has a sprite", all_drawn);
+
+    // The open-tile grid area effects and senses spread over reads the
+    // table, so every byte value, wall or not, lands where its row says
+    static Map m;
+    static BitGrid open;
+    memset(&m, 0, sizeof(m));
+    m.w = 130;
+    m.h = 3;
+    for (int v = 0; v < m.w * 2; v++) m.tiles[v / m.w][v % m.w] = (unsigned char)v;
+    for (int x = 0; x < m.w; x++) m.tiles[2][x] = x % 3 ? TILE_FLOOR : TILE_WALL;
+    bitgrid_from_map(&open, &m);
+    int as_traits = 1;
+    for (int y = 0; y < m.h; y++)
+        for (int x = 0; x < m.w; x++)
+            if (bitgrid_get(&open, x, y) != TILE_HAS(m.tiles[y][x], TRAIT_WALKABLE))
+                as_traits = 0;
+    ASSERT("open tiles follow the walkable trait", as_traits && bitgrid_get(&open, 0, 3) == 0);
+    ASSERT("unknown tile bytes act as wall",
+        !TILE_HAS(TILE_COUNT, TRAIT_WALKABLE) &&
+        TILE_TRAITS[255].sprite == SPRITE_WALL);
+
+    ASSERT("hidden traps look like floor",
+        TILE_TRAITS[TILE_TRAP_HIDDEN].sprite == TILE_TRAITS[TILE_FLOOR].sprite &&
+        TILE_HAS(TILE_TRAP_HIDDEN, TRAIT_TRAP));
+    ASSERT("shops are marked as shops",
+        TILE_HAS(TILE_SHOP_BLACKSMITH, TRAIT_SHOP) &&
+        TILE_HAS(TILE_SHOP_ALCHEMIST, TRAIT_SHOP) &&
+        TILE_TRAITS[TILE_SHOP_BLACKSMITH].shop != TILE_TRAITS[TILE_SHOP_ALCHEMIST].shop);
+    ASSERT("stairs outrank floor on the minimap",
+        TILE_TRAITS[TILE_STAIRS_DOWN].minimap_rank > TILE_TRAITS[TILE_FLOOR].minimap_rank &&
+        TILE_TRAITS[TILE_WALL].minimap_rank == 0);
+    ASSERT("walls block sight", TILE_HAS(TILE_WALL, TRAIT_OPAQUE));
+}
@@ -0,0 +1,88 @@
+#include "test_utils.h"
+#include "test_fixtures.h"
+#include "../src/game/occupancy.h"
+#include "../src/game/game.h"
+#include <stdlib.h>
+#include <string.h>
+
+// An open 40x20 floor with the player in the middle and no enemies
+static void open_floor(GameState *g) {
+    fixture_open_floor(g, 40, 20, 20, 10);
+    g->player.hp = 10000;
+}
+
+void test_occupancy(void) {
+    printf("Occupancy tests:\n");
+
+    static Occupancy o;
+    static EnemyPool p;
+    p.count = 3;
+    enemy_spawn(&p, 0, ENEMY_SKELETON, 2, 3);
+    enemy_spawn(&p, 1, ENEMY_SKELETON, 5, 5);
+    enemy_spawn(&p, 2, ENEMY_SKELETON, 7, 1);
+    p.active[1] = 0;
+    occupancy_build(&o, &p);
+    ASSERT("lookup finds the enemy on a tile",
+           occupancy_at(&o, &p, 2, 3) == 0 && occupancy_at(&o, &p, 7, 1) == 2);
+    ASSERT("dead enemies and empty tiles find nothing",
+           occupancy_at(&o, &p, 5, 5) == OCCUPANCY_NONE &&
+           occupancy_at(&o, &p, 0, 0) == OCCUPANCY_NONE &&
+           occupancy_at(&o, &p, -1, MAP_H) == OCCUPANCY_NONE);
+
+    p.x[0] = 3;
+    occupancy_move(&o, &p, 0, 2, 3);
+    ASSERT("a move vacates the old tile",
+           occupancy_at(&o, &p, 2, 3) == OCCUPANCY_NONE &&
+           occupancy_at(&o, &p, 3, 3) == 0);
+    occupancy_remove(&o, &p, 2);
+    ASSERT("a removed enemy is gone", occupancy_at(&o, &p, 7, 1) == OCCUPANCY_NONE);
+    p.x[0] = 9; // moved without telling the grid
+    ASSERT("a stale entry is never a wrong answer",
+           occupancy_at(&o, &p, 3, 3) == OCCUPANCY_NONE);
+
+    // A crowd chasing the player never stacks up
+    static GameState g;
+    game_init(&g);
+    open_floor(&g);
+    for (int i = 0; i < MAX_ENEMIES; i++) fixture_add_enemy(&g, 2 + (i % 3) * 2, 2 + (i / 3) * 3);
+    game_refresh_occupancy(&g);
+    const EnemyPool *e = &g.enemies;
+    int apart = 1;
+    for (int turn = 0; turn < 40; turn++) {
+        action_resolve_enemies(&g);
+        for (int i = 0; i < e->count; i++)
+            for (int j = 0; j < i; j++)
+                if (e->x[i] == e->x[j] && e->y[i] == e->y[j])
+                    apart = 0;
+    }
+    ASSERT("enemies never share a tile", apart);
+    int tracked = 1;
+    for (int i = 0; i < e->count; i++)
+        if (game_enemy_at(&g, e->x[i], e->y[i]) != i) tracked = 0;
+    ASSERT("the grid follows every move", tracked);
+
+    // Hits land through the grid, and the dead leave it
+    open_floor(&g);
+    fixture_add_enemy(&g, 21, 10);
+    game_refresh_occupancy(&g);
+    g.player.attack = 100;
+    action_resolve_player(&g, (Action){ACTION_MOVE, 21, 10});
+    ASSERT("melee kills the enemy on the target tile",
+           !e->active[0] && game_enemy_at(&g, 21, 10) == ENEMY_NONE);
+
+    open_floor(&g);
+    fixture_add_enemy(&g, 24, 10); // blast centre, 4 tiles east
+    fixture_add_enemy(&g, 24, 12); // 2 away
+    fixture_add_enemy(&g, 25, 11); // 2 away
+    fixture_add_enemy(&g, 27, 10); // 3 away, outside the radius
+    game_refresh_occupancy(&g);
+    g.player.known_spells[0]    = spell_make_fireball();
+    g.player.known_spell_count  = 1;
+    g.player.equipped_spell     = 0;
+    g.player.mp = g.player.max_mp = 100;
+    g.player.last_dx = 1;
+    g.player.last_dy = 0;
+    action_resolve_player(&g, (Action){ACTION_CAST_SPELL, 0, 0});
+    ASSERT("fireball hits exactly the enemies in its radius",
+           !e->active[0] && !e->active[1] && !e->active[2] && e->active[3]);
+}
@@ -0,0 +1,155 @@
+#include "test_utils.h"
+#include "../src/game/path.h"
+#include "../src/game/cave.h"
+#include "../src/game/game.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Every step moves one tile onto walkable ground and the last is the goal
+static int path_ok(const Map *m, const Path *p, int sx, int sy, int gx, int gy) {
+    int x = sx, y = sy;
+    for (int i = 0; i < p->len; i++) {
+        int nx = p->cells[i] % MAP_W, ny = p->cells[i] / MAP_W;
+        if (abs(nx - x) + abs(ny - y) != 1 || !map_is_walkable(m, nx, ny)) return 0;
+        x = nx;
+        y = ny;
+    }
+    return x == gx && y == gy;
+}
+
+static void random_floor(const Map *m, Rng *rng, int *x, int *y) {
+    do {
+        *x = rng_below(rng, m->w);
+        *y = rng_below(rng, m->h);
+    } while (!map_is_walkable(m, *x, *y));
+}
+
+void test_path(void) {
+    printf("Pathfinding tests:\n");
+
+    static Map m;
+    static Path p, flat;
+    Rng rng;
+    rng_seed(&rng, 21);
+
+    // Routes on generated levels are walkable and close to the shortest
+    int valid = 1, near_best = 1, graph = 1;
+    for (int run = 0; run < 20; run++) {
+        map_generate_layout(&m, 1, run % 2 ? LAYOUT_BSP : LAYOUT_SCATTER, &rng);
+        if (m.link_count < m.room_count - 1) graph = 0;
+        for (int q = 0; q < 20; q++) {
+            int sx, sy, gx, gy;
+            random_floor(&m, &rng, &sx, &sy);
+            random_floor(&m, &rng, &gx, &gy);
+            int len  = path_find(&m, sx, sy, gx, gy, &p);
+            int best = path_find_flat(&m, sx, sy, gx, gy, &flat);
+            if (len < 0 || !path_ok(&m, &p, sx, sy, gx, gy)) valid = 0;
+            if (best < 0 || !path_ok(&m, &flat, sx, sy, gx, gy)) valid = 0;
+            if (len < best || len > best * 2 + 8) near_best = 0;
+        }
+    }
+    ASSERT("levels keep a corridor graph",     graph);
+    ASSERT("paths reach the goal",             valid);
+    ASSERT("room routes stay near the optimum", near_best);
+
+    // Unreachable and degenerate goals
+    int x = m.stairs_up_x, y = m.stairs_up_y;
+    ASSERT("wall goal has no path",   path_find(&m, x, y, 0, 0, &p) == -1);
+    ASSERT("own tile is zero steps",  path_find(&m, x, y, x, y, &p) == 0);
+    ASSERT("next step toward stairs",
+        path_next_step(&m, x, y, m.stairs_down_x, m.stairs_down_y, &x, &y) &&
+        abs(x - m.stairs_up_x) + abs(y - m.stairs_up_y) == 1);
+
+    // Caves have no rooms and use the flat search
+    cave_generate(&m, 1, &rng);
+    int len = path_find(&m, m.stairs_up_x, m.stairs_up_y,
+                        m.stairs_down_x, m.stairs_down_y, &p);
+    ASSERT("cave path reaches the stairs",
+        len > 0 && path_ok(&m, &p, m.stairs_up_x, m.stairs_up_y,
+                                   m.stairs_down_x, m.stairs_down_y));
+
+    // A lattice of corridors crosses itself more often than the graph
+    // builder keeps track of: it drops the graph rather than keep half
+    memset(&m, 0, sizeof(m));
+    m.w = 100;
+    m.h = 60;
+    for (int y = 0; y < m.h; y++) memset(m.tiles[y], TILE_WALL, m.w);
+    m.rooms[0] = (Room){ 1, 1, 4, 4 };
+    m.rooms[1] = (Room){ 84, 50, 8, 4 };
+    m.room_count = 2;
+    for (int i = 0; i < MAX_CORRIDORS; i++) {
+        int along = i % 2 == 0;
+        int at = 3 + (along ? i / 2 : MAX_CORRIDORS / 2 - 1 - i / 2) * 4;
+        Corridor c = along ? (Corridor){ 2, (short)at, 92, (short)at }
+                           : (Corridor){ (short)(at * 2), 2, (short)(at * 2), 52 };
+        m.corridors[m.corridor_count++] = c;
+        for (int x = c.x1; x <= c.x2; x++)
+            for (int y = c.y1; y <= c.y2; y++) m.tiles[y][x] = TILE_FLOOR;
+    }
+    for (int i = 0; i < m.room_count; i++)
+        for (int y = m.rooms[i].y; y < m.rooms[i].y + m.rooms[i].h; y++)
+            memset(&m.tiles[y][m.rooms[i].x], TILE_FLOOR, m.rooms[i].w);
+    map_build_room_graph(&m);
+    len = path_find(&m, 2, 2, 90, 52, &p);
+    ASSERT("an overfull room graph is dropped, not cut short",
+        m.link_count == 0 && len == path_find_flat(&m, 2, 2, 90, 52, &flat) &&
+        path_ok(&m, &p, 2, 2, 90, 52));
+}
+
+void test_travel(void) {
+    printf("Travel tests:\n");
+
+    static GameState g;
+    game_init(&g);
+    game_enter_dungeon(&g);
+    g.enemies.count = 0;
+
+    int steps = game_travel_to(&g, g.map.stairs_down_x, g.map.stairs_down_y);
+    ASSERT("walk to the stairs is planned", steps > 0);
+    int taken = 0;
+    for (Action a = game_travel_step(&g); a.type != ACTION_NONE;
+         a = game_travel_step(&g)) {
+        action_resolve_player(&g, a);
+        taken++;
+    }
+    ASSERT("walk ends on the stairs down",
+        g.player.x == g.map.stairs_down_x && g.player.y == g.map.stairs_down_y);
+    ASSERT("walk takes the planned steps", taken == steps);
+    ASSERT("walls cannot be walked to", game_travel_to(&g, 0, 0) == -1);
+
+    // A nearby enemy stops the walk
+    game_travel_to(&g, g.map.stairs_up_x, g.map.stairs_up_y);
+    g.enemies.count = 1;
+    g.enemies.active[0] = 1;
+    g.enemies.x[0] = g.player.x + 1;
+    g.enemies.y[0] = g.player.y;
+    ASSERT("walk stops next to an enemy", game_travel_step(&g).type == ACTION_NONE);
+
+    // Enemies find their way around walls instead of pressing into them
+    memset(&g.map, 0, sizeof(g.map));
+    g.map.w = 40;
+    g.map.h = 20;
+    for (int y = 0; y < g.map.h; y++)
+        memset(g.map.tiles[y], TILE_WALL, g.map.w);
+    for (int y = 2; y < 17; y++)
+        for (int x = 2; x < 37; x++)
+            g.map.tiles[y][x] = TILE_FLOOR;
+    for (int y = 2; y < 15; y++)
+        g.map.tiles[y][20] = TILE_WALL; // divider open at the bottom
+    game_refresh_regions(&g);
+    g.player.x = 15;
+    g.player.y = 5;
+    g.player.hp = 10000;
+    g.enemies.x[0] = 25;
+    g.enemies.y[0] = 5;
+    g.enemies.type[0] = ENEMY_SKELETON;
+    g.enemies.awake[0] = 1; // already chasing
+    game_refresh_occupancy(&g);
+    int turns = 0;
+    while (turns < 60 && (abs(g.enemies.x[0] - g.player.x) > 1 ||
+                          abs(g.enemies.y[0] - g.player.y) > 1)) {
+        action_resolve_enemies(&g);
+        turns++;
+    }
+    ASSERT("enemy walks around the wall", turns < 60);
+}
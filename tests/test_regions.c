@@ -0,0 +1,170 @@
+#include "test_utils.h"
+#include "../src/game/regions.h"
+#include "../src/game/cave.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+static void blank_map(Map *m, int w, int h) {
+    m->w = w;
+    m->h = h;
+    m->room_count = 0;
+    for (int y = 0; y < h; y++)
+        memset(m->tiles[y], TILE_WALL, w);
+}
+
+static void open_rect(Map *m, int x, int y, int w, int h) {
+    for (int ry = y; ry < y + h; ry++)
+        for (int rx = x; rx < x + w; rx++)
+            m->tiles[ry][rx] = TILE_FLOOR;
+}
+
+// Reference labeling: flood fill from every unlabeled walkable tile
+static int naive_label(const Map *m, int label[MAP_H][MAP_W]) {
+    static int stack[MAP_W * MAP_H];
+    int count = 0;
+    for (int y = 0; y < m->h; y++)
+        for (int x = 0; x < m->w; x++)
+            label[y][x] = 0;
+    for (int y = 0; y < m->h; y++) {
+        for (int x = 0; x < m->w; x++) {
+            if (label[y][x] || !map_is_walkable(m, x, y)) continue;
+            int top = 0;
+            label[y][x] = ++count;
+            stack[top++] = y * MAP_W + x;
+            while (top > 0) {
+                int cx = stack[--top] % MAP_W, cy = stack[top] / MAP_W;
+                static const int dirs[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+                for (int d = 0; d < 4; d++) {
+                    int nx = cx + dirs[d][0], ny = cy + dirs[d][1];
+                    if (!map_is_walkable(m, nx, ny) || label[ny][nx]) continue;
+                    label[ny][nx] = count;
+                    stack[top++] = ny * MAP_W + nx;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// Same partition: every pair of labels maps one-to-one
+static int same_partition(const Map *m, const Regions *r, int label[MAP_H][MAP_W]) {
+    static int to_region[MAP_W * MAP_H + 1];
+    memset(to_region, 0, sizeof(to_region));
+    for (int y = 0; y < m->h; y++) {
+        for (int x = 0; x < m->w; x++) {
+            int a = label[y][x], b = regions_id(r, x, y);
+            if ((a == 0) != (b == REGION_NONE)) return 0;
+            if (a == 0) continue;
+            if (to_region[a] == 0) to_region[a] = b;
+            else if (to_region[a] != b) return 0;
+        }
+    }
+    return 1;
+}
+
+void test_regions(void) {
+    printf("Region labeling tests:\n");
+
+    static Map m;
+    static Regions r;
+
+    // Two rooms, one U-shaped passage crossing a word boundary, one pocket
+    blank_map(&m, 120, 30);
+    open_rect(&m, 2, 2, 5, 5);
+    open_rect(&m, 20, 2, 5, 5);
+    open_rect(&m, 50, 10, 30, 1);
+    open_rect(&m, 50, 10, 1, 8);
+    open_rect(&m, 79, 10, 1, 8);
+    open_rect(&m, 100, 20, 1, 1);
+
+    ASSERT("separate areas get separate regions", regions_build(&r, &m) == 4);
+    ASSERT("tiles of one room share a region", regions_same(&r, 2, 2, 6, 6));
+    ASSERT("separate rooms differ", !regions_same(&r, 2, 2, 20, 2));
+    ASSERT("both arms of the U join up", regions_same(&r, 50, 17, 79, 17));
+    ASSERT("walls have no region", regions_id(&r, 0, 0) == REGION_NONE);
+    ASSERT("outside the bounds has no region", regions_id(&r, 150, 5) == REGION_NONE);
+    ASSERT("largest region is the U", r.largest == regions_id(&r, 60, 10) &&
+                                      r.largest_size == 30 + 7 + 7);
+
+    // Agrees with a plain flood fill on caves and noisy rooms
+    static int label[MAP_H][MAP_W];
+    Rng rng;
+    rng_seed(&rng, 5);
+    cave_generate(&m, 1, &rng);
+    // Sprinkle walls so the cave splits into many pieces
+    for (int i = 0; i < 4000; i++)
+        m.tiles[1 + rng_below(&rng, MAP_H - 2)][1 + rng_below(&rng, MAP_W - 2)] = TILE_WALL;
+    int expect = naive_label(&m, label);
+    ASSERT("region count matches a flood fill", regions_build(&r, &m) == expect);
+    ASSERT("regions match a flood fill", same_partition(&m, &r, label));
+}
+
+void test_level_connectivity(void) {
+    printf("Level connectivity tests:\n");
+
+    // Two rooms with no corridor: the repair pass has to join them
+    static Map m;
+    blank_map(&m, 60, 30);
+    m.room_count = 2;
+    m.rooms[0] = (Room){ 2, 2, 8, 8 };
+    m.rooms[1] = (Room){ 40, 15, 8, 8 };
+    open_rect(&m, 2, 2, 8, 8);
+    open_rect(&m, 40, 15, 8, 8);
+    m.stairs_up_x = 3;    m.stairs_up_y = 3;
+    m.stairs_down_x = 45; m.stairs_down_y = 20;
+    m.tiles[3][3]   = TILE_STAIRS_UP;
+    m.tiles[20][45] = TILE_STAIRS_DOWN;
+
+    ASSERT("disconnected level gets a corridor", map_connect_regions(&m) == 1);
+    static Regions r;
+    regions_build(&r, &m);
+    ASSERT("stairs joined after repair", regions_same(&r, 3, 3, 45, 20));
+    ASSERT("repair keeps the stairs",
+        m.tiles[3][3] == TILE_STAIRS_UP && m.tiles[20][45] == TILE_STAIRS_DOWN);
+    ASSERT("connected level needs no repair", map_connect_regions(&m) == 0);
+
+    // The last resort joins everything without asking what is cut off
+    blank_map(&m, 60, 30);
+    m.room_count = 3;
+    m.rooms[0] = (Room){ 2, 2, 8, 8 };
+    m.rooms[1] = (Room){ 40, 15, 8, 8 };
+    m.rooms[2] = (Room){ 20, 20, 6, 6 };
+    for (int i = 0; i < 3; i++)
+        open_rect(&m, m.rooms[i].x, m.rooms[i].y, m.rooms[i].w, m.rooms[i].h);
+    m.stairs_up_x = 3;    m.stairs_up_y = 3;
+    m.stairs_down_x = 45; m.stairs_down_y = 20;
+    m.corridor_count = 0;
+    map_chain_rooms(&m);
+    regions_build(&r, &m);
+    ASSERT("chained rooms are one region",
+        r.count == 1 && regions_same(&r, 3, 3, 45, 20) && regions_same(&r, 3, 3, 23, 23));
+    ASSERT("and need no repair", map_connect_regions(&m) == 0 && m.link_count >= 2);
+
+    // Generated levels of both layouts come out connected
+    int ok = 1;
+    Rng rng;
+    rng_seed(&rng, 11);
+    for (int run = 0; run < 10; run++) {
+        map_generate_layout(&m, 1, run % 2 ? LAYOUT_BSP : LAYOUT_SCATTER, &rng);
+        regions_build(&r, &m);
+        if (!regions_same(&r, m.stairs_up_x, m.stairs_up_y,
+                              m.stairs_down_x, m.stairs_down_y)) ok = 0;
+        for (int i = 0; i < m.room_count; i++) {
+            int cx, cy;
+            map_room_center(&m.rooms[i], &cx, &cy);
+            if (!regions_same(&r, m.stairs_up_x, m.stairs_up_y, cx, cy)) ok = 0;
+        }
+    }
+    ASSERT("generated levels reach every room from the stairs", ok);
+
+    // The game keeps regions for the level it is on
+    static GameState g;
+    game_init(&g);
+    game_enter_dungeon(&g);
+    ASSERT("dungeon regions built on entry",
+        regions_same(&g.regions, g.player.x, g.player.y,
+                     g.map.stairs_down_x, g.map.stairs_down_y));
+    game_return_to_town(&g);
+    ASSERT("town regions rebuilt on return",
+        g.regions.w == TOWN_W && regions_id(&g.regions, g.player.x, g.player.y));
+}
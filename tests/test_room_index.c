@@ -0,0 +1,89 @@
+#include "test_utils.h"
+#include "../src/game/room_index.h"
+#include "../src/game/cave.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+// No two enemies share a tile and all of them stand on walkable ground
+static int spread_out(const Map *m, const EnemyPool *p) {
+    static unsigned char seen[MAP_H][MAP_W];
+    memset(seen, 0, sizeof(seen));
+    for (int i = 0; i < p->count; i++) {
+        int x = p->x[i], y = p->y[i];
+        if (!p->active[i] || !map_is_walkable(m, x, y) || seen[y][x]) return 0;
+        seen[y][x] = 1;
+    }
+    return 1;
+}
+
+void test_room_index(void) {
+    printf("Room index tests:\n");
+
+    static Map m;
+    static RoomIndex ri;
+    Rng rng;
+    rng_seed(&rng, 3);
+
+    // Two 5x5 rooms: a 3x3 interior each, one tile taken by the stairs
+    m.w = 30;
+    m.h = 20;
+    for (int y = 0; y < m.h; y++)
+        memset(m.tiles[y], TILE_WALL, m.w);
+    m.room_count = 2;
+    m.rooms[0] = (Room){ 2, 2, 5, 5 };
+    m.rooms[1] = (Room){ 20, 10, 5, 5 };
+    for (int i = 0; i < 2; i++)
+        for (int y = m.rooms[i].y; y < m.rooms[i].y + 5; y++)
+            memset(&m.tiles[y][m.rooms[i].x], TILE_FLOOR, 5);
+    m.tiles[4][4] = TILE_STAIRS_UP;
+    room_index_build(&ri, &m);
+
+    ASSERT("tile maps to its room",     room_index_room_of(&ri, 22, 12) == 1);
+    ASSERT("room edge belongs to room", room_index_room_of(&ri, 2, 2) == 0);
+    ASSERT("wall maps to no room",      room_index_room_of(&ri, 10, 10) == ROOM_NONE);
+    ASSERT("outside map maps to none",  room_index_room_of(&ri, -1, 0) == ROOM_NONE);
+    ASSERT("stairs are not free",       ri.free[0] == 8 && ri.free[1] == 9);
+
+    static unsigned char taken[MAP_H][MAP_W];
+    int x, y, unique = 1, in_room = 1;
+    for (int i = 0; i < 9; i++) {
+        room_index_take(&ri, 1, &rng, &x, &y);
+        if (taken[y][x]) unique = 0;
+        taken[y][x] = 1;
+        if (x < 21 || x > 23 || y < 11 || y > 13) in_room = 0;
+    }
+    ASSERT("takes never repeat a cell",    unique);
+    ASSERT("takes stay in the interior",   in_room);
+    ASSERT("full room refuses a take",     !room_index_take(&ri, 1, &rng, &x, &y));
+    ASSERT("take_any falls back to room 0",
+        room_index_take_any(&ri, 1, &rng, &x, &y) &&
+        room_index_room_of(&ri, x, y) == 0);
+
+    // Caves have no rooms: the whole cave is one pseudo-room
+    cave_generate(&m, 1, &rng);
+    room_index_build(&ri, &m);
+    ASSERT("cave is indexed as one room", ri.room_count == 1 && ri.free[0] > 0);
+
+    // Spawning fills every slot, on any layout
+    static EnemyPool enemies;
+    int ok = 1;
+    for (int level = 1; level <= 12; level++) {
+        map_generate_layout(&m, level,
+            level % 2 ? LAYOUT_BSP : LAYOUT_SCATTER, &rng);
+        enemies_spawn_level(&m, level, &enemies, &rng);
+        int boss   = level == 5 || level == 10;
+        int expect = 10 + level;
+        if (expect > MAX_ENEMIES - boss) expect = MAX_ENEMIES - boss;
+        expect += boss;
+        if (enemies.count != expect || !spread_out(&m, &enemies)) ok = 0;
+    }
+    ASSERT("every level gets 10 + level enemies plus its boss", ok);
+
+    map_generate_layout(&m, 10, LAYOUT_BSP, &rng);
+    enemies_spawn_level(&m, 10, &enemies, &rng);
+    ASSERT("boss joins the level's enemies", ENEMY_KIND(&enemies, enemies.count - 1)->is_boss);
+
+    cave_generate(&m, 3, &rng);
+    enemies_spawn_level(&m, 3, &enemies, &rng);
+    ASSERT("caves get enemies too", enemies.count == 13 && spread_out(&m, &enemies));
+}
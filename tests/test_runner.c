@@ -1,4 +1,5 @@
 #include "test_utils.h"
+#include "../src/game/pregen.h"
 
 int tests_run    = 0;
 int tests_passed = 0;
@@ -8,6 +9,9 @@ void test_map(void);
 void test_map_tiles(void);
 void test_viewport(void);
 void test_dungeon(void);
+void test_map_copy(void);
+void test_pregen(void);
+void test_bsp_layout(void);
 void test_stairs_locked(void);
 void test_town_tiles(void);
 void test_town_map(void);
@@ -16,7 +20,31 @@ void test_leveling(void);
 void test_items(void);
 void test_classes(void);
 void test_level_cache_cleared(void);
+void test_level_catch_up(void);
 void test_return_to_town(void);
+void test_town_from_level_one(void);
+void test_world(void);
+void test_bitgrid(void);
+void test_cave(void);
+void test_regions(void);
+void test_level_connectivity(void);
+void test_room_index(void);
+void test_path(void);
+void test_travel(void);
+void test_thread_pool(void);
+void test_vault(void);
+void test_tile_traits(void);
+void test_level_store(void);
+void test_occupancy(void);
+void test_flow(void);
+void test_enemy(void);
+void test_schedule(void);
+void test_effects(void);
+void test_events(void);
+void test_aoe(void);
+void test_senses(void);
+void test_intent(void);
+void test_snapshot(void);
 
 int main(void) {
     // ASSERT("sanity check true",  1 == 1);
@@ -28,10 +56,18 @@ int main(void) {
     printf("\n");
     test_map_tiles();
     printf("\n");
+    test_tile_traits();
+    printf("\n");
     test_viewport();
     printf("\n");
     test_dungeon();
     printf("\n");
+    test_map_copy();
+    printf("\n");
+    test_pregen();
+    printf("\n");
+    test_bsp_layout();
+    printf("\n");
     test_stairs_locked();
     printf("\n");
     test_town_tiles();
@@ -42,13 +78,60 @@ int main(void) {
     printf("\n");
     test_level_cache_cleared();
     printf("\n");
+    test_level_catch_up();
+    printf("\n");
     test_return_to_town();
     printf("\n");
+    test_town_from_level_one();
+    printf("\n");
     test_leveling();
     printf("\n");
     test_items();
     printf("\n");
     test_classes();
     printf("\n");
+    test_world();
+    printf("\n");
+    test_bitgrid();
+    printf("\n");
+    test_cave();
+    printf("\n");
+    test_regions();
+    printf("\n");
+    test_level_connectivity();
+    printf("\n");
+    test_room_index();
+    printf("\n");
+    test_path();
+    printf("\n");
+    test_travel();
+    printf("\n");
+    test_thread_pool();
+    printf("\n");
+    test_vault();
+    printf("\n");
+    test_level_store();
+    printf("\n");
+    test_occupancy();
+    printf("\n");
+    test_flow();
+    printf("\n");
+    test_enemy();
+    printf("\n");
+    test_schedule();
+    printf("\n");
+    test_effects();
+    printf("\n");
+    test_events();
+    printf("\n");
+    test_aoe();
+    printf("\n");
+    test_senses();
+    printf("\n");
+    test_intent();
+    printf("\n");
+    test_snapshot();
+    printf("\n");
+    pregen_shutdown();
     REPORT();
 }
\ No newline at end of file
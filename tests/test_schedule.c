@@ -0,0 +1,50 @@
+#include "test_utils.h"
+#include "test_fixtures.h"
+#include "../src/game/schedule.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+void test_schedule(void) {
+    printf("Schedule tests:\n");
+
+    static Schedule s;
+    schedule_init(&s);
+    ASSERT("empty schedule has no one due", schedule_pop(&s) == SCHEDULE_NONE);
+
+    // Times chosen to collide and to arrive out of order
+    static const int times[SCHEDULE_MAX] = { 50, 20, 90, 20, 70, 10, 90, 30, 60, 20, 80, 40, 10, 50, 30 };
+    for (int id = 0; id < SCHEDULE_MAX; id++) schedule_add(&s, id, times[id]);
+    schedule_remove(&s, 4);
+    schedule_remove(&s, 12);
+    schedule_add(&s, 7, 5); // rescheduled to go first
+    int ordered = 1, popped = 0, last_time = -1, last_id = -1, time;
+    for (int id; (id = schedule_peek(&s, &time)) != SCHEDULE_NONE; popped++) {
+        if (schedule_pop(&s) != id || id == 4 || id == 12) ordered = 0;
+        if (time < last_time || (time == last_time && id < last_id)) ordered = 0;
+        if (time != (id == 7 ? 5 : times[id])) ordered = 0;
+        last_time = time;
+        last_id   = id;
+    }
+    ASSERT("actors come out by time, then list order", ordered);
+    ASSERT("removed actors never come out", popped == SCHEDULE_MAX - 2);
+
+    // On open floor, next to the player: a skeleton hits every turn, a
+    // zombie every other
+    static GameState g;
+    game_init(&g);
+    fixture_open_floor(&g, 20, 10, 10, 5);
+    g.player.defense = 0;
+    game_wake_enemy(&g, game_spawn_enemy(&g, ENEMY_SKELETON, 9, 5));
+    g.player.max_hp = g.player.hp = 1000;
+    for (int turn = 0; turn < 10; turn++) action_resolve_enemies(&g);
+    int skeleton_hits = (1000 - g.player.hp) / ENEMY_ARCHETYPES[ENEMY_SKELETON].attack;
+
+    game_kill_enemy(&g, 0);
+    game_wake_enemy(&g, game_spawn_enemy(&g, ENEMY_ZOMBIE, 9, 5));
+    g.player.hp = 1000;
+    for (int turn = 0; turn < 10; turn++) action_resolve_enemies(&g);
+    int zombie_hits = (1000 - g.player.hp) / ENEMY_ARCHETYPES[ENEMY_ZOMBIE].attack;
+    ASSERT("a normal enemy acts every turn", skeleton_hits == 10);
+    ASSERT("a slow one every other turn", zombie_hits == 5);
+    ASSERT("the schedule holds only the living", g.schedule.count == 1);
+}
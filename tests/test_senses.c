@@ -0,0 +1,83 @@
+#include "test_utils.h"
+#include "../src/game/senses.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+// A one-tile corridor along row 5, x from 1 to `len`
+static void corridor(GameState *g, int len) {
+    memset(&g->map, 0, sizeof(g->map));
+    g->map.w = len + 2;
+    g->map.h = 11;
+    for (int y = 0; y < g->map.h; y++)
+        memset(g->map.tiles[y], TILE_WALL, g->map.w);
+    memset(&g->map.tiles[5][1], TILE_FLOOR, len);
+    game_refresh_regions(g);
+    g->player.hp = 10000;
+    g->enemies.count = 0;
+    game_refresh_occupancy(g);
+}
+
+void test_senses(void) {
+    printf("Senses tests:\n");
+
+    static GameState g;
+    game_init(&g);
+    corridor(&g, 100);
+    Senses *s = &g.senses;
+
+    g.player.x = 50;
+    g.player.y = 5;
+    for (int turn = 0; turn < 5; turn++)
+        senses_update(s, &g.regions, &g.open, 50, 5);
+    ASSERT("scent is strongest where the player stands",
+           senses_scent(s, 50, 5) == SCENT_FRESH &&
+           senses_scent(s, 51, 5) > senses_scent(s, 53, 5) && senses_scent(s, 53, 5) > 0);
+    ASSERT("walls hold no scent", senses_scent(s, 50, 4) == 0 && senses_scent(s, 50, 6) == 0);
+    for (int turn = 0; turn < 300; turn++)
+        senses_update(s, &g.regions, &g.open, 90, 5);
+    ASSERT("an old trail goes cold", senses_scent(s, 50, 5) == 0);
+
+    senses_noise(s, 20, 5, 6);
+    senses_update(s, &g.regions, &g.open, 90, 5);
+    ASSERT("a new sound is marked fresh", s->fresh);
+    ASSERT("a sound carries as far as it is loud",
+           senses_heard(s, 20, 5) == 6 && senses_heard(s, 25, 5) == 1 &&
+           senses_heard(s, 26, 5) == 0 && senses_heard(s, 20, 4) == 0);
+    for (int turn = 0; turn < 2; turn++)
+        senses_update(s, &g.regions, &g.open, 90, 5);
+    ASSERT("and dies away", !s->fresh && !s->loud && senses_heard(s, 20, 5) == 0);
+
+    // A fireball is heard further off than the player wakes enemies
+    corridor(&g, 60);
+    g.player.x = 10;
+    g.player.y = 5;
+    int near = game_spawn_enemy(&g, ENEMY_SKELETON, 28, 5);
+    int far  = game_spawn_enemy(&g, ENEMY_SKELETON, 40, 5);
+    g.player.known_spells[0]   = spell_make_fireball();
+    g.player.known_spell_count = 1;
+    g.player.equipped_spell    = 0;
+    g.player.mp = g.player.max_mp = 100;
+    g.player.last_dx = 1;
+    g.player.last_dy = 0;
+    action_resolve_player(&g, (Action){ACTION_CAST_SPELL, 0, 0});
+    action_resolve_enemies(&g);
+    ASSERT("noise wakes enemies in earshot only", g.enemies.awake[near] && !g.enemies.awake[far]);
+
+    // Left far behind, an enemy tracks the player down the trail
+    corridor(&g, 120);
+    int e = game_spawn_enemy(&g, ENEMY_SKELETON, 2, 5);
+    g.player.y = 5;
+    for (int x = 3; x <= 80; x++)
+        senses_update(s, &g.regions, &g.open, x, 5);
+    g.player.x = 80;
+    game_wake_enemy(&g, e);
+    for (int turn = 0; turn < 10; turn++) action_resolve_enemies(&g);
+    ASSERT("an enemy off the flow field follows the scent", g.enemies.x[e] == 12);
+
+    corridor(&g, 120);
+    e = game_spawn_enemy(&g, ENEMY_SKELETON, 2, 5);
+    g.player.x = 80;
+    game_wake_enemy(&g, e);
+    for (int turn = 0; turn < 10; turn++) action_resolve_enemies(&g);
+    ASSERT("with no trail it has nothing to go on", g.enemies.x[e] == 2);
+}
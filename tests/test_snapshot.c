@@ -0,0 +1,70 @@
+#include "test_utils.h"
+#include "../src/systems/snapshot.h"
+#include "../src/game/game.h"
+#include <string.h>
+
+#define SNAP_LEVELS  8  // deep enough to page the first levels out
+#define SNAP_HEADER  32 // bytes before the state, see snapshot.h
+#define SNAP_VERSION 4  // offset of the version in the header
+#define SNAP_SIZE    8  // and of sizeof(GameState)
+
+// Flip one bit of the snapshot file at byte `at`
+static void flip(long at) {
+    FILE *f = fopen(SNAPSHOT_PATH, "r+b");
+    if (!f) return;
+    fseek(f, at, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, at, SEEK_SET);
+    fputc(c ^ 1, f);
+    fclose(f);
+}
+
+void test_snapshot(void) {
+    printf("Snapshot tests:\n");
+
+    static GameState g, back;
+    game_init(&g);
+    game_enter_dungeon(&g);
+    for (int level = 1; level < SNAP_LEVELS; level++) game_descend(&g);
+    g.gold = 1234;
+    ASSERT("the oldest levels are paged out",
+           level_store_paged_out(&g.levels, 1) && level_store_paged_out(&g.levels, 2));
+
+    snapshot_discard();
+    int screen = -1;
+    game_init(&back);
+    ASSERT("no snapshot, nothing to load", snapshot_load(&back, &screen) == 0);
+
+    ASSERT("snapshot saves", snapshot_save(&g, 7));
+    ASSERT("snapshot loads", snapshot_load(&back, &screen) == 1);
+    ASSERT("the screen comes back", screen == 7);
+    ASSERT("the game comes back",
+           back.level == g.level && back.gold == 1234 &&
+           back.player.x == g.player.x && back.player.y == g.player.y &&
+           back.enemies.count == g.enemies.count);
+    static LevelCache want;
+    int levels = back.levels.data != g.levels.data;
+    for (int level = 1; level < SNAP_LEVELS; level++) {
+        const LevelCache *c = level_store_get(&g.levels, level);
+        if (!c) { levels = 0; continue; }
+        want = *c;
+        c = level_store_get(&back.levels, level);
+        if (!c || memcmp(c, &want, sizeof(want)) != 0) levels = 0;
+    }
+    ASSERT("paged out levels are adopted into the copy's own file", levels);
+
+    snapshot_save(&g, 7);
+    flip(SNAP_VERSION);
+    ASSERT("another version is refused", snapshot_load(&back, &screen) == -1);
+    snapshot_save(&g, 7);
+    flip(SNAP_SIZE);
+    ASSERT("another state size is refused", snapshot_load(&back, &screen) == -1);
+    snapshot_save(&g, 7);
+    flip(SNAP_HEADER + (long)sizeof(GameState) / 2);
+    ASSERT("a damaged snapshot fails its checksum", snapshot_load(&back, &screen) == -1);
+    ASSERT("a refused snapshot leaves the game alone", back.level == g.level && screen == 7);
+
+    snapshot_discard();
+    game_free(&back);
+    game_free(&g);
+}
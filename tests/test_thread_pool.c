@@ -0,0 +1,42 @@
+#include "test_utils.h"
+#include "../src/game/thread_pool.h"
+#include <string.h>
+
+#define JOBS 1000
+
+static void count_job(void *ctx, int index) {
+    int *hits = ctx;
+    hits[index]++;
+}
+
+static int all_once(const int *hits, int n) {
+    for (int i = 0; i < n; i++)
+        if (hits[i] != 1) return 0;
+    return 1;
+}
+
+void test_thread_pool(void) {
+    printf("Thread pool tests:\n");
+
+    static int hits[JOBS];
+    ThreadPool pool;
+
+    ASSERT("pool spawns the threads it was asked for", pool_init(&pool, 4) == 4);
+    pool_run(&pool, JOBS, count_job, hits);
+    ASSERT("every index runs exactly once", all_once(hits, JOBS));
+
+    memset(hits, 0, sizeof(hits));
+    pool_run(&pool, 7, count_job, hits);
+    ASSERT("pool runs again with a different count",
+           all_once(hits, 7) && hits[7] == 0);
+
+    pool_run(&pool, 0, count_job, hits);
+    ASSERT("empty run returns at once", all_once(hits, 7));
+    pool_free(&pool);
+
+    memset(hits, 0, sizeof(hits));
+    ASSERT("one thread means no workers", pool_init(&pool, 1) == 1);
+    pool_run(&pool, JOBS, count_job, hits);
+    ASSERT("single thread pool runs everything in place", all_once(hits, JOBS));
+    pool_free(&pool);
+}
@@ -47,6 +47,18 @@ void test_town_map(void) {
     // Border is wall
     ASSERT("south border is wall",
         m.tiles[TOWN_H-1][20] == TILE_WALL);
+
+    // Bounds cover exactly the town
+    ASSERT("town bounds match town size", m.w == TOWN_W && m.h == TOWN_H);
+    ASSERT("past town bounds is not walkable",
+        map_is_walkable(&m, TOWN_W, 12) == 0);
+
+    // Each visit gets a fresh copy of the same town
+    Map again;
+    m.tiles[5][5] = TILE_WALL;
+    map_generate_town(&again, &spawn_x, &spawn_y);
+    ASSERT("changes to one copy do not reach the next",
+        again.tiles[5][5] == TILE_TOWN_FLOOR && again.room_count == 0);
 }
 
 void test_town_spawn(void) {
@@ -80,7 +92,7 @@ void test_return_to_town(void) {
     g.player.x = g.map.stairs_up_x;
     g.player.y = g.map.stairs_up_y;
 
-    int enemies_before = g.enemy_count;
+    int enemies_before = g.enemies.count;
     ASSERT("enemies exist before return", enemies_before > 0);
 
     game_return_to_town(&g);
@@ -88,15 +100,39 @@ void test_return_to_town(void) {
     ASSERT("location is town after return",
         g.location == LOCATION_TOWN);
     ASSERT("enemy count is zero after return",
-        g.enemy_count == 0);
+        g.enemies.count == 0);
     ASSERT("player spawn is walkable",
         map_is_walkable(&g.map, g.player.x, g.player.y));
     ASSERT("player not on wall tile",
         g.map.tiles[g.player.y][g.player.x] != TILE_WALL);
     ASSERT("level 3 cached after return",
-        g.level_cache[2].valid == 1);
+        level_store_has(&g.levels, 3));
     ASSERT("level 3 cleared state cached",
-        g.level_cache[2].level_cleared == 1);
+        level_store_get(&g.levels, 3)->level_cleared == 1);
     ASSERT("floor items cleared",
         g.floor_item_count == 0);
-}
\ No newline at end of file
+}
+void test_town_from_level_one(void) {
+    printf("Level 1 to town tests:\n");
+
+    GameState g;
+    game_init(&g);
+    game_enter_dungeon(&g);
+    ASSERT("entering the dungeon starts on level 1", g.level == 1);
+
+    int up_x = g.map.stairs_up_x, up_y = g.map.stairs_up_y;
+    int down_x = g.map.stairs_down_x, down_y = g.map.stairs_down_y;
+    g.player.x = up_x;
+    g.player.y = up_y;
+    action_resolve_player(&g, (Action){ACTION_ASCEND, 0, 0});
+    ASSERT("stairs up from level 1 lead to town", g.location == LOCATION_TOWN);
+    ASSERT("level 1 cached on the way up", level_store_has(&g.levels, 1));
+
+    game_enter_dungeon(&g);
+    ASSERT("dungeon resumes the same level 1",
+        g.level == 1 &&
+        g.map.stairs_up_x == up_x && g.map.stairs_up_y == up_y &&
+        g.map.stairs_down_x == down_x && g.map.stairs_down_y == down_y);
+    ASSERT("player arrives on the stairs up",
+        g.player.x == up_x && g.player.y == up_y);
+}
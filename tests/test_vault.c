@@ -0,0 +1,172 @@
+#include "test_utils.h"
+#include "../src/game/vault.h"
+#include "../src/game/regions.h"
+#include "../src/game/game.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_VAULTS "test_vaults.bin"
+
+typedef struct {
+    int         kind, min_level, max_level;
+    const char *rows; // '#', '.', 'B', one string per row joined by '/'
+} TestPrefab;
+
+static int write_library(const TestPrefab *prefabs, int count) {
+    FILE *f = fopen(TEST_VAULTS, "wb");
+    if (!f) return 0;
+    unsigned char header[VAULT_FILE_HEADER] = { 'C', 'V', 'L', 'T', VAULT_VERSION, 0,
+                                                (unsigned char)count, 0 };
+    fwrite(header, 1, sizeof(header), f);
+    for (int i = 0; i < count; i++) {
+        unsigned char tiles[VAULT_MAX_SIDE * VAULT_MAX_SIDE];
+        int w = 0, h = 0, x = 0, mx = VAULT_NO_MARK, my = VAULT_NO_MARK;
+        for (const char *c = prefabs[i].rows; ; c++) {
+            if (*c == '/' || *c == '\0') {
+                w = x;
+                h++;
+                x = 0;
+                if (*c == '\0') break;
+                continue;
+            }
+            if (*c == 'B') {
+                mx = x;
+                my = h;
+            }
+            tiles[h * VAULT_MAX_SIDE + x++] = *c == '#' ? TILE_WALL : TILE_FLOOR;
+        }
+        unsigned char rec[VAULT_HEADER] = {
+            (unsigned char)prefabs[i].kind, (unsigned char)prefabs[i].min_level,
+            (unsigned char)prefabs[i].max_level, (unsigned char)w, (unsigned char)h,
+            (unsigned char)mx, (unsigned char)my
+        };
+        fwrite(rec, 1, sizeof(rec), f);
+        for (int y = 0; y < h; y++)
+            fwrite(&tiles[y * VAULT_MAX_SIDE], 1, w, f);
+    }
+    return fclose(f) == 0;
+}
+
+// Three rooms in a row; vaults only ever go in the middle one
+static void three_rooms(Map *m, int mid_w, int mid_h) {
+    memset(m, 0, sizeof(*m));
+    m->w = 60;
+    m->h = 30;
+    for (int y = 0; y < m->h; y++)
+        memset(m->tiles[y], TILE_FLOOR, m->w);
+    m->rooms[0] = (Room){ 1,  1, 8, 8 };
+    m->rooms[1] = (Room){ 20, 1, mid_w, mid_h };
+    m->rooms[2] = (Room){ 45, 1, 8, 8 };
+    m->room_count = 3;
+}
+
+static int walls_in(const Map *m, const Room *r) {
+    int n = 0;
+    for (int y = r->y; y < r->y + r->h; y++)
+        for (int x = r->x; x < r->x + r->w; x++)
+            n += m->tiles[y][x] == TILE_WALL;
+    return n;
+}
+
+static int ring_open(const Map *m, const Room *r) {
+    for (int y = r->y; y < r->y + r->h; y++)
+        for (int x = r->x; x < r->x + r->w; x++) {
+            int edge = x == r->x || y == r->y ||
+                       x == r->x + r->w - 1 || y == r->y + r->h - 1;
+            if (edge && m->tiles[y][x] != TILE_FLOOR) return 0;
+        }
+    return 1;
+}
+
+void test_vault(void) {
+    printf("Vault tests:\n");
+
+    static Map m;
+    Rng rng;
+    rng_seed(&rng, 11);
+
+    ASSERT("missing library loads nothing",
+           vault_library_load("no_such_vaults.bin") < 0 && vault_library_count() == 0);
+    three_rooms(&m, 12, 10);
+    ASSERT("no library, no vaults",
+           vault_stamp_level(&m, 5, &rng) == 0 && m.lair_x == -1 && walls_in(&m, &m.rooms[1]) == 0);
+
+    // One wall in a corner: which corner it lands in shows the mirroring
+    TestPrefab corner[] = { { VAULT_GAUNTLET, 1, 25, "#../..." } };
+    write_library(corner, 1);
+    ASSERT("library loads", vault_library_load(TEST_VAULTS) == 1);
+
+    int corners = 0, ok = 1, stamped = 0;
+    for (int i = 0; i < 200; i++) {
+        // 5x4 room: only the 3x2 turns fit inside the floor ring
+        three_rooms(&m, 5, 4);
+        stamped += vault_stamp_level(&m, 3, &rng);
+        const Room *r = &m.rooms[1];
+        if (walls_in(&m, r) > 1 || !ring_open(&m, r) ||
+            walls_in(&m, &m.rooms[0]) || walls_in(&m, &m.rooms[2])) ok = 0;
+        for (int c = 0; c < 4; c++) {
+            int x = r->x + 1 + (c & 1) * 2, y = r->y + 1 + (c >> 1);
+            if (m.tiles[y][x] == TILE_WALL) corners |= 1 << c;
+        }
+    }
+    ASSERT("vaults only go in the middle room, inside its floor ring", ok && stamped > 0);
+    ASSERT("mirrored copies land the wall in every corner", corners == 15);
+
+    three_rooms(&m, 4, 5);
+    int turned = 0;
+    for (int i = 0; i < 200 && !turned; i++) turned = vault_stamp_level(&m, 3, &rng);
+    ASSERT("transposed copy fits a tall room", turned);
+
+    TestPrefab level_ranges[] = {
+        { VAULT_LAIR,     5, 5,  "###/.B./###" },
+        { VAULT_TREASURE, 9, 25, "#.#/.../#.#" },
+    };
+    write_library(level_ranges, 2);
+    vault_library_load(TEST_VAULTS);
+    three_rooms(&m, 12, 10);
+    vault_stamp_level(&m, 4, &rng);
+    ASSERT("level without a lair has none", m.lair_x == -1 && walls_in(&m, &m.rooms[1]) == 0);
+    three_rooms(&m, 12, 10);
+    vault_stamp_level(&m, 5, &rng);
+    ASSERT("lair marks where the boss waits",
+           map_room_at(&m, m.lair_x, m.lair_y) == 1 &&
+           m.tiles[m.lair_y][m.lair_x] == TILE_FLOOR && walls_in(&m, &m.rooms[1]) == 6);
+
+    // Full levels with the lair: still joined up, boss in the lair
+    int joined = 1, in_lair = 0, lairs = 0;
+    for (int seed = 0; seed < 30; seed++) {
+        EnemyPool enemies;
+        Regions r;
+        rng_seed(&rng, seed);
+        map_generate_layout(&m, 5, LAYOUT_BSP, &rng);
+        enemies_spawn_level(&m, 5, &enemies, &rng);
+        regions_build(&r, &m);
+        for (int i = 0; i < m.room_count; i++) {
+            int cx, cy;
+            map_room_center(&m.rooms[i], &cx, &cy);
+            if (!regions_same(&r, m.stairs_up_x, m.stairs_up_y, cx, cy)) joined = 0;
+        }
+        if (!regions_same(&r, m.stairs_up_x, m.stairs_up_y, m.stairs_down_x, m.stairs_down_y))
+            joined = 0;
+        if (m.lair_x < 0) continue;
+        lairs++;
+        int boss = enemies.count - 1, alone = 1;
+        for (int i = 0; i < boss; i++)
+            if (enemies.x[i] == m.lair_x && enemies.y[i] == m.lair_y) alone = 0;
+        in_lair += ENEMY_KIND(&enemies, boss)->is_boss &&
+                   enemies.x[boss] == m.lair_x && enemies.y[boss] == m.lair_y && alone;
+    }
+    ASSERT("levels with vaults stay connected", joined);
+    ASSERT("boss spawns on its lair's mark", lairs > 0 && in_lair == lairs);
+
+    FILE *f = fopen(TEST_VAULTS, "r+b");
+    if (f) {
+        fputc('X', f);
+        fclose(f);
+    }
+    ASSERT("corrupt library is rejected",
+           vault_library_load(TEST_VAULTS) < 0 && vault_library_count() == 0);
+
+    vault_library_free();
+    remove(TEST_VAULTS);
+}
@@ -35,6 +35,16 @@ void test_viewport(void) {
     ASSERT("player tile is visible",        viewport_is_visible(&v, 100, 50) == 1);
     ASSERT("far off-screen tile not visible", viewport_is_visible(&v, 0, 0)  == 0);
 
+    // Maps smaller than the viewport stay pinned top-left
+    Viewport small;
+    viewport_init(&small, 53, 30, 40, 25);
+    viewport_center_on(&small, 20, 23);
+    ASSERT("small map cam_x stays at 0", small.cam_x == 0);
+    ASSERT("small map cam_y stays at 0", small.cam_y == 0);
+    viewport_set_map_size(&small, MAP_W, MAP_H);
+    viewport_center_on(&small, 100, 50);
+    ASSERT("map size update moves camera", small.cam_x == 100 - 53/2);
+
     // Resize
     viewport_on_resize(&v, 80, 45);
     ASSERT("tiles_x updates on resize", v.tiles_x == 80);
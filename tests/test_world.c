@@ -0,0 +1,40 @@
+#include "test_utils.h"
+#include "../src/game/world.h"
+
+static World world;
+
+void test_world(void) {
+    printf("World chunk tests:\n");
+
+    world_init(&world, 1234, WORLD_W, WORLD_H);
+
+    ASSERT("world edge is wall",       world_get_tile(&world, 0, 500) == TILE_WALL);
+    ASSERT("out of bounds is wall",    world_get_tile(&world, -1, WORLD_H) == TILE_WALL);
+    ASSERT("out of bounds not walkable", world_is_walkable(&world, WORLD_W, 0) == 0);
+
+    // Terrain is deterministic across eviction and regeneration
+    TileType before = world_get_tile(&world, 1500, 1500);
+    world_update(&world, 10, 10);
+    ASSERT("far chunk evicted on update",  world.resident_count <= 25);
+    ASSERT("regenerated tile matches",     world_get_tile(&world, 1500, 1500) == before);
+
+    // Edits survive eviction through compressed storage
+    world_set_tile(&world, 1501, 1501, TILE_STAIRS_DOWN);
+    world_update(&world, 10, 10);
+    ASSERT("edited tile survives eviction",
+        world_get_tile(&world, 1501, 1501) == TILE_STAIRS_DOWN);
+
+    // Walking across the whole world keeps residency bounded
+    int max_resident = 0;
+    for (int x = 0; x < WORLD_W; x += 7) {
+        world_update(&world, x, x);
+        if (world.resident_count > max_resident)
+            max_resident = world.resident_count;
+    }
+    ASSERT("resident chunks stay bounded", max_resident <= WORLD_MAX_RESIDENT);
+    ASSERT("untouched chunks are not kept", world.table_used < 64);
+    ASSERT("edit still present after walk",
+        world_get_tile(&world, 1501, 1501) == TILE_STAIRS_DOWN);
+
+    world_free(&world);
+}
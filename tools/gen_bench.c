@@ -0,0 +1,237 @@
+// Generates a batch of dungeon levels over every depth on a thread pool,
+// then reports levels/sec per thread count and what the levels looked
+// like. Each level's seed depends only on its index, so a bad level
+// reported here can be rebuilt alone with map_generate_rng.
+//
+// Usage: gen_bench [levels] [base seed] [max threads]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "game/game.h"
+#include "game/regions.h"
+#include "game/thread_pool.h"
+#include "game/vault.h"
+
+#define DEFAULT_LEVELS 5000
+#define ENEMY_TYPES    (ENEMY_TARRASQUE + 1)
+#define FAILS_LISTED   10
+
+enum {
+    FAIL_FEW_ROOMS   = 1, // fewer than MIN_ROOMS
+    FAIL_STAIRS      = 2, // stairs down unreachable from stairs up
+    FAIL_CUT_OFF     = 4, // some room center unreachable
+    FAIL_FEW_ENEMIES = 8  // fewer enemies than the level asks for
+};
+
+typedef struct {
+    int depth;
+    int rooms, links;
+    int floor, area;
+    int traps;
+    int enemies;
+    int by_type[ENEMY_TYPES];
+    int lair;
+    int fails;
+} LevelStats;
+
+typedef struct {
+    uint64_t    seed;
+    LevelStats *stats;
+} Batch;
+
+static uint64_t level_seed(uint64_t base, int index) {
+    return base + (uint64_t)index * 0x9E3779B97F4A7C15ULL;
+}
+
+static int expected_enemies(int depth) {
+    int boss = depth % 5 == 0;
+    int n = 10 + depth;
+    if (n > MAX_ENEMIES - boss) n = MAX_ENEMIES - boss;
+    return n + boss;
+}
+
+static void generate_one(void *ctx, int index) {
+    Batch *b = ctx;
+    LevelStats *s = &b->stats[index];
+    Map     m;
+    Regions r;
+    EnemyPool enemies;
+    Rng     rng;
+
+    memset(s, 0, sizeof(*s));
+    s->depth = 1 + index % MAX_DEPTH;
+    rng_seed(&rng, level_seed(b->seed, index));
+    map_generate_rng(&m, s->depth, &rng);
+    enemies_spawn_level(&m, s->depth, &enemies, &rng);
+    s->enemies = enemies.count;
+
+    s->rooms = m.room_count;
+    s->links = m.link_count;
+    s->area  = m.w * m.h;
+    s->lair  = m.lair_x >= 0;
+    for (int y = 0; y < m.h; y++) {
+        for (int x = 0; x < m.w; x++) {
+            s->floor += TILE_HAS(m.tiles[y][x], TRAIT_WALKABLE);
+            s->traps += m.tiles[y][x] == TILE_TRAP_HIDDEN;
+        }
+    }
+    for (int i = 0; i < s->enemies; i++)
+        s->by_type[enemies.type[i]]++;
+
+    regions_build(&r, &m);
+    if (m.room_count < MIN_ROOMS) s->fails |= FAIL_FEW_ROOMS;
+    if (!regions_same(&r, m.stairs_up_x, m.stairs_up_y,
+                          m.stairs_down_x, m.stairs_down_y))
+        s->fails |= FAIL_STAIRS;
+    for (int i = 0; i < m.room_count; i++) {
+        int cx, cy;
+        map_room_center(&m.rooms[i], &cx, &cy);
+        if (!regions_same(&r, m.stairs_up_x, m.stairs_up_y, cx, cy))
+            s->fails |= FAIL_CUT_OFF;
+    }
+    if (s->enemies < expected_enemies(s->depth)) s->fails |= FAIL_FEW_ENEMIES;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// FNV-1a over the stats, to show every thread count built the same levels
+static uint64_t checksum(const LevelStats *stats, int n) {
+    const unsigned char *p = (const unsigned char *)stats;
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < sizeof(*stats) * n; i++)
+        h = (h ^ p[i]) * 0x100000001B3ULL;
+    return h;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// min / p10 / median / p90 / max of one field over the batch
+static void print_spread(const char *name, const int *values, int n, int *scratch,
+                         double scale) {
+    memcpy(scratch, values, n * sizeof(int));
+    qsort(scratch, n, sizeof(int), cmp_int);
+    printf("%-16s %8.1f %8.1f %8.1f %8.1f %8.1f\n", name,
+           scratch[0] * scale, scratch[n / 10] * scale, scratch[n / 2] * scale,
+           scratch[n - 1 - n / 10] * scale, scratch[n - 1] * scale);
+}
+
+static void print_report(const LevelStats *stats, int n, uint64_t seed) {
+    int *values  = malloc(n * sizeof(int));
+    int *scratch = malloc(n * sizeof(int));
+    static const char *type_names[ENEMY_TYPES] = {
+        "Skeleton", "Goblin", "Zombie", "Orc", "Troll", "Giant",
+        "Goblin King", "Lich King", "Demon Lord", "Red Dragon", "Tarrasque"
+    };
+
+    printf("\n== Level shape (%d levels) ==\n", n);
+    printf("%-16s %8s %8s %8s %8s %8s\n", "", "min", "p10", "median", "p90", "max");
+    for (int i = 0; i < n; i++) values[i] = stats[i].rooms;
+    print_spread("rooms", values, n, scratch, 1.0);
+    for (int i = 0; i < n; i++) values[i] = stats[i].links;
+    print_spread("graph links", values, n, scratch, 1.0);
+    for (int i = 0; i < n; i++) values[i] = 1000 * stats[i].floor / stats[i].area;
+    print_spread("floor %", values, n, scratch, 0.1);
+    for (int i = 0; i < n; i++) values[i] = stats[i].traps;
+    print_spread("traps", values, n, scratch, 1.0);
+    for (int i = 0; i < n; i++) values[i] = stats[i].enemies;
+    print_spread("enemies", values, n, scratch, 1.0);
+
+    int boss_levels = 0, lairs = 0;
+    for (int i = 0; i < n; i++) {
+        boss_levels += stats[i].depth % 5 == 0;
+        lairs       += stats[i].lair;
+    }
+    printf("%-16s %d of %d boss levels\n", "lairs stamped", lairs, boss_levels);
+
+    printf("\n== Enemies by depth (mean per level) ==\n");
+    printf("%5s", "depth");
+    for (int t = 0; t < ENEMY_TYPES; t++) printf(" %5.5s", type_names[t]);
+    printf("\n");
+    for (int d = 1; d <= MAX_DEPTH; d++) {
+        long sum[ENEMY_TYPES] = { 0 };
+        int levels = 0;
+        for (int i = 0; i < n; i++) {
+            if (stats[i].depth != d) continue;
+            levels++;
+            for (int t = 0; t < ENEMY_TYPES; t++) sum[t] += stats[i].by_type[t];
+        }
+        if (levels == 0) continue;
+        printf("%5d", d);
+        for (int t = 0; t < ENEMY_TYPES; t++) printf(" %5.2f", (double)sum[t] / levels);
+        printf("\n");
+    }
+
+    static const struct { int flag; const char *name; } fail_names[] = {
+        { FAIL_FEW_ROOMS,   "too few rooms" },
+        { FAIL_STAIRS,      "stairs unreachable" },
+        { FAIL_CUT_OFF,     "room cut off" },
+        { FAIL_FEW_ENEMIES, "enemies short" },
+    };
+    printf("\n== Failures ==\n");
+    for (size_t f = 0; f < sizeof(fail_names) / sizeof(fail_names[0]); f++) {
+        int count = 0;
+        for (int i = 0; i < n; i++) count += (stats[i].fails & fail_names[f].flag) != 0;
+        printf("%-20s %6d  (%.2f%%)\n", fail_names[f].name, count, 100.0 * count / n);
+    }
+    int listed = 0;
+    for (int i = 0; i < n && listed < FAILS_LISTED; i++) {
+        if (!stats[i].fails) continue;
+        printf("  level %d: depth %d seed 0x%016llx flags %d\n", i, stats[i].depth,
+               (unsigned long long)level_seed(seed, i), stats[i].fails);
+        listed++;
+    }
+
+    free(values);
+    free(scratch);
+}
+
+int main(int argc, char **argv) {
+    int levels    = argc > 1 ? atoi(argv[1]) : DEFAULT_LEVELS;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 0) : 1;
+    if (levels < 1) levels = 1;
+
+    LevelStats *stats = malloc(levels * sizeof(LevelStats));
+    Batch batch = { seed, stats };
+    int vaults = vault_library_load(VAULT_PATH);
+    int cpus = argc > 3 ? atoi(argv[3]) : pool_cpu_count();
+    if (cpus < 1) cpus = 1;
+
+    printf("=== CONR level generation: %d levels, depths 1-%d, seed %llu ===\n",
+           levels, MAX_DEPTH, (unsigned long long)seed);
+    if (vaults < 0) printf("(no vaults: %s not found)\n", VAULT_PATH);
+    else            printf("%d vault prefabs from %s\n", vaults, VAULT_PATH);
+    printf("%7s %10s %12s %8s %18s\n", "threads", "seconds", "levels/sec", "speedup",
+           "checksum");
+
+    double base_rate = 0;
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > cpus) threads = cpus;
+        ThreadPool pool;
+        int got = pool_init(&pool, threads);
+        double t0 = now_s();
+        pool_run(&pool, levels, generate_one, &batch);
+        double secs = now_s() - t0;
+        pool_free(&pool);
+
+        double rate = levels / secs;
+        if (base_rate == 0) base_rate = rate;
+        printf("%7d %10.3f %12.0f %7.2fx  %016llx\n", got, secs, rate, rate / base_rate,
+               (unsigned long long)checksum(stats, levels));
+        if (threads >= cpus) break;
+    }
+
+    print_report(stats, levels, seed);
+    free(stats);
+    vault_library_free();
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Packs the text vault prefabs (assets/vaults.txt) into the binary
+// library the game maps at startup. See vault.h for both formats.
+//
+// Usage: vault_pack <vaults.txt> <vaults.bin>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game/vault.h"
+
+typedef struct {
+    int     kind, min_level, max_level;
+    int     w, h;
+    int     mark_x, mark_y;
+    uint8_t tiles[VAULT_MAX_SIDE * VAULT_MAX_SIDE];
+} Prefab;
+
+static const char *KIND_NAMES[VAULT_KINDS] = { "lair", "treasure", "gauntlet" };
+
+static int tile_for(char c, TileType *t) {
+    switch (c) {
+        case '#': *t = TILE_WALL;        return 1;
+        case '.': *t = TILE_FLOOR;       return 1;
+        case 'B': *t = TILE_FLOOR;       return 1;
+        case '^': *t = TILE_TRAP_HIDDEN; return 1;
+        case '$': *t = TILE_GOLD;        return 1;
+        default:  return 0;
+    }
+}
+
+static void trim(char *s) {
+    size_t n = strlen(s);
+    while (n > 0 && (s[n - 1] == '\n' || s[n - 1] == '\r' || s[n - 1] == ' '))
+        s[--n] = '\0';
+}
+
+static int fail(const char *path, int line, const char *what) {
+    fprintf(stderr, "%s:%d: %s\n", path, line, what);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <vaults.txt> <vaults.bin>\n", argv[0]);
+        return 1;
+    }
+    FILE *in = fopen(argv[1], "r");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    static Prefab prefabs[VAULT_MAX_PREFABS];
+    int count = 0, line = 0;
+    Prefab *p = NULL; // prefab whose rows are being read
+    char buf[256];
+
+    while (fgets(buf, sizeof(buf), in)) {
+        line++;
+        trim(buf);
+        if (buf[0] == '\0') {
+            p = NULL;
+            continue;
+        }
+        if (!p && buf[0] == '#') continue; // comment between prefabs
+
+        if (!p) {
+            char kind[16];
+            int lo, hi;
+            if (sscanf(buf, "%15s %d %d", kind, &lo, &hi) != 3)
+                return fail(argv[1], line, "expected \"<kind> <min level> <max level>\"");
+            if (count == VAULT_MAX_PREFABS)
+                return fail(argv[1], line, "too many prefabs");
+            p = &prefabs[count++];
+            memset(p, 0, sizeof(*p));
+            p->kind = -1;
+            for (int k = 0; k < VAULT_KINDS; k++)
+                if (strcmp(kind, KIND_NAMES[k]) == 0) p->kind = k;
+            if (p->kind < 0) return fail(argv[1], line, "unknown kind");
+            if (lo < 1 || hi > MAX_DEPTH || lo > hi)
+                return fail(argv[1], line, "bad level range");
+            p->min_level = lo;
+            p->max_level = hi;
+            p->mark_x = p->mark_y = VAULT_NO_MARK;
+            continue;
+        }
+
+        int w = (int)strlen(buf);
+        if (p->h == 0) p->w = w;
+        if (w != p->w)               return fail(argv[1], line, "rows differ in width");
+        if (w > VAULT_MAX_SIDE)      return fail(argv[1], line, "prefab too wide");
+        if (p->h == VAULT_MAX_SIDE)  return fail(argv[1], line, "prefab too tall");
+        for (int x = 0; x < w; x++) {
+            TileType t;
+            if (!tile_for(buf[x], &t)) return fail(argv[1], line, "unknown tile");
+            if (buf[x] == 'B') {
+                if (p->kind != VAULT_LAIR || p->mark_x != VAULT_NO_MARK)
+                    return fail(argv[1], line, "only one B, and only in a lair");
+                p->mark_x = x;
+                p->mark_y = p->h;
+            }
+            p->tiles[p->h * w + x] = (uint8_t)t;
+        }
+        p->h++;
+    }
+    fclose(in);
+
+    for (int i = 0; i < count; i++) {
+        if (prefabs[i].h == 0)
+            return fail(argv[1], line, "prefab without rows");
+        if (prefabs[i].kind == VAULT_LAIR && prefabs[i].mark_x == VAULT_NO_MARK)
+            return fail(argv[1], line, "lair without a B");
+    }
+
+    FILE *out = fopen(argv[2], "wb");
+    if (!out) {
+        perror(argv[2]);
+        return 1;
+    }
+    uint8_t header[VAULT_FILE_HEADER];
+    memcpy(header, VAULT_MAGIC, 4);
+    header[4] = VAULT_VERSION & 0xFF;
+    header[5] = VAULT_VERSION >> 8;
+    header[6] = count & 0xFF;
+    header[7] = count >> 8;
+    fwrite(header, 1, sizeof(header), out);
+    for (int i = 0; i < count; i++) {
+        const Prefab *q = &prefabs[i];
+        uint8_t h[VAULT_HEADER] = {
+            (uint8_t)q->kind, (uint8_t)q->min_level, (uint8_t)q->max_level,
+            (uint8_t)q->w, (uint8_t)q->h, (uint8_t)q->mark_x, (uint8_t)q->mark_y
+        };
+        fwrite(h, 1, sizeof(h), out);
+        fwrite(q->tiles, 1, q->w * q->h, out);
+    }
+    if (fclose(out) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+    printf("%d prefabs -> %s\n", count, argv[2]);
+    return 0;
+}